@@ -25,6 +25,8 @@
 #include "Components/InteractionComponent.h"
 #include "Components/InventoryComponent.h"
 #include "TimeLoop/TimeLoopGameMode.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Systems/RuleSystem/RuleSystem.h"
 
 ATimeLoopPlayerCharacter::ATimeLoopPlayerCharacter()
 {
@@ -74,6 +76,35 @@ void ATimeLoopPlayerCharacter::BeginPlay()
     
     // Initialize energy to max at start
     EnergyLevel = 100.0f;
+    
+    // Picking items up can complete quest objectives
+    if (InventoryComponent)
+    {
+        InventoryComponent->OnItemAcquired.AddDynamic(this, &ATimeLoopPlayerCharacter::OnInventoryItemAcquired);
+        InventoryComponent->OnInventoryChanged.AddDynamic(this, &ATimeLoopPlayerCharacter::OnInventoryChanged);
+        
+        // Rules see the starting inventory before its first change
+        OnInventoryChanged();
+    }
+}
+
+void ATimeLoopPlayerCharacter::OnInventoryItemAcquired(FName ItemID, int32 Count)
+{
+    // Looked up per event since the game mode may finish initializing after we begin play
+    ATimeLoopGameMode* GameMode = Cast<ATimeLoopGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    if (GameMode && GameMode->GetQuestManager())
+    {
+        GameMode->GetQuestManager()->NotifyItemAcquired(ItemID, Count);
+    }
+}
+
+void ATimeLoopPlayerCharacter::OnInventoryChanged()
+{
+    ATimeLoopGameMode* GameMode = Cast<ATimeLoopGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    if (GameMode && GameMode->GetRuleSystem())
+    {
+        GameMode->GetRuleSystem()->SyncInventory(InventoryComponent);
+    }
 }
 
 void ATimeLoopPlayerCharacter::Tick(float DeltaTime)
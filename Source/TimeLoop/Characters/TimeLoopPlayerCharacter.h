@@ -92,6 +92,14 @@ protected:
     // Update interaction detection
     void UpdateInteractionDetection();
 
+    // Forward acquired items to the quest objective triggers
+    UFUNCTION()
+    void OnInventoryItemAcquired(FName ItemID, int32 Count);
+
+    // Forward item counts to the rule system
+    UFUNCTION()
+    void OnInventoryChanged();
+
 protected:
     // Camera boom positions the camera behind the character
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera")
@@ -14,6 +14,8 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "InventoryComponent.h"
+#include "Systems/TimeSystem/TimeLoopSaveGame.h"
+#include "Algo/BinarySearch.h"
 
 // Sets default values for this component's properties
 UInventoryComponent::UInventoryComponent()
@@ -23,6 +25,8 @@ UInventoryComponent::UInventoryComponent()
 
 	// Default inventory size
 	MaxItems = 20;
+	
+	TransactionDepth = 0;
 }
 
 
@@ -30,6 +34,12 @@ UInventoryComponent::UInventoryComponent()
 void UInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
+	
+	FItemDefinitionRegistry::Get().LoadDefaultContent();
+	EnsureSlots();
+	
+	// Whatever the player starts with is what every loop starts with
+	CaptureLoopStartSnapshot();
 }
 
 
@@ -39,27 +49,47 @@ void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FA
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 }
 
-bool UInventoryComponent::AddItem(const FInventoryItem& Item)
+bool UInventoryComponent::AddItem(FName ItemID, int32 Count)
 {
-	if (Item.ItemID == NAME_None)
+	if (ItemID == NAME_None || Count <= 0)
 	{
 		return false;
 	}
 	
+	const int32 DefinitionIndex = FItemDefinitionRegistry::Get().Find(ItemID);
+	const FItemDefinition* Definition = FItemDefinitionRegistry::Get().GetDefinition(DefinitionIndex);
+	if (!Definition)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Inventory: No definition for item %s"), *ItemID.ToString());
+		return false;
+	}
+	
+	if (Slots.Num() < MaxItems)
+	{
+		EnsureSlots();
+	}
+	
+	FInventoryTransaction Transaction(this);
+	
 	// Check if we already have this item
-	if (Items.Contains(Item.ItemID))
+	const int32 SlotIndex = ItemSlots.Find(ItemID);
+	if (SlotIndex != INDEX_NONE)
 	{
-		FInventoryItem& ExistingItem = Items[Item.ItemID];
+		FInventoryItem& ExistingItem = Slots[SlotIndex];
 		
 		// If stackable, try to add to the stack
-		if (ExistingItem.bIsStackable)
+		if (Definition->bIsStackable)
 		{
-			int32 NewStackCount = FMath::Min(ExistingItem.StackCount + Item.StackCount, ExistingItem.MaxStackCount);
+			int32 NewStackCount = FMath::Min(ExistingItem.StackCount + Count, Definition->MaxStackCount);
 			int32 Added = NewStackCount - ExistingItem.StackCount;
 			
+			TouchSlot(SlotIndex);
 			ExistingItem.StackCount = NewStackCount;
 			
-			NotifyInventoryChanged();
+			if (Added > 0)
+			{
+				OnItemAcquired.Broadcast(ItemID, Added);
+			}
 			return Added > 0;
 		}
 		else
@@ -71,35 +101,46 @@ bool UInventoryComponent::AddItem(const FInventoryItem& Item)
 	else
 	{
 		// Check if we have space
-		if (Items.Num() >= MaxItems)
+		if (FreeSlots.Num() == 0)
 		{
 			return false;
 		}
 		
-		// Add the new item
-		Items.Add(Item.ItemID, Item);
+		// Add the new item to the next free slot
+		const int32 NewSlotIndex = FreeSlots.Pop(false);
+		TouchSlot(NewSlotIndex);
+		FInventoryItem& NewItem = Slots[NewSlotIndex];
+		NewItem.DefinitionIndex = DefinitionIndex;
+		NewItem.StackCount = Definition->bIsStackable ? FMath::Clamp(Count, 1, Definition->MaxStackCount) : 1;
+		NewItem.Flags = static_cast<uint8>(EInventoryItemFlags::New);
+		ItemSlots.Add(ItemID, NewSlotIndex);
 		
-		NotifyInventoryChanged();
+		OnItemAcquired.Broadcast(ItemID, NewItem.StackCount);
 		return true;
 	}
 }
 
 bool UInventoryComponent::RemoveItem(FName ItemID, int32 Count)
 {
-	if (ItemID == NAME_None || Count <= 0 || !Items.Contains(ItemID))
+	const int32 SlotIndex = FindSlot(ItemID);
+	if (Count <= 0 || SlotIndex == INDEX_NONE)
 	{
 		return false;
 	}
 	
-	FInventoryItem& ExistingItem = Items[ItemID];
+	FInventoryTransaction Transaction(this);
+	TouchSlot(SlotIndex);
+	
+	FInventoryItem& ExistingItem = Slots[SlotIndex];
+	const FItemDefinition* Definition = ExistingItem.GetDefinition();
 	
-	if (ExistingItem.bIsStackable)
+	if (Definition && Definition->bIsStackable)
 	{
 		// Reduce the stack
 		if (ExistingItem.StackCount <= Count)
 		{
 			// Remove the entire stack
-			Items.Remove(ItemID);
+			ReleaseSlot(SlotIndex);
 		}
 		else
 		{
@@ -110,25 +151,26 @@ bool UInventoryComponent::RemoveItem(FName ItemID, int32 Count)
 	else
 	{
 		// Not stackable, remove the item
-		Items.Remove(ItemID);
+		ReleaseSlot(SlotIndex);
 	}
 	
-	NotifyInventoryChanged();
 	return true;
 }
 
 bool UInventoryComponent::HasItem(FName ItemID, int32 Count) const
 {
-	if (ItemID == NAME_None || Count <= 0)
+	if (Count <= 0)
 	{
 		return false;
 	}
 	
-	if (Items.Contains(ItemID))
+	const int32 SlotIndex = FindSlot(ItemID);
+	if (SlotIndex != INDEX_NONE)
 	{
-		const FInventoryItem& Item = Items[ItemID];
+		const FInventoryItem& Item = Slots[SlotIndex];
+		const FItemDefinition* Definition = Item.GetDefinition();
 		
-		if (Item.bIsStackable)
+		if (Definition && Definition->bIsStackable)
 		{
 			return Item.StackCount >= Count;
 		}
@@ -143,9 +185,10 @@ bool UInventoryComponent::HasItem(FName ItemID, int32 Count) const
 
 FInventoryItem UInventoryComponent::GetItem(FName ItemID) const
 {
-	if (Items.Contains(ItemID))
+	const int32 SlotIndex = FindSlot(ItemID);
+	if (SlotIndex != INDEX_NONE)
 	{
-		return Items[ItemID];
+		return Slots[SlotIndex];
 	}
 	
 	return FInventoryItem();
@@ -154,10 +197,15 @@ FInventoryItem UInventoryComponent::GetItem(FName ItemID) const
 TArray<FInventoryItem> UInventoryComponent::GetAllItems() const
 {
 	TArray<FInventoryItem> AllItems;
+	AllItems.Reserve(Slots.Num() - FreeSlots.Num());
 	
-	for (const auto& Pair : Items)
+	// In slot order, so the list stays stable as items come and go
+	for (const FInventoryItem& Item : Slots)
 	{
-		AllItems.Add(Pair.Value);
+		if (!Item.IsEmpty())
+		{
+			AllItems.Add(Item);
+		}
 	}
 	
 	return AllItems;
@@ -165,29 +213,388 @@ TArray<FInventoryItem> UInventoryComponent::GetAllItems() const
 
 void UInventoryComponent::ClearInventory()
 {
-	Items.Empty();
+	FInventoryTransaction Transaction(this);
 	
-	NotifyInventoryChanged();
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		if (!Slots[SlotIndex].IsEmpty())
+		{
+			TouchSlot(SlotIndex);
+			Slots[SlotIndex] = FInventoryItem();
+		}
+	}
+	EnsureSlots();
 }
 
-int32 UInventoryComponent::FindItemIndex(FName ItemID) const
+int32 UInventoryComponent::FindSlot(FName ItemID) const
 {
-	int32 Index = 0;
+	if (ItemID == NAME_None)
+	{
+		return INDEX_NONE;
+	}
 	
-	for (const auto& Pair : Items)
+	return ItemSlots.Find(ItemID);
+}
+
+FInventoryItem UInventoryComponent::GetItemInSlot(int32 SlotIndex) const
+{
+	if (Slots.IsValidIndex(SlotIndex))
 	{
-		if (Pair.Key == ItemID)
+		return Slots[SlotIndex];
+	}
+	
+	return FInventoryItem();
+}
+
+void UInventoryComponent::MarkItemSeen(FName ItemID)
+{
+	const int32 SlotIndex = FindSlot(ItemID);
+	if (SlotIndex != INDEX_NONE && Slots[SlotIndex].HasFlag(EInventoryItemFlags::New))
+	{
+		FInventoryTransaction Transaction(this);
+		TouchSlot(SlotIndex);
+		Slots[SlotIndex].Flags &= ~static_cast<uint8>(EInventoryItemFlags::New);
+	}
+}
+
+FItemDefinition UInventoryComponent::GetItemDefinition(const FInventoryItem& Item)
+{
+	const FItemDefinition* Definition = Item.GetDefinition();
+	return Definition ? *Definition : FItemDefinition();
+}
+
+void UInventoryComponent::CaptureLoopStartSnapshot()
+{
+	LoopStartSlots = Slots;
+}
+
+void UInventoryComponent::RestoreLoopStartSnapshot()
+{
+	FInventoryTransaction Transaction(this);
+	
+	// Persistent items held now survive the reset, ideally in the slot they are in
+	TArray<TPair<int32, FInventoryItem>> CarriedItems;
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		const FItemDefinition* Definition = Slots[SlotIndex].GetDefinition();
+		if (Definition && Definition->bPersistsAcrossLoops)
 		{
-			return Index;
+			CarriedItems.Emplace(SlotIndex, Slots[SlotIndex]);
+		}
+	}
+	
+	// One copy of the whole array; the index and free list are rebuilt from it
+	TouchAllSlots();
+	Slots = LoopStartSlots;
+	EnsureSlots();
+	
+	for (const TPair<int32, FInventoryItem>& Carried : CarriedItems)
+	{
+		const FName ItemID = Carried.Value.GetItemID();
+		const int32 SlotIndex = ItemSlots.Find(ItemID);
+		if (SlotIndex != INDEX_NONE)
+		{
+			// Also held at loop start; the count reached this loop wins
+			Slots[SlotIndex] = Carried.Value;
+		}
+		else if (!PlaceItem(Carried.Value, ItemID, Carried.Key))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Inventory: No room to keep persistent item %s"), *ItemID.ToString());
+		}
+	}
+}
+
+void UInventoryComponent::SavePersistentItems(UTimeLoopSaveGame* SaveGame) const
+{
+	if (!SaveGame)
+	{
+		return;
+	}
+	
+	SaveGame->PersistentItems.Reset();
+	for (const FInventoryItem& Item : Slots)
+	{
+		const FItemDefinition* Definition = Item.GetDefinition();
+		if (Definition && Definition->bPersistsAcrossLoops)
+		{
+			SaveGame->PersistentItems.Add(Definition->ItemID);
+		}
+	}
+}
+
+void UInventoryComponent::LoadPersistentItems(const UTimeLoopSaveGame* SaveGame)
+{
+	if (!SaveGame)
+	{
+		return;
+	}
+	
+	if (Slots.Num() < MaxItems)
+	{
+		EnsureSlots();
+	}
+	
+	// Restored rather than acquired, so no OnItemAcquired and no New flag
+	FInventoryTransaction Transaction(this);
+	for (const FName ItemID : SaveGame->PersistentItems)
+	{
+		const int32 DefinitionIndex = FItemDefinitionRegistry::Get().Find(ItemID);
+		if (DefinitionIndex == INDEX_NONE || ItemSlots.Find(ItemID) != INDEX_NONE)
+		{
+			continue;
 		}
 		
-		Index++;
+		FInventoryItem Item;
+		Item.DefinitionIndex = DefinitionIndex;
+		Item.StackCount = 1;
+		if (!PlaceItem(Item, ItemID, INDEX_NONE))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Inventory: No room to restore persistent item %s"), *ItemID.ToString());
+		}
+	}
+}
+
+void UInventoryComponent::SetMaxItems(int32 NewMaxItems)
+{
+	if (NewMaxItems <= MaxItems && Slots.Num() >= MaxItems)
+	{
+		return;
+	}
+	
+	MaxItems = FMath::Max(MaxItems, NewMaxItems);
+	EnsureSlots();
+}
+
+void UInventoryComponent::EnsureSlots()
+{
+	if (Slots.Num() < MaxItems)
+	{
+		Slots.SetNum(MaxItems);
 	}
+	SlotTouched.SetNum(Slots.Num(), false);
 	
-	return INDEX_NONE;
+	ItemSlots.Reset(Slots.Num());
+	FreeSlots.Reset();
+	
+	// Highest slot first, so the lowest free slot is popped next
+	for (int32 SlotIndex = Slots.Num() - 1; SlotIndex >= 0; --SlotIndex)
+	{
+		FInventoryItem& Item = Slots[SlotIndex];
+		const FName ItemID = Item.GetItemID();
+		if (ItemID == NAME_None || ItemSlots.Find(ItemID) != INDEX_NONE)
+		{
+			// Slots whose definition is gone, or that repeat an item, are emptied
+			if (!Item.IsEmpty())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Inventory: Dropping slot %d, its item is unknown or held in another slot"), SlotIndex);
+			}
+			Item = FInventoryItem();
+			FreeSlots.Add(SlotIndex);
+		}
+		else
+		{
+			ItemSlots.Add(ItemID, SlotIndex);
+		}
+	}
 }
 
-void UInventoryComponent::NotifyInventoryChanged()
+void UInventoryComponent::TouchAllSlots()
 {
+	check(TransactionDepth > 0);
+	
+	if (TouchedSlots.Num() > 0)
+	{
+		for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+		{
+			TouchSlot(SlotIndex);
+		}
+		return;
+	}
+	
+	TouchedOriginals = Slots;
+	TouchedSlots.SetNumUninitialized(Slots.Num());
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		TouchedSlots[SlotIndex] = SlotIndex;
+	}
+	SlotTouched.SetRange(0, Slots.Num(), true);
+}
+
+bool UInventoryComponent::PlaceItem(const FInventoryItem& Item, FName ItemID, int32 PreferredSlot)
+{
+	int32 SlotIndex = PreferredSlot;
+	if (Slots.IsValidIndex(SlotIndex) && Slots[SlotIndex].IsEmpty())
+	{
+		FreeSlots.RemoveSingle(SlotIndex);
+	}
+	else if (FreeSlots.Num() > 0)
+	{
+		SlotIndex = FreeSlots.Pop(false);
+	}
+	else
+	{
+		return false;
+	}
+	
+	TouchSlot(SlotIndex);
+	Slots[SlotIndex] = Item;
+	ItemSlots.Add(ItemID, SlotIndex);
+	return true;
+}
+
+void UInventoryComponent::ReleaseSlot(int32 SlotIndex)
+{
+	ItemSlots.Remove(Slots[SlotIndex].GetItemID());
+	Slots[SlotIndex] = FInventoryItem();
+	
+	// Kept in descending order so Pop always fills the lowest free slot
+	FreeSlots.Insert(SlotIndex, Algo::LowerBound(FreeSlots, SlotIndex, TGreater<>()));
+}
+
+void UInventoryComponent::BeginTransaction()
+{
+	++TransactionDepth;
+}
+
+void UInventoryComponent::CommitTransaction()
+{
+	if (TransactionDepth == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Inventory: CommitTransaction called with no open transaction"));
+		return;
+	}
+	
+	if (--TransactionDepth > 0)
+	{
+		return;
+	}
+	
+	// Compare each touched slot with how it started; a slot changed and changed back reports nothing
+	FInventoryChangeSet ChangeSet;
+	for (int32 TouchIndex = 0; TouchIndex < TouchedSlots.Num(); ++TouchIndex)
+	{
+		const int32 SlotIndex = TouchedSlots[TouchIndex];
+		const FInventoryItem& Before = TouchedOriginals[TouchIndex];
+		const FInventoryItem& After = Slots[SlotIndex];
+		SlotTouched[SlotIndex] = false;
+		
+		if (Before.IsEmpty() && !After.IsEmpty())
+		{
+			ChangeSet.AddedSlots.Add(SlotIndex);
+		}
+		else if (!Before.IsEmpty() && After.IsEmpty())
+		{
+			ChangeSet.RemovedSlots.Add(SlotIndex);
+		}
+		else if (Before.DefinitionIndex != After.DefinitionIndex || Before.StackCount != After.StackCount || Before.Flags != After.Flags)
+		{
+			ChangeSet.ChangedSlots.Add(SlotIndex);
+		}
+	}
+	TouchedSlots.Reset();
+	TouchedOriginals.Reset();
+	
+	if (ChangeSet.IsEmpty())
+	{
+		return;
+	}
+	
+	ChangeSet.AddedSlots.Sort();
+	ChangeSet.RemovedSlots.Sort();
+	ChangeSet.ChangedSlots.Sort();
+	
+	OnInventoryChangeSet.Broadcast(ChangeSet);
 	OnInventoryChanged.Broadcast();
 }
+
+void UInventoryComponent::TouchSlot(int32 SlotIndex)
+{
+	check(TransactionDepth > 0);
+	
+	if (SlotTouched[SlotIndex])
+	{
+		return;
+	}
+	
+	SlotTouched[SlotIndex] = true;
+	TouchedSlots.Add(SlotIndex);
+	TouchedOriginals.Add(Slots[SlotIndex]);
+}
+
+void FInventorySlotIndex::Reset(int32 MaxEntries)
+{
+	// Keep the load at or under one half so probes stay short
+	const int32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(MaxEntries * 2, 16));
+	Entries.Reset();
+	Entries.SetNum(Capacity);
+	Mask = static_cast<uint32>(Capacity - 1);
+}
+
+int32 FInventorySlotIndex::Find(FName ItemID) const
+{
+	if (Entries.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+	
+	for (uint32 Bucket = GetHomeBucket(ItemID); ; Bucket = (Bucket + 1) & Mask)
+	{
+		const FEntry& Entry = Entries[Bucket];
+		if (Entry.Slot == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+		if (Entry.ItemID == ItemID)
+		{
+			return Entry.Slot;
+		}
+	}
+}
+
+void FInventorySlotIndex::Add(FName ItemID, int32 Slot)
+{
+	uint32 Bucket = GetHomeBucket(ItemID);
+	while (Entries[Bucket].Slot != INDEX_NONE)
+	{
+		Bucket = (Bucket + 1) & Mask;
+	}
+	
+	Entries[Bucket].ItemID = ItemID;
+	Entries[Bucket].Slot = Slot;
+}
+
+void FInventorySlotIndex::Remove(FName ItemID)
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+	
+	uint32 Hole = GetHomeBucket(ItemID);
+	for (; Entries[Hole].Slot != INDEX_NONE; Hole = (Hole + 1) & Mask)
+	{
+		if (Entries[Hole].ItemID == ItemID)
+		{
+			break;
+		}
+	}
+	if (Entries[Hole].Slot == INDEX_NONE)
+	{
+		return;
+	}
+	
+	// Pull back any later entry of the same run that the hole would otherwise cut off from its home bucket
+	for (uint32 Next = (Hole + 1) & Mask; Entries[Next].Slot != INDEX_NONE; Next = (Next + 1) & Mask)
+	{
+		const uint32 Home = GetHomeBucket(Entries[Next].ItemID);
+		const uint32 DistanceToNext = (Next - Home) & Mask;
+		const uint32 DistanceToHole = (Hole - Home) & Mask;
+		if (DistanceToHole < DistanceToNext)
+		{
+			Entries[Hole] = Entries[Next];
+			Hole = Next;
+		}
+	}
+	
+	Entries[Hole] = FEntry();
+}
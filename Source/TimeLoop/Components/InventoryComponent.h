@@ -17,61 +17,141 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Systems/ItemSystem/ItemDefinitionRegistry.h"
 #include "InventoryComponent.generated.h"
 
-// Forward declarations
-class UTexture2D;
+class UTimeLoopSaveGame;
+
+/**
+ * Per-instance item state flags
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EInventoryItemFlags : uint8
+{
+	None = 0 UMETA(Hidden),
+	New = 1 << 0 UMETA(DisplayName = "New")
+};
+ENUM_CLASS_FLAGS(EInventoryItemFlags)
 
 /**
  * Inventory item structure
+ * Only what differs between instances; name, icon and stacking rules come from the item's shared definition.
  */
 USTRUCT(BlueprintType)
 struct FInventoryItem
 {
 	GENERATED_BODY()
 	
-	// Unique identifier for this item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	FName ItemID;
-	
-	// Display name for the item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	FText DisplayName;
-	
-	// Description of the item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	FText Description;
-	
-	// Icon to display for this item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	UTexture2D* Icon;
-	
-	// Whether this item can be stacked
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	bool bIsStackable;
+	// Index of this item's definition in the item definition registry, INDEX_NONE for an empty slot
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
+	int32 DefinitionIndex;
 	
 	// Current stack count for this item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
 	int32 StackCount;
 	
-	// Maximum stack count for this item
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	int32 MaxStackCount;
+	// EInventoryItemFlags for this instance
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (Bitmask, BitmaskEnum = "/Script/TimeLoop.EInventoryItemFlags"))
+	uint8 Flags;
 	
 	// Constructor
 	FInventoryItem()
-		: ItemID(NAME_None)
-		, DisplayName(FText::GetEmpty())
-		, Description(FText::GetEmpty())
-		, Icon(nullptr)
-		, bIsStackable(false)
-		, StackCount(1)
-		, MaxStackCount(1)
+		: DefinitionIndex(INDEX_NONE)
+		, StackCount(0)
+		, Flags(0)
 	{}
+	
+	// Get the shared definition of this item, or null for an empty slot
+	const FItemDefinition* GetDefinition() const
+	{
+		return FItemDefinitionRegistry::Get().GetDefinition(DefinitionIndex);
+	}
+	
+	// Get the ID of this item, or NAME_None for an empty slot
+	FName GetItemID() const
+	{
+		const FItemDefinition* Definition = GetDefinition();
+		return Definition ? Definition->ItemID : NAME_None;
+	}
+	
+	// Check whether a slot holds nothing
+	bool IsEmpty() const { return DefinitionIndex == INDEX_NONE; }
+	
+	// Check an instance flag
+	bool HasFlag(EInventoryItemFlags Flag) const { return (Flags & static_cast<uint8>(Flag)) != 0; }
+};
+
+/**
+ * Slots touched by one inventory transaction
+ * Every slot appears at most once, in ascending order.
+ */
+USTRUCT(BlueprintType)
+struct FInventoryChangeSet
+{
+	GENERATED_BODY()
+	
+	// Slots that were empty and now hold an item
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	TArray<int32> AddedSlots;
+	
+	// Slots that held an item and are now empty
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	TArray<int32> RemovedSlots;
+	
+	// Slots still filled whose item, count or flags changed
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	TArray<int32> ChangedSlots;
+	
+	// Check whether the transaction changed nothing
+	bool IsEmpty() const { return AddedSlots.Num() == 0 && RemovedSlots.Num() == 0 && ChangedSlots.Num() == 0; }
+};
+
+/**
+ * FInventorySlotIndex - Open-addressing map from item ID to inventory slot
+ * Linear probing kept under half load; removal shifts later entries back rather than leaving tombstones.
+ */
+struct TIMELOOP_API FInventorySlotIndex
+{
+	// Drop every entry and size the table for at least MaxEntries
+	void Reset(int32 MaxEntries);
+	
+	// Slot holding an item, or INDEX_NONE
+	int32 Find(FName ItemID) const;
+	
+	// Map an item to a slot; the item must not already be present
+	void Add(FName ItemID, int32 Slot);
+	
+	// Forget an item
+	void Remove(FName ItemID);
+	
+private:
+	struct FEntry
+	{
+		FName ItemID;
+		int32 Slot = INDEX_NONE;
+	};
+	
+	uint32 GetHomeBucket(FName ItemID) const
+	{
+		uint32 Hash = GetTypeHash(ItemID);
+		Hash = (Hash ^ (Hash >> 16)) * 0x45D9F3Bu;
+		return (Hash ^ (Hash >> 16)) & Mask;
+	}
+	
+	TArray<FEntry> Entries;
+	uint32 Mask = 0;
 };
 
 /**
  * InventoryComponent - Manages the player's inventory items
+ * Items live in a fixed array of MaxItems slots. A slot keeps its index for as long as its
+ * item stays in the inventory, so widgets can bind to slots; freed slots go on a free list
+ * and are reused first, and an ID index finds an item's slot without scanning.
+ * Mutations made between BeginTransaction and CommitTransaction (or inside an
+ * FInventoryTransaction scope) are reported together by a single change event;
+ * outside a transaction every mutation reports its own.
+ * The inventory as it stood when the loop began is kept as a copy of the slot array;
+ * a loop reset copies it back in one go and keeps any items that persist across loops.
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class TIMELOOP_API UInventoryComponent : public UActorComponent
@@ -90,9 +170,9 @@ public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	
-	// Add an item to the inventory
+	// Add an item to the inventory by the ID of its definition
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
-	bool AddItem(const FInventoryItem& Item);
+	bool AddItem(FName ItemID, int32 Count = 1);
 	
 	// Remove an item from the inventory
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
@@ -114,23 +194,142 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	void ClearInventory();
 	
-	// Delegate for inventory changes
+	// Number of slots, filled or not
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetSlotCount() const { return Slots.Num(); }
+	
+	// Get the slot an item occupies, or -1
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 FindSlot(FName ItemID) const;
+	
+	// Get the item in a slot; empty slots hold an item with no definition
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	FInventoryItem GetItemInSlot(int32 SlotIndex) const;
+	
+	// Clear an item's New flag once the player has looked at it
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void MarkItemSeen(FName ItemID);
+	
+	// Get the shared definition of an item
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	static FItemDefinition GetItemDefinition(const FInventoryItem& Item);
+	
+	// Remember the current inventory as the one every loop starts with
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Time Loop")
+	void CaptureLoopStartSnapshot();
+	
+	// Put the loop-start inventory back, keeping held items that persist across loops, as one change
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Time Loop")
+	void RestoreLoopStartSnapshot();
+	
+	// Record the held items that persist across loops in a save game
+	void SavePersistentItems(UTimeLoopSaveGame* SaveGame) const;
+	
+	// Give back a save game's persistent items that are not already held, as one change
+	void LoadPersistentItems(const UTimeLoopSaveGame* SaveGame);
+	
+	// Raise the number of slots; slots are never taken away, so indices stay valid
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void SetMaxItems(int32 NewMaxItems);
+	
+	// Start batching changes; transactions nest and only the outermost commit reports
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void BeginTransaction();
+	
+	// Finish a transaction, reporting every slot it changed in one event
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void CommitTransaction();
+	
+	// Check whether changes are currently being batched
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	bool IsInTransaction() const { return TransactionDepth > 0; }
+	
+	// Delegate for inventory changes, fired once per committed transaction
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInventoryChangedDelegate);
 	UPROPERTY(BlueprintAssignable, Category = "Inventory")
 	FOnInventoryChangedDelegate OnInventoryChanged;
+	
+	// Delegate carrying the slots a committed transaction changed, fired just before OnInventoryChanged
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryChangeSetDelegate, const FInventoryChangeSet&, ChangeSet);
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventoryChangeSetDelegate OnInventoryChangeSet;
+	
+	// Delegate for items entering the inventory
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemAcquiredDelegate, FName, ItemID, int32, Count);
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnItemAcquiredDelegate OnItemAcquired;
 
 protected:
-	// The items in the inventory
+	// The inventory slots; empty slots have no definition
 	UPROPERTY(VisibleAnywhere, Category = "Inventory")
-	TMap<FName, FInventoryItem> Items;
+	TArray<FInventoryItem> Slots;
 	
 	// Maximum number of unique items that can be stored
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory")
 	int32 MaxItems;
 	
-	// Find an item by ID
-	int32 FindItemIndex(FName ItemID) const;
+	// Empty slots in descending order, so the lowest is filled next
+	TArray<int32> FreeSlots;
+	
+	// Slot of each item in the inventory
+	FInventorySlotIndex ItemSlots;
+	
+	// Grow the slot array to MaxItems and rebuild the free list and index from it
+	void EnsureSlots();
+	
+	// Empty a slot and return it to the free list
+	void ReleaseSlot(int32 SlotIndex);
+	
+	// Open transactions; changes are reported when this returns to zero
+	int32 TransactionDepth;
+	
+	// Slots changed in the open transaction, in the order they were first touched
+	TArray<int32> TouchedSlots;
+	
+	// Contents of each touched slot before the transaction touched it
+	TArray<FInventoryItem> TouchedOriginals;
+	
+	// Whether each slot is in TouchedSlots
+	TBitArray<> SlotTouched;
+	
+	// The slot array when the loop began
+	TArray<FInventoryItem> LoopStartSlots;
+	
+	// Remember a slot's contents before the open transaction first changes it
+	void TouchSlot(int32 SlotIndex);
+	
+	// TouchSlot for every slot, copying the whole array at once when nothing is touched yet
+	void TouchAllSlots();
+	
+	// Put an item in a free slot, preferring PreferredSlot; false when the inventory is full
+	bool PlaceItem(const FInventoryItem& Item, FName ItemID, int32 PreferredSlot);
+};
+
+/**
+ * FInventoryTransaction - Scoped guard batching every inventory change made in its scope
+ */
+class FInventoryTransaction
+{
+public:
+	explicit FInventoryTransaction(UInventoryComponent* InInventory)
+		: Inventory(InInventory)
+	{
+		if (Inventory)
+		{
+			Inventory->BeginTransaction();
+		}
+	}
+	
+	~FInventoryTransaction()
+	{
+		if (Inventory)
+		{
+			Inventory->CommitTransaction();
+		}
+	}
+	
+	UE_NONCOPYABLE(FInventoryTransaction);
 	
-	// Notify that the inventory has changed
-	void NotifyInventoryChanged();
+private:
+	UInventoryComponent* Inventory;
 };
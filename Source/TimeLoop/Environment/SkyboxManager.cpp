@@ -20,6 +20,8 @@
 #include "Kismet/GameplayStatics.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Engine/DirectionalLight.h"
+#include "TimeLoop/TimeLoopGameMode.h"
+#include "Systems/RuleSystem/RuleSystem.h"
 
 // Sets default values
 ASkyboxManager::ASkyboxManager()
@@ -147,6 +149,13 @@ void ASkyboxManager::SetWeatherCondition(EWeatherCondition NewWeather)
     CurrentWeather = NewWeather;
     UpdateWeatherEffects();
     
+    // Weather is a fact for authored rules
+    ATimeLoopGameMode* GameMode = Cast<ATimeLoopGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    if (GameMode && GameMode->GetRuleSystem())
+    {
+        GameMode->GetRuleSystem()->SetWeather((uint8)CurrentWeather);
+    }
+    
     UE_LOG(LogTemp, Warning, TEXT("SkyboxManager: Weather condition set to %s"), 
         *UEnum::GetValueAsString(CurrentWeather));
 }
@@ -17,6 +17,7 @@
 #include "TimeLoop/TimeLoopGameMode.h"
 #include "Systems/CharacterSystem/NPCScheduler.h"
 #include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/TimeSystem/TimeManager.h"
 #include "Kismet/GameplayStatics.h"
 
 ANPCCharacter::ANPCCharacter()
@@ -70,13 +71,6 @@ void ANPCCharacter::Interact()
 
 bool ANPCCharacter::StartDialogue()
 {
-    // Make sure we have a dialogue tree set
-    if (DialogueTreeId == NAME_None)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("NPCCharacter: Cannot start dialogue, no dialogue tree set for %s"), *NPCId.ToString());
-        return false;
-    }
-    
     // Get dialogue manager
     UDialogueManager* DialogueManager = GetDialogueManager();
     if (!DialogueManager)
@@ -85,6 +79,31 @@ bool ANPCCharacter::StartDialogue()
         return false;
     }
     
+    // Prefer a variant chosen for the current loop, time of day and relationship
+    if (DialogueManager->HasDialogueVariants(NPCId))
+    {
+        UTimeLoopGameMode* GameMode = GetTimeLoopGameMode();
+        UTimeManager* TimeManager = GameMode ? GameMode->GetTimeManager() : nullptr;
+        UNPCScheduler* Scheduler = GetNPCScheduler();
+        
+        const int32 LoopCount = TimeManager ? TimeManager->GetLoopCount() : 1;
+        const ETimeOfDay TimeOfDay = TimeManager ? TimeManager->GetTimeOfDay() : ETimeOfDay::Morning;
+        const float Relationship = Scheduler ? Scheduler->GetRelationshipValue(NPCId) : 0.0f;
+        
+        if (DialogueManager->StartDialogueForNPC(NPCId, LoopCount, TimeOfDay, Relationship))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("NPCCharacter: Started dialogue variant with %s"), *NPCId.ToString());
+            return true;
+        }
+    }
+    
+    // Make sure we have a dialogue tree set
+    if (DialogueTreeId == NAME_None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("NPCCharacter: Cannot start dialogue, no dialogue tree set for %s"), *NPCId.ToString());
+        return false;
+    }
+    
     // Start dialogue
     bool Result = DialogueManager->StartDialogue(DialogueTreeId);
     
@@ -166,6 +166,27 @@ void UNPCScheduler::ChangeRelationship(FName NPCId, float Delta)
         *NPCId.ToString(), Delta, NewValue);
 }
 
+void UNPCScheduler::ChangeRelationships(const TMap<FName, float>& Deltas)
+{
+    for (const auto& Pair : Deltas)
+    {
+        float& Value = RelationshipValues.FindOrAdd(Pair.Key);
+        Value = FMath::Clamp(Value + Pair.Value, -100.0f, 100.0f);
+        
+        // Same mood response as a single relationship change
+        if (Pair.Value >= 5.0f)
+        {
+            SetNPCMood(Pair.Key, ENPCMood::Happy);
+        }
+        else if (Pair.Value <= -5.0f)
+        {
+            SetNPCMood(Pair.Key, ENPCMood::Angry);
+        }
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("NPC Scheduler: Applied relationship changes for %d NPCs"), Deltas.Num());
+}
+
 void UNPCScheduler::SetNPCInteracted(FName NPCId)
 {
     if (NPCStates.Contains(NPCId))
@@ -174,6 +195,8 @@ void UNPCScheduler::SetNPCInteracted(FName NPCId)
         
         UE_LOG(LogTemp, Warning, TEXT("NPC Scheduler: Marked interaction with NPC %s"), 
             *NPCId.ToString());
+        
+        OnNPCInteracted.Broadcast(NPCId);
     }
 }
 
@@ -258,9 +281,15 @@ void UNPCScheduler::UpdateNPCForTime(FName NPCId, int32 CurrentHour)
     
     // Update the NPC's state
     FNPCState& State = NPCStates[NPCId];
+    const bool bLocationChanged = State.CurrentLocation != ScheduleEntry.LocationId;
     State.CurrentLocation = ScheduleEntry.LocationId;
     State.CurrentActivity = ScheduleEntry.ActivityId;
     
+    if (bLocationChanged)
+    {
+        OnNPCLocationChanged.Broadcast(NPCId, ScheduleEntry.LocationId);
+    }
+    
     // Update the NPC character if available
     if (NPCCharacters.Contains(NPCId) && NPCCharacters[NPCId] != nullptr)
     {
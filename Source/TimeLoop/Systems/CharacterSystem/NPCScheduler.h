@@ -23,6 +23,12 @@ class UTimeManager;
 class UTimeLoopSaveGame;
 class ANPCCharacter;
 
+// Delegate for when the player interacts with an NPC
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNPCInteractedDelegate, FName, NPCId);
+
+// Delegate for when an NPC's schedule moves them to a new location
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FNPCLocationChangedDelegate, FName, NPCId, FName, LocationId);
+
 /**
  * FScheduleEntry - Represents a single entry in an NPC's schedule
  */
@@ -167,6 +173,9 @@ public:
     UFUNCTION(BlueprintCallable, Category = "NPC System")
     void ChangeRelationship(FName NPCId, float Delta);
 
+    // Apply net relationship changes for several NPCs at once
+    void ChangeRelationships(const TMap<FName, float>& Deltas);
+
     // Mark that the player has interacted with an NPC today
     UFUNCTION(BlueprintCallable, Category = "NPC System")
     void SetNPCInteracted(FName NPCId);
@@ -185,6 +194,14 @@ public:
     // Load NPC relationships from save game
     void LoadNPCRelationships(UTimeLoopSaveGame* SaveGame);
 
+    // Delegate fired whenever the player interacts with an NPC
+    UPROPERTY(BlueprintAssignable, Category = "NPC System|Events")
+    FNPCInteractedDelegate OnNPCInteracted;
+
+    // Delegate fired whenever an NPC's location changes
+    UPROPERTY(BlueprintAssignable, Category = "NPC System|Events")
+    FNPCLocationChangedDelegate OnNPCLocationChanged;
+
 private:
     // Handle hour change event
     UFUNCTION()
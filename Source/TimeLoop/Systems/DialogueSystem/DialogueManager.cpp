@@ -23,6 +23,15 @@ UDialogueManager::UDialogueManager()
     CurrentDialogueId = NAME_None;
     CurrentNodeId = NAME_None;
     QuestManager = nullptr;
+    
+    // Ambient conversation defaults
+    MaxAmbientSessions = 128;
+    AmbientMinLineDuration = 2.0f;
+    AmbientSecondsPerCharacter = 0.05f;
+    ActiveAmbientSessionCount = 0;
+    bVariantTableDirty = false;
+    CurrentTreeIndex = INDEX_NONE;
+    CurrentNodeIndex = INDEX_NONE;
 }
 
 void UDialogueManager::Initialize()
@@ -38,10 +47,24 @@ void UDialogueManager::ResetForNewDay()
         EndDialogue();
     }
     
+    // Overheard conversations start over with the day
+    StopAllAmbientDialogues();
+    
+    // Every line can be heard again in the new loop
+    VariantTable.ResetRotation();
+    
+    // Effects still queued belong to the old loop, which the game mode flushed before its snapshot
+    PendingEffects.Reset();
+    
     UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Reset for new day"));
 }
 
 bool UDialogueManager::StartDialogue(FName DialogueId)
+{
+    return StartDialogueAtNode(DialogueId, NAME_None);
+}
+
+bool UDialogueManager::StartDialogueAtNode(FName DialogueId, FName EntryNodeId)
 {
     // Make sure we're not already in a dialogue
     if (bInDialogue)
@@ -62,34 +85,25 @@ bool UDialogueManager::StartDialogue(FName DialogueId)
     const FDialogueTree& Tree = DialogueTrees[DialogueId];
     
     // Make sure the tree has an entry node
-    if (Tree.EntryNodeId == NAME_None || !Tree.Nodes.Contains(Tree.EntryNodeId))
+    const FName StartNodeId = EntryNodeId != NAME_None ? EntryNodeId : Tree.EntryNodeId;
+    if (StartNodeId == NAME_None || !Tree.Nodes.Contains(StartNodeId))
     {
-        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Dialogue '%s' has no valid entry node"), 
-            *DialogueId.ToString());
+        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Dialogue '%s' has no valid entry node '%s'"), 
+            *DialogueId.ToString(), *StartNodeId.ToString());
         return false;
     }
     
     // Set up current dialogue
     CurrentDialogueId = DialogueId;
-    CurrentNodeId = Tree.EntryNodeId;
+    CurrentNodeId = StartNodeId;
+    CurrentTreeIndex = CompiledTreeIndices.FindChecked(DialogueId);
+    CurrentNodeIndex = CompiledTrees[CurrentTreeIndex].NodeIndices.FindChecked(StartNodeId);
     bInDialogue = true;
     ConversationHistory.Empty();
     ConversationHistory.Add(CurrentNodeId);
     
-    // Set knowledge flag if specified
-    const FDialogueNode& CurrentNode = Tree.Nodes[CurrentNodeId];
-    if (QuestManager && CurrentNode.KnowledgeFlagToSet != NAME_None)
-    {
-        QuestManager->SetKnowledgeFlag(CurrentNode.KnowledgeFlagToSet);
-    }
-    
-    // Handle quest triggers
-    if (CurrentNode.bTriggersQuest && CurrentNode.QuestToTrigger != NAME_None && QuestManager)
-    {
-        QuestManager->UpdateQuestState(CurrentNode.QuestToTrigger, EQuestState::Available);
-        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Triggered quest '%s'"), 
-            *CurrentNode.QuestToTrigger.ToString());
-    }
+    // Queue the entry node's knowledge flag and quest trigger
+    QueueNodeEffects(Tree.Nodes[CurrentNodeId]);
     
     UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Started dialogue '%s' at node '%s'"), 
         *DialogueId.ToString(), *CurrentNodeId.ToString());
@@ -140,11 +154,13 @@ bool UDialogueManager::MakeChoice(int32 ChoiceIndex)
         return false;
     }
     
-    // Get the selected choice
+    // Get the selected choice and its compiled form, which has the knowledge gate resolved to a bit
     const FDialogueChoice& Choice = CurrentNode.Choices[ChoiceIndex];
+    const FCompiledDialogueTree& CompiledTree = CompiledTrees[CurrentTreeIndex];
+    const FCompiledDialogueChoice& CompiledChoice = CompiledTree.Choices[CompiledTree.Nodes[CurrentNodeIndex].FirstChoice + ChoiceIndex];
     
     // Check if the choice is available
-    if (!IsChoiceAvailable(Choice))
+    if (!IsKnowledgeBitAvailable(CompiledChoice.RequiredKnowledgeBit))
     {
         UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Choice %d is not available due to required knowledge"),
             ChoiceIndex);
@@ -154,16 +170,8 @@ bool UDialogueManager::MakeChoice(int32 ChoiceIndex)
     // Broadcast that a choice was made
     OnDialogueChoiceMade.Broadcast(ChoiceIndex, Choice.ChoiceText);
     
-    // Set knowledge flag if specified
-    if (QuestManager && Choice.KnowledgeFlagToSet != NAME_None)
-    {
-        QuestManager->SetKnowledgeFlag(Choice.KnowledgeFlagToSet);
-        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Set knowledge flag '%s'"), 
-            *Choice.KnowledgeFlagToSet.ToString());
-    }
-    
-    // Handle relationship impact
-    // TODO: Implement relationship impact through NPCScheduler
+    // Queue the choice's knowledge flag and relationship impact
+    QueueChoiceEffects(Choice);
     
     // If the choice leads to another node, navigate to it
     if (Choice.NextNodeId != NAME_None)
@@ -173,24 +181,14 @@ bool UDialogueManager::MakeChoice(int32 ChoiceIndex)
         {
             // Update current node
             CurrentNodeId = Choice.NextNodeId;
+            CurrentNodeIndex = CompiledChoice.NextNodeIndex;
             ConversationHistory.Add(CurrentNodeId);
             
             // Get the new current node
             const FDialogueNode& NewNode = Tree.Nodes[CurrentNodeId];
             
-            // Set knowledge flag if specified
-            if (QuestManager && NewNode.KnowledgeFlagToSet != NAME_None)
-            {
-                QuestManager->SetKnowledgeFlag(NewNode.KnowledgeFlagToSet);
-            }
-            
-            // Handle quest triggers
-            if (NewNode.bTriggersQuest && NewNode.QuestToTrigger != NAME_None && QuestManager)
-            {
-                QuestManager->UpdateQuestState(NewNode.QuestToTrigger, EQuestState::Available);
-                UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Triggered quest '%s'"), 
-                    *NewNode.QuestToTrigger.ToString());
-            }
+            // Queue the new node's knowledge flag and quest trigger
+            QueueNodeEffects(NewNode);
             
             // Check if we've reached an end node
             if (NewNode.bIsEndNode)
@@ -224,6 +222,8 @@ void UDialogueManager::EndDialogue()
     bInDialogue = false;
     CurrentDialogueId = NAME_None;
     CurrentNodeId = NAME_None;
+    CurrentTreeIndex = INDEX_NONE;
+    CurrentNodeIndex = INDEX_NONE;
     ConversationHistory.Empty();
     
     UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Dialogue ended"));
@@ -234,10 +234,109 @@ void UDialogueManager::RegisterDialogueTree(const FDialogueTree& DialogueTree)
     // Register the dialogue tree
     DialogueTrees.Add(DialogueTree.DialogueId, DialogueTree);
     
+    // Compile it for session traversal, replacing any previous version in place
+    if (const int32* ExistingIndex = CompiledTreeIndices.Find(DialogueTree.DialogueId))
+    {
+        // Sessions hold node indices into the old layout, so stop them
+        for (int32 SessionIndex = 0; SessionIndex < AmbientSessions.Num(); ++SessionIndex)
+        {
+            if (AmbientSessions[SessionIndex].bActive && AmbientSessions[SessionIndex].TreeIndex == *ExistingIndex)
+            {
+                ReleaseAmbientSession(SessionIndex);
+            }
+        }
+        
+        CompileDialogueTree(DialogueTree, CompiledTrees[*ExistingIndex]);
+        
+        // The player's dialogue keeps going from the same node in the new layout
+        if (bInDialogue && CurrentTreeIndex == *ExistingIndex)
+        {
+            if (const int32* NodeIndex = CompiledTrees[*ExistingIndex].NodeIndices.Find(CurrentNodeId))
+            {
+                CurrentNodeIndex = *NodeIndex;
+            }
+            else
+            {
+                EndDialogue();
+            }
+        }
+    }
+    else
+    {
+        const int32 NewIndex = CompiledTrees.AddDefaulted();
+        CompileDialogueTree(DialogueTree, CompiledTrees[NewIndex]);
+        CompiledTreeIndices.Add(DialogueTree.DialogueId, NewIndex);
+    }
+    
     UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Registered dialogue tree '%s' with %d nodes"), 
         *DialogueTree.DialogueId.ToString(), DialogueTree.Nodes.Num());
 }
 
+void UDialogueManager::RegisterDialogueVariant(const FDialogueVariant& Variant)
+{
+    DialogueVariants.Add(Variant);
+    bVariantTableDirty = true;
+}
+
+void UDialogueManager::BuildVariantTables()
+{
+    VariantTable.Build(DialogueVariants);
+    bVariantTableDirty = false;
+}
+
+bool UDialogueManager::SelectDialogueVariant(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship, FDialogueVariant& OutVariant)
+{
+    const int32 VariantIndex = FindDialogueVariant(NPCId, LoopCount, TimeOfDay, Relationship);
+    if (VariantIndex == INDEX_NONE)
+    {
+        return false;
+    }
+    
+    OutVariant = VariantTable.GetVariant(VariantIndex);
+    return true;
+}
+
+int32 UDialogueManager::FindDialogueVariant(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship)
+{
+    // Variants registered late are folded in on first use
+    if (bVariantTableDirty)
+    {
+        BuildVariantTables();
+    }
+    
+    return VariantTable.Select(NPCId, LoopCount, TimeOfDay, Relationship);
+}
+
+bool UDialogueManager::StartDialogueForNPC(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship)
+{
+    const int32 VariantIndex = FindDialogueVariant(NPCId, LoopCount, TimeOfDay, Relationship);
+    if (VariantIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: No dialogue variant for NPC '%s' in loop %d"), 
+            *NPCId.ToString(), LoopCount);
+        return false;
+    }
+    
+    // The line only counts as heard once the conversation actually starts
+    const FDialogueVariant& Variant = VariantTable.GetVariant(VariantIndex);
+    if (!StartDialogueAtNode(Variant.DialogueId, Variant.EntryNodeId))
+    {
+        return false;
+    }
+    
+    VariantTable.MarkUsed(VariantIndex, LoopCount, TimeOfDay, Relationship);
+    return true;
+}
+
+bool UDialogueManager::HasDialogueVariants(FName NPCId) const
+{
+    if (bVariantTableDirty)
+    {
+        return DialogueVariants.ContainsByPredicate([NPCId](const FDialogueVariant& Variant) { return Variant.NPCId == NPCId; });
+    }
+    return VariantTable.HasVariants(NPCId);
+}
+
 TArray<FText> UDialogueManager::GetAvailableChoices() const
 {
     TArray<FText> AvailableChoices;
@@ -255,12 +354,14 @@ TArray<FText> UDialogueManager::GetAvailableChoices() const
         return AvailableChoices;
     }
     
-    // Add all available choices
-    for (const FDialogueChoice& Choice : CurrentNode.Choices)
+    // Add all available choices, gated on their compiled knowledge bits
+    const FCompiledDialogueTree& CompiledTree = CompiledTrees[CurrentTreeIndex];
+    const int32 FirstChoice = CompiledTree.Nodes[CurrentNodeIndex].FirstChoice;
+    for (int32 ChoiceIndex = 0; ChoiceIndex < CurrentNode.Choices.Num(); ++ChoiceIndex)
     {
-        if (IsChoiceAvailable(Choice))
+        if (IsKnowledgeBitAvailable(CompiledTree.Choices[FirstChoice + ChoiceIndex].RequiredKnowledgeBit))
         {
-            AvailableChoices.Add(Choice.ChoiceText);
+            AvailableChoices.Add(CurrentNode.Choices[ChoiceIndex].ChoiceText);
         }
     }
     
@@ -275,6 +376,287 @@ bool UDialogueManager::IsChoiceAvailable(const FDialogueChoice& Choice) const
         return true;
     }
     
-    // Check if the player has the required knowledge
-    return QuestManager->HasKnowledgeFlag(Choice.RequiredKnowledgeFlag);
+    // A flag the registry has never seen cannot be known yet
+    const int32 Bit = FKnowledgeFlagRegistry::Get().Find(Choice.RequiredKnowledgeFlag);
+    return Bit != INDEX_NONE && IsKnowledgeBitAvailable(Bit);
+}
+
+bool UDialogueManager::IsKnowledgeBitAvailable(int32 Bit) const
+{
+    // Check if the player has the required knowledge, counting flags learned earlier this frame
+    return Bit == INDEX_NONE || !QuestManager
+        || QuestManager->HasKnowledgeBit(Bit)
+        || PendingEffects.KnowledgeBits.Contains(Bit);
+}
+
+void UDialogueManager::FlushSideEffects()
+{
+    if (PendingEffects.IsEmpty())
+    {
+        return;
+    }
+    
+    // Each subsystem receives its whole batch in a single call
+    if (QuestManager)
+    {
+        if (PendingEffects.KnowledgeFlags.Num() > 0)
+        {
+            QuestManager->SetKnowledgeFlags(PendingEffects.KnowledgeFlags);
+        }
+        
+        if (PendingEffects.QuestTriggers.Num() > 0)
+        {
+            QuestManager->MakeQuestsAvailable(PendingEffects.QuestTriggers);
+        }
+    }
+    
+    if (PendingEffects.RelationshipDeltas.Num() > 0)
+    {
+        TArray<FDialogueRelationshipImpact> Impacts;
+        Impacts.Reserve(PendingEffects.RelationshipDeltas.Num());
+        for (const auto& Pair : PendingEffects.RelationshipDeltas)
+        {
+            if (Pair.Value != 0.0f)
+            {
+                Impacts.Emplace(Pair.Key, Pair.Value);
+            }
+        }
+        
+        if (Impacts.Num() > 0)
+        {
+            OnRelationshipImpacts.Broadcast(Impacts);
+        }
+    }
+    
+    PendingEffects.Reset();
+}
+
+void UDialogueManager::QueueNodeEffects(const FDialogueNode& Node)
+{
+    QueueKnowledgeFlag(Node.KnowledgeFlagToSet);
+    
+    if (Node.bTriggersQuest && Node.QuestToTrigger != NAME_None)
+    {
+        PendingEffects.QuestTriggers.AddUnique(Node.QuestToTrigger);
+    }
+}
+
+void UDialogueManager::QueueChoiceEffects(const FDialogueChoice& Choice)
+{
+    QueueKnowledgeFlag(Choice.KnowledgeFlagToSet);
+    
+    if (Choice.RelationshipImpact != 0.0f)
+    {
+        // The relationship belongs to the NPC that owns the tree, falling back to whoever is speaking
+        const FDialogueTree& Tree = DialogueTrees[CurrentDialogueId];
+        FName NPCId = Tree.NPCId;
+        if (NPCId == NAME_None && Tree.Nodes.Contains(CurrentNodeId))
+        {
+            NPCId = Tree.Nodes[CurrentNodeId].SpeakerId;
+        }
+        
+        if (NPCId != NAME_None)
+        {
+            PendingEffects.RelationshipDeltas.FindOrAdd(NPCId) += Choice.RelationshipImpact;
+        }
+    }
+}
+
+void UDialogueManager::QueueKnowledgeFlag(FName FlagName)
+{
+    // The bit set doubles as the dedup check for the name list
+    const int32 Bit = FKnowledgeFlagRegistry::Get().FindOrAdd(FlagName);
+    if (Bit != INDEX_NONE && PendingEffects.KnowledgeBits.Add(Bit))
+    {
+        PendingEffects.KnowledgeFlags.Add(FlagName);
+    }
+}
+
+FDialogueSessionHandle UDialogueManager::StartAmbientDialogue(FName DialogueId)
+{
+    const int32* TreeIndex = CompiledTreeIndices.Find(DialogueId);
+    if (!TreeIndex || CompiledTrees[*TreeIndex].EntryNodeIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Ambient dialogue '%s' not found or has no entry node"), 
+            *DialogueId.ToString());
+        return FDialogueSessionHandle();
+    }
+    
+    // Reuse a released slot before growing the table
+    int32 SessionIndex = INDEX_NONE;
+    if (FreeSessionIndices.Num() > 0)
+    {
+        SessionIndex = FreeSessionIndices.Pop(false);
+    }
+    else if (AmbientSessions.Num() < MaxAmbientSessions)
+    {
+        SessionIndex = AmbientSessions.AddZeroed();
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dialogue Manager: Cannot start ambient dialogue '%s', %d sessions already running"), 
+            *DialogueId.ToString(), MaxAmbientSessions);
+        return FDialogueSessionHandle();
+    }
+    
+    const FCompiledDialogueTree& Tree = CompiledTrees[*TreeIndex];
+    FDialogueSession& Session = AmbientSessions[SessionIndex];
+    Session.TreeIndex = *TreeIndex;
+    Session.NodeIndex = Tree.EntryNodeIndex;
+    Session.TimeRemaining = Tree.Nodes[Tree.EntryNodeIndex].LineDuration;
+    Session.bActive = true;
+    ++ActiveAmbientSessionCount;
+    
+    const FDialogueSessionHandle Handle(SessionIndex, Session.Generation);
+    const FCompiledDialogueNode& EntryNode = Tree.Nodes[Tree.EntryNodeIndex];
+    OnAmbientDialogueLine.Broadcast(Handle, EntryNode.SpeakerId, EntryNode.DialogueText);
+    
+    return Handle;
+}
+
+void UDialogueManager::StopAmbientDialogue(FDialogueSessionHandle Session)
+{
+    if (IsAmbientDialogueActive(Session))
+    {
+        ReleaseAmbientSession(Session.Index);
+    }
+}
+
+void UDialogueManager::StopAllAmbientDialogues()
+{
+    for (int32 SessionIndex = 0; SessionIndex < AmbientSessions.Num(); ++SessionIndex)
+    {
+        if (AmbientSessions[SessionIndex].bActive)
+        {
+            ReleaseAmbientSession(SessionIndex);
+        }
+    }
+}
+
+bool UDialogueManager::IsAmbientDialogueActive(FDialogueSessionHandle Session) const
+{
+    return AmbientSessions.IsValidIndex(Session.Index)
+        && AmbientSessions[Session.Index].bActive
+        && AmbientSessions[Session.Index].Generation == Session.Generation;
+}
+
+bool UDialogueManager::GetAmbientDialogueLine(FDialogueSessionHandle Session, FName& OutSpeakerId, FText& OutDialogueText) const
+{
+    if (!IsAmbientDialogueActive(Session))
+    {
+        return false;
+    }
+    
+    const FDialogueSession& State = AmbientSessions[Session.Index];
+    const FCompiledDialogueNode& Node = CompiledTrees[State.TreeIndex].Nodes[State.NodeIndex];
+    OutSpeakerId = Node.SpeakerId;
+    OutDialogueText = Node.DialogueText;
+    return true;
+}
+
+void UDialogueManager::TickAmbientDialogues(float DeltaTime)
+{
+    if (ActiveAmbientSessionCount == 0)
+    {
+        return;
+    }
+    
+    // Walk the session table once; sessions are plain cursors so this stays cache friendly
+    for (int32 SessionIndex = 0; SessionIndex < AmbientSessions.Num(); ++SessionIndex)
+    {
+        FDialogueSession& Session = AmbientSessions[SessionIndex];
+        if (!Session.bActive)
+        {
+            continue;
+        }
+        
+        Session.TimeRemaining -= DeltaTime;
+        if (Session.TimeRemaining > 0.0f)
+        {
+            continue;
+        }
+        
+        const FCompiledDialogueTree& Tree = CompiledTrees[Session.TreeIndex];
+        const FCompiledDialogueNode& Node = Tree.Nodes[Session.NodeIndex];
+        
+        // Overheard conversations follow the first branch that leads somewhere
+        int32 NextNodeIndex = INDEX_NONE;
+        if (!Node.bIsEndNode)
+        {
+            for (int32 ChoiceIndex = Node.FirstChoice; ChoiceIndex < Node.FirstChoice + Node.NumChoices; ++ChoiceIndex)
+            {
+                if (Tree.Choices[ChoiceIndex].NextNodeIndex != INDEX_NONE)
+                {
+                    NextNodeIndex = Tree.Choices[ChoiceIndex].NextNodeIndex;
+                    break;
+                }
+            }
+        }
+        
+        if (NextNodeIndex == INDEX_NONE)
+        {
+            ReleaseAmbientSession(SessionIndex);
+            continue;
+        }
+        
+        const FCompiledDialogueNode& NextNode = Tree.Nodes[NextNodeIndex];
+        Session.NodeIndex = NextNodeIndex;
+        Session.TimeRemaining += NextNode.LineDuration;
+        
+        OnAmbientDialogueLine.Broadcast(FDialogueSessionHandle(SessionIndex, Session.Generation), 
+            NextNode.SpeakerId, NextNode.DialogueText);
+    }
+}
+
+void UDialogueManager::CompileDialogueTree(const FDialogueTree& DialogueTree, FCompiledDialogueTree& OutCompiled) const
+{
+    OutCompiled.DialogueId = DialogueTree.DialogueId;
+    OutCompiled.EntryNodeIndex = INDEX_NONE;
+    OutCompiled.Nodes.Reset(DialogueTree.Nodes.Num());
+    OutCompiled.Choices.Reset();
+    OutCompiled.NodeIndices.Reset();
+    
+    // Assign every node a dense index first so choices can be resolved in one pass
+    TMap<FName, int32>& NodeIndices = OutCompiled.NodeIndices;
+    NodeIndices.Reserve(DialogueTree.Nodes.Num());
+    for (const auto& Pair : DialogueTree.Nodes)
+    {
+        NodeIndices.Add(Pair.Key, NodeIndices.Num());
+    }
+    
+    for (const auto& Pair : DialogueTree.Nodes)
+    {
+        const FDialogueNode& SourceNode = Pair.Value;
+        
+        FCompiledDialogueNode& Node = OutCompiled.Nodes.AddDefaulted_GetRef();
+        Node.NodeId = Pair.Key;
+        Node.SpeakerId = SourceNode.SpeakerId;
+        Node.DialogueText = SourceNode.DialogueText;
+        Node.FirstChoice = OutCompiled.Choices.Num();
+        Node.NumChoices = SourceNode.Choices.Num();
+        Node.LineDuration = AmbientMinLineDuration + AmbientSecondsPerCharacter * SourceNode.DialogueText.ToString().Len();
+        Node.bIsEndNode = SourceNode.bIsEndNode;
+        
+        for (const FDialogueChoice& SourceChoice : SourceNode.Choices)
+        {
+            FCompiledDialogueChoice& Choice = OutCompiled.Choices.AddDefaulted_GetRef();
+            const int32* NextIndex = NodeIndices.Find(SourceChoice.NextNodeId);
+            Choice.NextNodeIndex = NextIndex ? *NextIndex : INDEX_NONE;
+            Choice.RequiredKnowledgeBit = FKnowledgeFlagRegistry::Get().FindOrAdd(SourceChoice.RequiredKnowledgeFlag);
+        }
+    }
+    
+    if (const int32* EntryIndex = NodeIndices.Find(DialogueTree.EntryNodeId))
+    {
+        OutCompiled.EntryNodeIndex = *EntryIndex;
+    }
+}
+
+void UDialogueManager::ReleaseAmbientSession(int32 SessionIndex)
+{
+    FDialogueSession& Session = AmbientSessions[SessionIndex];
+    Session.bActive = false;
+    ++Session.Generation;
+    FreeSessionIndices.Add(SessionIndex);
+    --ActiveAmbientSessionCount;
 }
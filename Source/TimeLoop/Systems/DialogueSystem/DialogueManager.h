@@ -17,6 +17,8 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Systems/DialogueSystem/DialogueVariantTable.h"
+#include "Systems/QuestSystem/KnowledgeFlagRegistry.h"
 #include "DialogueManager.generated.h"
 
 class UQuestManager;
@@ -152,6 +154,175 @@ struct FDialogueTree
     }
 };
 
+/**
+ * FDialogueSessionHandle - Identifies an ambient dialogue session
+ * The generation guards against a stale handle addressing a reused slot
+ */
+USTRUCT(BlueprintType)
+struct FDialogueSessionHandle
+{
+    GENERATED_BODY()
+
+    // Slot index in the session table
+    UPROPERTY()
+    int32 Index;
+
+    // Generation of the slot when the handle was issued
+    UPROPERTY()
+    int32 Generation;
+
+    // Constructor
+    FDialogueSessionHandle()
+        : Index(INDEX_NONE)
+        , Generation(0)
+    {
+    }
+
+    FDialogueSessionHandle(int32 InIndex, int32 InGeneration)
+        : Index(InIndex)
+        , Generation(InGeneration)
+    {
+    }
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+
+    bool operator==(const FDialogueSessionHandle& Other) const
+    {
+        return Index == Other.Index && Generation == Other.Generation;
+    }
+};
+
+// Delegate for lines spoken in ambient (NPC-to-NPC) conversations
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FAmbientDialogueLineDelegate, FDialogueSessionHandle, Session, FName, SpeakerId, FText, DialogueText);
+
+/**
+ * FDialogueRelationshipImpact - Net relationship change toward one NPC
+ */
+USTRUCT(BlueprintType)
+struct FDialogueRelationshipImpact
+{
+    GENERATED_BODY()
+
+    // The NPC whose relationship changes
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
+    FName NPCId;
+
+    // Accumulated change for this flush
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
+    float Delta;
+
+    // Constructor
+    FDialogueRelationshipImpact()
+        : NPCId(NAME_None)
+        , Delta(0.0f)
+    {
+    }
+
+    FDialogueRelationshipImpact(FName InNPCId, float InDelta)
+        : NPCId(InNPCId)
+        , Delta(InDelta)
+    {
+    }
+};
+
+// Delegate for relationship changes caused by dialogue, fired once per flush
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDialogueRelationshipImpactsDelegate, const TArray<FDialogueRelationshipImpact>&, Impacts);
+
+/**
+ * FDialogueEffectBuffer - Side effects queued by dialogue during a frame
+ * Entries are deduplicated on insert and applied together by FlushSideEffects
+ */
+struct FDialogueEffectBuffer
+{
+    // Knowledge flags to set
+    TArray<FName> KnowledgeFlags;
+
+    // Registry bits of KnowledgeFlags, so choices can be gated on them before the flush
+    FKnowledgeBits KnowledgeBits;
+
+    // Quests to make available
+    TArray<FName> QuestTriggers;
+
+    // Net relationship change per NPC
+    TMap<FName, float> RelationshipDeltas;
+
+    bool IsEmpty() const
+    {
+        return KnowledgeFlags.Num() == 0 && QuestTriggers.Num() == 0 && RelationshipDeltas.Num() == 0;
+    }
+
+    void Reset()
+    {
+        KnowledgeFlags.Reset();
+        KnowledgeBits.Reset();
+        QuestTriggers.Reset();
+        RelationshipDeltas.Reset();
+    }
+};
+
+/**
+ * FCompiledDialogueChoice - A choice with its target resolved to a node index
+ */
+struct FCompiledDialogueChoice
+{
+    // Index of the target node, INDEX_NONE ends the conversation
+    int32 NextNodeIndex;
+
+    // Knowledge registry bit required for the choice to be taken, INDEX_NONE if ungated
+    int32 RequiredKnowledgeBit;
+};
+
+/**
+ * FCompiledDialogueNode - A dialogue node flattened for index-based traversal
+ */
+struct FCompiledDialogueNode
+{
+    FName NodeId;
+    FName SpeakerId;
+    FText DialogueText;
+
+    // Range of this node's choices in FCompiledDialogueTree::Choices
+    int32 FirstChoice;
+    int32 NumChoices;
+
+    // Seconds an ambient speaker holds this line before moving on
+    float LineDuration;
+
+    bool bIsEndNode;
+};
+
+/**
+ * FCompiledDialogueTree - Flat, index-addressed form of an FDialogueTree
+ * Built once at registration so sessions never hash node names while advancing
+ */
+struct FCompiledDialogueTree
+{
+    FName DialogueId;
+    int32 EntryNodeIndex;
+    TArray<FCompiledDialogueNode> Nodes;
+    TArray<FCompiledDialogueChoice> Choices;
+
+    // Node index by ID, for entering at a named node
+    TMap<FName, int32> NodeIndices;
+};
+
+/**
+ * FDialogueSession - Cursor of one ambient conversation into a compiled tree
+ */
+struct FDialogueSession
+{
+    int32 TreeIndex;
+    int32 NodeIndex;
+
+    // Seconds left before the current line advances
+    float TimeRemaining;
+
+    // Bumped every time the slot is released
+    int32 Generation;
+
+    bool bActive;
+};
+
 /**
  * UDialogueManager - Manages NPC dialogue interactions
  */
@@ -174,6 +345,30 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Dialogue System")
     bool StartDialogue(FName DialogueId);
 
+    // Start a dialogue at a specific node instead of the tree's entry node
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System")
+    bool StartDialogueAtNode(FName DialogueId, FName EntryNodeId);
+
+    // Register a variant an NPC can open a conversation with
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Variants")
+    void RegisterDialogueVariant(const FDialogueVariant& Variant);
+
+    // Rebuild the variant selection tables from the registered variants
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Variants")
+    void BuildVariantTables();
+
+    // Pick the variant an NPC should open with in the given context, without advancing its rotation
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Variants")
+    bool SelectDialogueVariant(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship, FDialogueVariant& OutVariant);
+
+    // Start the variant an NPC should open with in the given context
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Variants")
+    bool StartDialogueForNPC(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship);
+
+    // Check if an NPC has registered dialogue variants
+    UFUNCTION(BlueprintPure, Category = "Dialogue System|Variants")
+    bool HasDialogueVariants(FName NPCId) const;
+
     // Get the current dialogue node
     UFUNCTION(BlueprintPure, Category = "Dialogue System")
     FDialogueNode GetCurrentNode() const;
@@ -205,11 +400,50 @@ public:
     // Set quest manager reference
     void SetQuestManager(UQuestManager* InQuestManager) { QuestManager = InQuestManager; }
 
+    // Start an ambient NPC-to-NPC conversation alongside the player's dialogue
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Ambient")
+    FDialogueSessionHandle StartAmbientDialogue(FName DialogueId);
+
+    // Stop an ambient conversation
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Ambient")
+    void StopAmbientDialogue(FDialogueSessionHandle Session);
+
+    // Stop every ambient conversation
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System|Ambient")
+    void StopAllAmbientDialogues();
+
+    // Check if an ambient conversation is still running
+    UFUNCTION(BlueprintPure, Category = "Dialogue System|Ambient")
+    bool IsAmbientDialogueActive(FDialogueSessionHandle Session) const;
+
+    // Get the line currently spoken in an ambient conversation
+    UFUNCTION(BlueprintPure, Category = "Dialogue System|Ambient")
+    bool GetAmbientDialogueLine(FDialogueSessionHandle Session, FName& OutSpeakerId, FText& OutDialogueText) const;
+
+    // Get the number of running ambient conversations
+    UFUNCTION(BlueprintPure, Category = "Dialogue System|Ambient")
+    int32 GetActiveAmbientDialogueCount() const { return ActiveAmbientSessionCount; }
+
+    // Advance all ambient conversations in one pass
+    void TickAmbientDialogues(float DeltaTime);
+
+    // Apply the side effects queued by dialogue this frame
+    UFUNCTION(BlueprintCallable, Category = "Dialogue System")
+    void FlushSideEffects();
+
 public:
     // Delegate fired when a dialogue choice is made
     UPROPERTY(BlueprintAssignable, Category = "Dialogue System|Events")
     FDialogueChoiceMadeDelegate OnDialogueChoiceMade;
 
+    // Delegate fired when an ambient conversation moves to a new line
+    UPROPERTY(BlueprintAssignable, Category = "Dialogue System|Events")
+    FAmbientDialogueLineDelegate OnAmbientDialogueLine;
+
+    // Delegate fired with the net relationship changes of each flush
+    UPROPERTY(BlueprintAssignable, Category = "Dialogue System|Events")
+    FDialogueRelationshipImpactsDelegate OnRelationshipImpacts;
+
 protected:
     // Reference to the quest manager
     UPROPERTY()
@@ -234,4 +468,70 @@ protected:
     // Previously visited nodes in the current conversation
     UPROPERTY()
     TArray<FName> ConversationHistory;
+
+    // Registered dialogue variants
+    UPROPERTY()
+    TArray<FDialogueVariant> DialogueVariants;
+
+    // Maximum number of ambient conversations running at once
+    UPROPERTY(EditDefaultsOnly, Category = "Dialogue System|Ambient", meta = (ClampMin = "0"))
+    int32 MaxAmbientSessions;
+
+    // Minimum time an ambient line stays up
+    UPROPERTY(EditDefaultsOnly, Category = "Dialogue System|Ambient", meta = (ClampMin = "0.0"))
+    float AmbientMinLineDuration;
+
+    // Extra time per character of an ambient line
+    UPROPERTY(EditDefaultsOnly, Category = "Dialogue System|Ambient", meta = (ClampMin = "0.0"))
+    float AmbientSecondsPerCharacter;
+
+private:
+    // Queue the knowledge and quest effects of reaching a node
+    void QueueNodeEffects(const FDialogueNode& Node);
+
+    // Queue the knowledge and relationship effects of taking a choice
+    void QueueChoiceEffects(const FDialogueChoice& Choice);
+
+    // Queue a knowledge flag once, keeping its bit for gating
+    void QueueKnowledgeFlag(FName FlagName);
+
+    // Check a choice gate by registry bit, counting flags learned earlier this frame
+    bool IsKnowledgeBitAvailable(int32 Bit) const;
+
+    // Index of the variant an NPC should open with, rebuilding the tables if needed; INDEX_NONE if none applies
+    int32 FindDialogueVariant(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship);
+
+    // Side effects waiting for the next flush
+    FDialogueEffectBuffer PendingEffects;
+
+    // Selection tables built from DialogueVariants
+    FDialogueVariantTable VariantTable;
+
+    // Whether variants were registered since the tables were last built
+    bool bVariantTableDirty;
+
+    // Flatten a dialogue tree into its index-addressed form
+    void CompileDialogueTree(const FDialogueTree& DialogueTree, FCompiledDialogueTree& OutCompiled) const;
+
+    // Release a session slot back to the free list
+    void ReleaseAmbientSession(int32 SessionIndex);
+
+    // Compiled trees, indexed by CompiledTreeIndices
+    TArray<FCompiledDialogueTree> CompiledTrees;
+
+    // Compiled tree index by dialogue ID
+    TMap<FName, int32> CompiledTreeIndices;
+
+    // Compiled tree and node of the player's dialogue, INDEX_NONE outside one
+    int32 CurrentTreeIndex;
+    int32 CurrentNodeIndex;
+
+    // Ambient session slots, reused through FreeSessionIndices
+    TArray<FDialogueSession> AmbientSessions;
+
+    // Released session slots
+    TArray<int32> FreeSessionIndices;
+
+    // Number of sessions currently running
+    int32 ActiveAmbientSessionCount;
 };
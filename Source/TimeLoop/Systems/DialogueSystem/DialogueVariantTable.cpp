@@ -0,0 +1,183 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "DialogueVariantTable.h"
+
+void FDialogueVariantTable::Build(const TArray<FDialogueVariant>& InVariants)
+{
+    Variants.Reset();
+    NPCIndices.Reset();
+    NPCFirstVariant.Reset();
+    
+    // Group variants by NPC so each NPC's variants are contiguous and addressable by a bit
+    TMap<FName, TArray<const FDialogueVariant*>> VariantsByNPC;
+    for (const FDialogueVariant& Variant : InVariants)
+    {
+        if (Variant.NPCId != NAME_None && Variant.DialogueId != NAME_None)
+        {
+            VariantsByNPC.FindOrAdd(Variant.NPCId).Add(&Variant);
+        }
+    }
+    
+    CellMasks.Reset();
+    CellMasks.SetNumZeroed(VariantsByNPC.Num() * CellsPerNPC);
+    
+    for (const auto& Pair : VariantsByNPC)
+    {
+        const int32 NPCIndex = NPCFirstVariant.Num();
+        NPCIndices.Add(Pair.Key, NPCIndex);
+        NPCFirstVariant.Add(Variants.Num());
+        
+        const TArray<const FDialogueVariant*>& NPCVariants = Pair.Value;
+        if (NPCVariants.Num() > MaxVariantsPerNPC)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Dialogue Variant Table: NPC %s has %d variants, only the first %d are used"), 
+                *Pair.Key.ToString(), NPCVariants.Num(), MaxVariantsPerNPC);
+        }
+        
+        // Highest priority seen so far in each cell
+        TArray<int32> CellPriorities;
+        CellPriorities.Init(MIN_int32, CellsPerNPC);
+        
+        const int32 NumNPCVariants = FMath::Min(NPCVariants.Num(), MaxVariantsPerNPC);
+        for (int32 LocalIndex = 0; LocalIndex < NumNPCVariants; ++LocalIndex)
+        {
+            const FDialogueVariant& Variant = *NPCVariants[LocalIndex];
+            Variants.Add(Variant);
+            
+            for (int32 Bucket = (int32)Variant.MinLoopBucket; Bucket <= (int32)Variant.MaxLoopBucket; ++Bucket)
+            {
+                for (int32 Time = 0; Time < NumTimesOfDay; ++Time)
+                {
+                    if (Variant.TimesOfDay.Num() > 0 && !Variant.TimesOfDay.Contains((ETimeOfDay)Time))
+                    {
+                        continue;
+                    }
+                    
+                    for (int32 Band = (int32)Variant.MinRelationshipBand; Band <= (int32)Variant.MaxRelationshipBand; ++Band)
+                    {
+                        const int32 CellIndex = GetCellIndex(NPCIndex, (EDialogueLoopBucket)Bucket, (ETimeOfDay)Time, (ERelationshipBand)Band);
+                        int32& CellPriority = CellPriorities[CellIndex - NPCIndex * CellsPerNPC];
+                        
+                        // A higher priority variant replaces everything below it in the cell
+                        if (Variant.Priority > CellPriority)
+                        {
+                            CellPriority = Variant.Priority;
+                            CellMasks[CellIndex] = 0;
+                        }
+                        
+                        if (Variant.Priority == CellPriority)
+                        {
+                            CellMasks[CellIndex] |= (uint64)1 << LocalIndex;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    UsedMasks.Reset();
+    UsedMasks.SetNumZeroed(NPCFirstVariant.Num());
+    
+    UE_LOG(LogTemp, Log, TEXT("Dialogue Variant Table: Built tables for %d variants across %d NPCs"), 
+        Variants.Num(), NPCFirstVariant.Num());
+}
+
+int32 FDialogueVariantTable::Select(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship) const
+{
+    const int32* NPCIndex = NPCIndices.Find(NPCId);
+    if (!NPCIndex)
+    {
+        return INDEX_NONE;
+    }
+    
+    const uint64 CellMask = CellMasks[GetCellIndex(*NPCIndex, GetLoopBucket(LoopCount), TimeOfDay, GetRelationshipBand(Relationship))];
+    if (CellMask == 0)
+    {
+        return INDEX_NONE;
+    }
+    
+    // Prefer variants not yet heard this loop; once all have been, the cell starts over
+    uint64 Available = CellMask & ~UsedMasks[*NPCIndex];
+    if (Available == 0)
+    {
+        Available = CellMask;
+    }
+    
+    return NPCFirstVariant[*NPCIndex] + (int32)FMath::CountTrailingZeros64(Available);
+}
+
+void FDialogueVariantTable::MarkUsed(int32 VariantIndex, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship)
+{
+    if (!Variants.IsValidIndex(VariantIndex))
+    {
+        return;
+    }
+    
+    const int32 NPCIndex = NPCIndices.FindChecked(Variants[VariantIndex].NPCId);
+    const uint64 CellMask = CellMasks[GetCellIndex(NPCIndex, GetLoopBucket(LoopCount), TimeOfDay, GetRelationshipBand(Relationship))];
+    
+    // A cell whose variants have all been heard starts over, as Select assumed
+    uint64& Used = UsedMasks[NPCIndex];
+    if ((CellMask & ~Used) == 0)
+    {
+        Used &= ~CellMask;
+    }
+    Used |= (uint64)1 << (VariantIndex - NPCFirstVariant[NPCIndex]);
+}
+
+void FDialogueVariantTable::ResetRotation()
+{
+    FMemory::Memzero(UsedMasks.GetData(), UsedMasks.Num() * sizeof(uint64));
+}
+
+EDialogueLoopBucket FDialogueVariantTable::GetLoopBucket(int32 LoopCount)
+{
+    if (LoopCount <= 1)
+    {
+        return EDialogueLoopBucket::FirstLoop;
+    }
+    if (LoopCount <= 5)
+    {
+        return EDialogueLoopBucket::EarlyLoops;
+    }
+    if (LoopCount <= 20)
+    {
+        return EDialogueLoopBucket::LaterLoops;
+    }
+    return EDialogueLoopBucket::ManyLoops;
+}
+
+ERelationshipBand FDialogueVariantTable::GetRelationshipBand(float Relationship)
+{
+    if (Relationship < -50.0f)
+    {
+        return ERelationshipBand::Hostile;
+    }
+    if (Relationship < -10.0f)
+    {
+        return ERelationshipBand::Cold;
+    }
+    if (Relationship <= 10.0f)
+    {
+        return ERelationshipBand::Neutral;
+    }
+    if (Relationship <= 50.0f)
+    {
+        return ERelationshipBand::Warm;
+    }
+    return ERelationshipBand::Close;
+}
@@ -0,0 +1,168 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Systems/TimeSystem/TimeManager.h"
+#include "DialogueVariantTable.generated.h"
+
+/**
+ * EDialogueLoopBucket - Coarse ranges of the loop count used to pick dialogue variants
+ */
+UENUM(BlueprintType)
+enum class EDialogueLoopBucket : uint8
+{
+    FirstLoop UMETA(DisplayName = "First Loop"),
+    EarlyLoops UMETA(DisplayName = "Early Loops (2-5)"),
+    LaterLoops UMETA(DisplayName = "Later Loops (6-20)"),
+    ManyLoops UMETA(DisplayName = "Many Loops (21+)")
+};
+
+/**
+ * ERelationshipBand - Coarse ranges of an NPC relationship value
+ */
+UENUM(BlueprintType)
+enum class ERelationshipBand : uint8
+{
+    Hostile UMETA(DisplayName = "Hostile (-100 to -50)"),
+    Cold UMETA(DisplayName = "Cold (-50 to -10)"),
+    Neutral UMETA(DisplayName = "Neutral (-10 to 10)"),
+    Warm UMETA(DisplayName = "Warm (10 to 50)"),
+    Close UMETA(DisplayName = "Close (50 to 100)")
+};
+
+/**
+ * FDialogueVariant - One way an NPC can open a conversation, and when it applies
+ */
+USTRUCT(BlueprintType)
+struct FDialogueVariant
+{
+    GENERATED_BODY()
+
+    // The NPC this variant belongs to
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    FName NPCId;
+
+    // The dialogue tree to start
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    FName DialogueId;
+
+    // Node to start at, NAME_None uses the tree's entry node
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    FName EntryNodeId;
+
+    // Earliest loop bucket this variant is used in
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    EDialogueLoopBucket MinLoopBucket;
+
+    // Latest loop bucket this variant is used in
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    EDialogueLoopBucket MaxLoopBucket;
+
+    // Times of day this variant is used at, empty for all
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    TArray<ETimeOfDay> TimesOfDay;
+
+    // Lowest relationship band this variant is used at
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    ERelationshipBand MinRelationshipBand;
+
+    // Highest relationship band this variant is used at
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    ERelationshipBand MaxRelationshipBand;
+
+    // Where several variants apply, only those with the highest priority are used
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+    int32 Priority;
+
+    // Constructor
+    FDialogueVariant()
+        : NPCId(NAME_None)
+        , DialogueId(NAME_None)
+        , EntryNodeId(NAME_None)
+        , MinLoopBucket(EDialogueLoopBucket::FirstLoop)
+        , MaxLoopBucket(EDialogueLoopBucket::ManyLoops)
+        , MinRelationshipBand(ERelationshipBand::Hostile)
+        , MaxRelationshipBand(ERelationshipBand::Close)
+        , Priority(0)
+    {
+    }
+};
+
+/**
+ * FDialogueVariantTable - Precomputed variant selection by (NPC, loop bucket, time of day, relationship band)
+ *
+ * Each cell holds a 64-bit mask over the NPC's variants, so selection is a lookup
+ * plus a mask test. Rotation state is one 64-bit mask per NPC recording which
+ * variants were already used this loop; a cell starts over once all of its
+ * variants have been heard.
+ */
+class TIMELOOP_API FDialogueVariantTable
+{
+public:
+    // Most variants one NPC can have
+    static constexpr int32 MaxVariantsPerNPC = 64;
+
+    // Rebuild the tables from a set of variants
+    void Build(const TArray<FDialogueVariant>& Variants);
+
+    // Pick the next variant for an NPC without using it up, INDEX_NONE if none applies
+    int32 Select(FName NPCId, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship) const;
+
+    // Record a variant Select returned as heard, advancing its NPC's rotation
+    void MarkUsed(int32 VariantIndex, int32 LoopCount, ETimeOfDay TimeOfDay, float Relationship);
+
+    // Get a variant by the index Select returned
+    const FDialogueVariant& GetVariant(int32 VariantIndex) const { return Variants[VariantIndex]; }
+
+    // Check if an NPC has any variants
+    bool HasVariants(FName NPCId) const { return NPCIndices.Contains(NPCId); }
+
+    // Forget which variants were used, so every line is fresh again
+    void ResetRotation();
+
+    static EDialogueLoopBucket GetLoopBucket(int32 LoopCount);
+    static ERelationshipBand GetRelationshipBand(float Relationship);
+
+private:
+    static constexpr int32 NumLoopBuckets = 4;
+    static constexpr int32 NumTimesOfDay = 4;
+    static constexpr int32 NumRelationshipBands = 5;
+    static constexpr int32 CellsPerNPC = NumLoopBuckets * NumTimesOfDay * NumRelationshipBands;
+
+    static int32 GetCellIndex(int32 NPCIndex, EDialogueLoopBucket LoopBucket, ETimeOfDay TimeOfDay, ERelationshipBand Band)
+    {
+        return NPCIndex * CellsPerNPC
+            + ((int32)LoopBucket * NumTimesOfDay + (int32)TimeOfDay) * NumRelationshipBands
+            + (int32)Band;
+    }
+
+    // All variants, grouped by NPC
+    TArray<FDialogueVariant> Variants;
+
+    // Dense NPC index by ID
+    TMap<FName, int32> NPCIndices;
+
+    // First entry of each NPC's group in Variants
+    TArray<int32> NPCFirstVariant;
+
+    // Per cell, the mask of the NPC's variants that apply
+    TArray<uint64> CellMasks;
+
+    // Per NPC, the variants already used this loop
+    TArray<uint64> UsedMasks;
+};
@@ -0,0 +1,80 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "ItemDefinitionRegistry.h"
+#include "Tools/ContentLoading.h"
+#include "Misc/Paths.h"
+
+FItemDefinitionRegistry& FItemDefinitionRegistry::Get()
+{
+    static FItemDefinitionRegistry Registry;
+    return Registry;
+}
+
+FString FItemDefinitionRegistry::GetDefaultContentDirectory()
+{
+    return FPaths::ProjectContentDir() / TEXT("Data/Items");
+}
+
+void FItemDefinitionRegistry::LoadDefaultContent()
+{
+    if (bDefaultContentLoaded)
+    {
+        return;
+    }
+    bDefaultContentLoaded = true;
+    
+    const int32 NumFailed = LoadContentDirectory(GetDefaultContentDirectory());
+    UE_LOG(LogTemp, Log, TEXT("Item Definitions: Loaded %d definitions (%d files failed)"), Definitions.Num(), NumFailed);
+}
+
+int32 FItemDefinitionRegistry::LoadContentDirectory(const FString& Directory)
+{
+    TArray<FItemDefinition> Loaded;
+    const int32 NumFailed = ContentLoading::LoadContentDirectory(Directory, Loaded, TEXT("Item Definitions"));
+    
+    // Register in ID order so indices do not depend on file order
+    Loaded.Sort([](const FItemDefinition& A, const FItemDefinition& B)
+    {
+        return A.ItemID.LexicalLess(B.ItemID);
+    });
+    
+    for (const FItemDefinition& Definition : Loaded)
+    {
+        Register(Definition);
+    }
+    
+    return NumFailed;
+}
+
+int32 FItemDefinitionRegistry::Register(const FItemDefinition& Definition)
+{
+    if (Definition.ItemID == NAME_None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Item Definitions: Ignoring a definition with no item ID"));
+        return INDEX_NONE;
+    }
+    
+    if (const int32* ExistingIndex = DefinitionIndices.Find(Definition.ItemID))
+    {
+        Definitions[*ExistingIndex] = Definition;
+        return *ExistingIndex;
+    }
+    
+    const int32 Index = Definitions.Add(Definition);
+    DefinitionIndices.Add(Definition.ItemID, Index);
+    return Index;
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture2D.h"
+#include "ItemDefinitionRegistry.generated.h"
+
+/**
+ * FItemDefinition - Shared, read-only description of one kind of item
+ * Inventories hold only an index into the registry, so every instance of an item shares one definition.
+ */
+USTRUCT(BlueprintType)
+struct FItemDefinition
+{
+    GENERATED_BODY()
+
+    // Unique identifier for this item
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    FName ItemID;
+
+    // Display name for the item
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    FText DisplayName;
+
+    // Description of the item
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    FText Description;
+
+    // Icon to display for this item; only loaded once something shows it
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    TSoftObjectPtr<UTexture2D> Icon;
+
+    // Whether this item can be stacked
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    bool bIsStackable = false;
+
+    // Maximum stack count for this item
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    int32 MaxStackCount = 1;
+
+    // Whether the player keeps this item when the loop resets (e.g., special keys)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+    bool bPersistsAcrossLoops = false;
+};
+
+/**
+ * FItemDefinitionRegistry - Every item definition the game knows, indexed densely
+ *
+ * Definitions are loaded from the JSON arrays under Content/Data/Items and sorted
+ * by ID, so an index is the same for everyone running the same content. Indices
+ * can still move when content changes, so anything persisted stores item IDs.
+ * The global registry is only touched from the game thread.
+ */
+class TIMELOOP_API FItemDefinitionRegistry
+{
+public:
+    // The registry shared by the running game
+    static FItemDefinitionRegistry& Get();
+
+    // Default location of the item content
+    static FString GetDefaultContentDirectory();
+
+    // Load the default item content the first time it is needed
+    void LoadDefaultContent();
+
+    // Load every definition in a content directory, returning the number of files that failed
+    int32 LoadContentDirectory(const FString& Directory);
+
+    // Add a definition, or replace one with the same ID in place; returns its index
+    int32 Register(const FItemDefinition& Definition);
+
+    // Get the index of an item's definition, or INDEX_NONE
+    int32 Find(FName ItemID) const
+    {
+        const int32* Index = DefinitionIndices.Find(ItemID);
+        return Index ? *Index : INDEX_NONE;
+    }
+
+    // Get a definition by index, or null
+    const FItemDefinition* GetDefinition(int32 Index) const
+    {
+        return Definitions.IsValidIndex(Index) ? &Definitions[Index] : nullptr;
+    }
+
+    // Get a definition by item ID, or null
+    const FItemDefinition* FindDefinition(FName ItemID) const { return GetDefinition(Find(ItemID)); }
+
+    // Number of registered definitions
+    int32 Num() const { return Definitions.Num(); }
+
+private:
+    TArray<FItemDefinition> Definitions;
+    TMap<FName, int32> DefinitionIndices;
+
+    bool bDefaultContentLoaded = false;
+};
@@ -0,0 +1,183 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "ItemIconCache.h"
+#include "ItemDefinitionRegistry.h"
+#include "Tools/ContentLoading.h"
+#include "Components/Image.h"
+#include "Engine/AssetManager.h"
+#include "Misc/Paths.h"
+
+FItemIconCache& FItemIconCache::Get()
+{
+    static FItemIconCache Cache;
+    return Cache;
+}
+
+FString FItemIconCache::GetDefaultManifestDirectory()
+{
+    return FPaths::ProjectContentDir() / TEXT("Data/ItemIcons");
+}
+
+void FItemIconCache::SetImageIcon(UImage* Image, int32 DefinitionIndex, const FSlateBrush& IconBrush, const FSlateBrush& PlaceholderBrush)
+{
+    if (!Image)
+    {
+        return;
+    }
+    
+    FIconSource Source;
+    if (!FindIconSource(DefinitionIndex, Source))
+    {
+        WantedIcons.Remove(Image);
+        Image->SetBrush(PlaceholderBrush);
+        return;
+    }
+    
+    if (UTexture2D* Texture = Source.Texture.Get())
+    {
+        WantedIcons.Remove(Image);
+        ApplyIcon(Image, Texture, Source.UVRegion, IconBrush);
+        return;
+    }
+    
+    // Placeholder now, the icon once it arrives if the image still wants it
+    WantedIcons.Add(Image, { DefinitionIndex, IconBrush });
+    Image->SetBrush(PlaceholderBrush);
+    RequestTexture(Source.Texture.ToSoftObjectPath());
+}
+
+void FItemIconCache::PrefetchIcon(int32 DefinitionIndex)
+{
+    FIconSource Source;
+    if (FindIconSource(DefinitionIndex, Source) && !Source.Texture.Get())
+    {
+        RequestTexture(Source.Texture.ToSoftObjectPath());
+    }
+}
+
+bool FItemIconCache::IsIconResident(int32 DefinitionIndex)
+{
+    FIconSource Source;
+    return FindIconSource(DefinitionIndex, Source) && Source.Texture.Get() != nullptr;
+}
+
+void FItemIconCache::LoadManifest()
+{
+    if (bManifestLoaded)
+    {
+        return;
+    }
+    bManifestLoaded = true;
+    
+    TArray<FItemIconAtlasEntry> Entries;
+    ContentLoading::LoadContentDirectory(GetDefaultManifestDirectory(), Entries, TEXT("Item Icons"));
+    for (FItemIconAtlasEntry& Entry : Entries)
+    {
+        AtlasEntries.Add(Entry.ItemID, MoveTemp(Entry));
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Item Icons: %d icons packed into atlases"), AtlasEntries.Num());
+}
+
+bool FItemIconCache::FindIconSource(int32 DefinitionIndex, FIconSource& OutSource)
+{
+    const FItemDefinition* Definition = FItemDefinitionRegistry::Get().GetDefinition(DefinitionIndex);
+    if (!Definition)
+    {
+        return false;
+    }
+    
+    LoadManifest();
+    
+    // Packed icons come from their atlas page; the rest from their own texture
+    const FItemIconAtlasEntry* Entry = AtlasEntries.Find(Definition->ItemID);
+    if (Entry && !Entry->Atlas.IsNull())
+    {
+        OutSource.Texture = Entry->Atlas;
+        OutSource.UVRegion = FBox2D(Entry->UVMin, Entry->UVMax);
+        return true;
+    }
+    
+    if (Definition->Icon.IsNull())
+    {
+        return false;
+    }
+    
+    OutSource.Texture = Definition->Icon;
+    OutSource.UVRegion = FBox2D(FVector2D::ZeroVector, FVector2D::UnitVector);
+    return true;
+}
+
+void FItemIconCache::ApplyIcon(UImage* Image, UTexture2D* Texture, const FBox2D& UVRegion, const FSlateBrush& IconBrush)
+{
+    // The image may be showing the placeholder by now, so the designed brush is passed in
+    FSlateBrush Brush = IconBrush;
+    Brush.DrawAs = ESlateBrushDrawType::Image;
+    Brush.SetResourceObject(Texture);
+    Brush.SetUVRegion(UVRegion);
+    Image->SetBrush(Brush);
+}
+
+void FItemIconCache::RequestTexture(const FSoftObjectPath& Path)
+{
+    if (PendingLoads.Contains(Path))
+    {
+        return;
+    }
+    
+    // The callback may run before RequestAsyncLoad returns if the texture is already in memory
+    PendingLoads.Add(Path);
+    TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+        Path, FStreamableDelegate::CreateRaw(this, &FItemIconCache::OnTextureLoaded, Path), FStreamableManager::AsyncLoadHighPriority);
+    if (Handle.IsValid())
+    {
+        LoadedHandles.Add(Path, Handle);
+    }
+    else
+    {
+        PendingLoads.Remove(Path);
+    }
+}
+
+void FItemIconCache::OnTextureLoaded(FSoftObjectPath Path)
+{
+    PendingLoads.Remove(Path);
+    
+    UTexture2D* Texture = Cast<UTexture2D>(Path.ResolveObject());
+    if (!Texture)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Item Icons: Failed to load %s"), *Path.ToString());
+        LoadedHandles.Remove(Path);
+    }
+    
+    for (auto It = WantedIcons.CreateIterator(); It; ++It)
+    {
+        UImage* Image = It->Key.Get();
+        FIconSource Source;
+        if (Image && (!FindIconSource(It->Value.DefinitionIndex, Source) || Source.Texture.ToSoftObjectPath() != Path))
+        {
+            continue;
+        }
+        
+        // Failed loads leave the placeholder up
+        if (Image && Texture)
+        {
+            ApplyIcon(Image, Texture, Source.UVRegion, It->Value.IconBrush);
+        }
+        It.RemoveCurrent();
+    }
+}
@@ -0,0 +1,128 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/Texture2D.h"
+#include "Styling/SlateBrush.h"
+#include "ItemIconCache.generated.h"
+
+class UImage;
+
+/**
+ * FItemIconAtlasEntry - Where one item's icon sits inside a packed atlas page
+ * Written by the item icon atlas commandlet and read back at runtime.
+ */
+USTRUCT()
+struct FItemIconAtlasEntry
+{
+    GENERATED_BODY()
+
+    // The item whose icon this is
+    UPROPERTY()
+    FName ItemID;
+
+    // The atlas page holding the icon
+    UPROPERTY()
+    TSoftObjectPtr<UTexture2D> Atlas;
+
+    // Top-left corner of the icon on the page, in UV space
+    UPROPERTY()
+    FVector2D UVMin = FVector2D::ZeroVector;
+
+    // Bottom-right corner of the icon on the page, in UV space
+    UPROPERTY()
+    FVector2D UVMax = FVector2D::UnitVector;
+};
+
+/**
+ * FItemIconCache - Streams item icons in the background and hands them to UI images
+ *
+ * Icons packed by the atlas commandlet are drawn from their shared atlas page with a
+ * UV region, so a grid of icons batches into few draw calls and small icons stop
+ * paying for a texture each; icons left out of the atlas are streamed on their own.
+ * Nothing is loaded synchronously: an image shows a placeholder until its icon is
+ * resident, and only gets the icon if it still wants the same item by then.
+ * Loads go through the asset manager's streamable manager, and loaded icons stay
+ * resident for the session. Only touched from the game thread.
+ */
+class TIMELOOP_API FItemIconCache
+{
+public:
+    // The cache shared by the running game
+    static FItemIconCache& Get();
+
+    // Default location of the atlas manifest written by the commandlet
+    static FString GetDefaultManifestDirectory();
+
+    // Show an item's icon in an image, with the placeholder until it has streamed in;
+    // IconBrush is the image's designed brush, whose size, tint and margins the icon is drawn with
+    void SetImageIcon(UImage* Image, int32 DefinitionIndex, const FSlateBrush& IconBrush, const FSlateBrush& PlaceholderBrush);
+
+    // Start streaming an item's icon ahead of time
+    void PrefetchIcon(int32 DefinitionIndex);
+
+    // Check whether an item's icon can be shown without waiting
+    bool IsIconResident(int32 DefinitionIndex);
+
+    // Number of icon textures and atlas pages currently loading
+    int32 GetNumPendingLoads() const { return PendingLoads.Num(); }
+
+private:
+    // Texture and UV region an item's icon is drawn from
+    struct FIconSource
+    {
+        TSoftObjectPtr<UTexture2D> Texture;
+        FBox2D UVRegion = FBox2D(FVector2D::ZeroVector, FVector2D::UnitVector);
+    };
+
+    // Read the atlas manifest the first time an icon is needed
+    void LoadManifest();
+
+    // Find where an item's icon comes from; false when it has none
+    bool FindIconSource(int32 DefinitionIndex, FIconSource& OutSource);
+
+    // An image waiting on an icon, and the brush to draw the icon with
+    struct FWantedIcon
+    {
+        int32 DefinitionIndex;
+        FSlateBrush IconBrush;
+    };
+
+    // Point an image at a resident icon, drawn with the designed brush's size and tint
+    static void ApplyIcon(UImage* Image, UTexture2D* Texture, const FBox2D& UVRegion, const FSlateBrush& IconBrush);
+
+    // Start loading a texture unless it is already resident or on its way
+    void RequestTexture(const FSoftObjectPath& Path);
+
+    // Hand a finished texture to every image still waiting for an icon on it
+    void OnTextureLoaded(FSoftObjectPath Path);
+
+    // Atlas placement of each packed item
+    TMap<FName, FItemIconAtlasEntry> AtlasEntries;
+    bool bManifestLoaded = false;
+
+    // Handles keeping loaded icons and atlas pages resident
+    TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> LoadedHandles;
+
+    // Textures still loading
+    TSet<FSoftObjectPath> PendingLoads;
+
+    // The item each image was last asked to show; stale requests are dropped on arrival
+    TMap<TWeakObjectPtr<UImage>, FWantedIcon> WantedIcons;
+};
@@ -0,0 +1,193 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "KnowledgeFlagRegistry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool FKnowledgeBits::Add(int32 Bit)
+{
+    check(Bit >= 0);
+    
+    const int32 WordIndex = Bit >> 6;
+    if (WordIndex >= Words.Num())
+    {
+        Words.SetNumZeroed(WordIndex + 1);
+    }
+    
+    const uint64 Mask = 1ull << (Bit & 63);
+    const bool bWasSet = (Words[WordIndex] & Mask) != 0;
+    Words[WordIndex] |= Mask;
+    return !bWasSet;
+}
+
+bool FKnowledgeBits::Remove(int32 Bit)
+{
+    if (!Contains(Bit))
+    {
+        return false;
+    }
+    
+    Words[Bit >> 6] &= ~(1ull << (Bit & 63));
+    return true;
+}
+
+bool FKnowledgeBits::ContainsAll(const FKnowledgeBits& Required) const
+{
+    // Whole words at a time; the loops are simple enough for the compiler to vectorize
+    const int32 NumShared = FMath::Min(Words.Num(), Required.Words.Num());
+    uint64 Missing = 0;
+    for (int32 WordIndex = 0; WordIndex < NumShared; ++WordIndex)
+    {
+        Missing |= Required.Words[WordIndex] & ~Words[WordIndex];
+    }
+    for (int32 WordIndex = NumShared; WordIndex < Required.Words.Num(); ++WordIndex)
+    {
+        Missing |= Required.Words[WordIndex];
+    }
+    return Missing == 0;
+}
+
+void FKnowledgeBits::Append(const FKnowledgeBits& Other)
+{
+    if (Words.Num() < Other.Words.Num())
+    {
+        Words.SetNumZeroed(Other.Words.Num());
+    }
+    
+    for (int32 WordIndex = 0; WordIndex < Other.Words.Num(); ++WordIndex)
+    {
+        Words[WordIndex] |= Other.Words[WordIndex];
+    }
+}
+
+int32 FKnowledgeBits::CountSetBits() const
+{
+    int32 Count = 0;
+    for (const uint64 Word : Words)
+    {
+        Count += static_cast<int32>(FMath::CountBits(Word));
+    }
+    return Count;
+}
+
+void FKnowledgeBits::Truncate(int32 NumBits)
+{
+    const int32 NumWords = (NumBits + 63) >> 6;
+    if (Words.Num() > NumWords)
+    {
+        Words.SetNum(NumWords);
+    }
+    
+    if ((NumBits & 63) != 0 && Words.Num() == NumWords)
+    {
+        Words[NumWords - 1] &= (1ull << (NumBits & 63)) - 1;
+    }
+}
+
+FKnowledgeFlagRegistry& FKnowledgeFlagRegistry::Get()
+{
+    static FKnowledgeFlagRegistry Registry;
+    return Registry;
+}
+
+FString FKnowledgeFlagRegistry::GetDefaultManifestPath()
+{
+    return FPaths::ProjectContentDir() / TEXT("Data/KnowledgeFlags.txt");
+}
+
+bool FKnowledgeFlagRegistry::LoadManifest(const FString& Path)
+{
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+    {
+        return false;
+    }
+    
+    // Manifest flags must come before any flag registered at runtime to keep their bits stable
+    if (NumStableFlags != FlagNames.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Knowledge Registry: Loading manifest %s after runtime flags were registered"), *Path);
+    }
+    
+    for (const FString& Line : Lines)
+    {
+        const FString FlagName = Line.TrimStartAndEnd();
+        if (!FlagName.IsEmpty())
+        {
+            FindOrAdd(FName(*FlagName));
+        }
+    }
+    
+    NumStableFlags = FlagNames.Num();
+    
+    UE_LOG(LogTemp, Log, TEXT("Knowledge Registry: Loaded %d flags from %s"), NumStableFlags, *Path);
+    return true;
+}
+
+bool FKnowledgeFlagRegistry::SaveManifest(const FString& Path) const
+{
+    TArray<FString> Lines;
+    Lines.Reserve(FlagNames.Num());
+    for (const FName& FlagName : FlagNames)
+    {
+        Lines.Add(FlagName.ToString());
+    }
+    return FFileHelper::SaveStringArrayToFile(Lines, *Path);
+}
+
+int32 FKnowledgeFlagRegistry::FindOrAdd(FName FlagName)
+{
+    if (FlagName == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = FlagBits.Find(FlagName))
+    {
+        return *Existing;
+    }
+    
+    const int32 NewBit = FlagNames.Add(FlagName);
+    FlagBits.Add(FlagName, NewBit);
+    return NewBit;
+}
+
+uint32 FKnowledgeFlagRegistry::GetLayoutHash(int32 Count) const
+{
+    uint32 Hash = 0;
+    const int32 NumToHash = FMath::Min(Count, FlagNames.Num());
+    for (int32 Bit = 0; Bit < NumToHash; ++Bit)
+    {
+        // Hash the text, not the FName index, which differs between sessions
+        Hash = HashCombine(Hash, GetTypeHash(FlagNames[Bit].ToString()));
+    }
+    return Hash;
+}
+
+FKnowledgeBits FKnowledgeFlagRegistry::MakeBits(const TArray<FName>& FlagNamesToSet)
+{
+    FKnowledgeBits Bits;
+    for (const FName& FlagName : FlagNamesToSet)
+    {
+        const int32 Bit = FindOrAdd(FlagName);
+        if (Bit != INDEX_NONE)
+        {
+            Bits.Add(Bit);
+        }
+    }
+    return Bits;
+}
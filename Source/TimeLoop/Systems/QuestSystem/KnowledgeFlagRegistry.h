@@ -0,0 +1,130 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FKnowledgeBits - Packed bitset of knowledge flags, indexed by registry bit
+ * Bits past the end of the word array read as unset, so sets of different sizes combine freely
+ */
+struct TIMELOOP_API FKnowledgeBits
+{
+    // Packed flag words, bit N lives in Words[N / 64]
+    TArray<uint64> Words;
+
+    // Check a single bit
+    FORCEINLINE bool Contains(int32 Bit) const
+    {
+        const int32 WordIndex = Bit >> 6;
+        return Bit >= 0 && WordIndex < Words.Num() && (Words[WordIndex] & (1ull << (Bit & 63))) != 0;
+    }
+
+    // Set a single bit, returning true if it was not already set
+    bool Add(int32 Bit);
+
+    // Clear a single bit, returning true if it was set
+    bool Remove(int32 Bit);
+
+    // Check that every bit in Required is set
+    bool ContainsAll(const FKnowledgeBits& Required) const;
+
+    // Set every bit in Other
+    void Append(const FKnowledgeBits& Other);
+
+    // Number of set bits
+    int32 CountSetBits() const;
+
+    // Clear every bit, keeping the allocation
+    void Reset() { FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64)); }
+
+    // Drop every bit at or above NumBits
+    void Truncate(int32 NumBits);
+
+    // Call Visitor(int32 Bit) for every set bit in ascending order
+    template <typename VisitorType>
+    void ForEachSetBit(VisitorType&& Visitor) const
+    {
+        for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+        {
+            uint64 Word = Words[WordIndex];
+            while (Word)
+            {
+                Visitor(WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word)));
+                Word &= Word - 1;
+            }
+        }
+    }
+};
+
+/**
+ * FKnowledgeFlagRegistry - Assigns every knowledge flag a stable dense bit index
+ *
+ * The registry is append-only: the content commandlet writes every flag it finds
+ * into the manifest at cook time, and a flag keeps its bit forever once it is in
+ * the manifest. Saves store raw bit words, so they stay valid as long as the
+ * manifest only grows. Flags first seen at runtime are appended after the manifest
+ * and are saved by name because their bits are not stable between sessions.
+ * The global registry is only touched from the game thread.
+ */
+class TIMELOOP_API FKnowledgeFlagRegistry
+{
+public:
+    // The registry shared by the running game
+    static FKnowledgeFlagRegistry& Get();
+
+    // Default location of the cooked manifest
+    static FString GetDefaultManifestPath();
+
+    // Load a manifest, appending its flags in file order; returns false if it could not be read
+    bool LoadManifest(const FString& Path);
+
+    // Write every registered flag to a manifest, one per line in bit order
+    bool SaveManifest(const FString& Path) const;
+
+    // Get the bit of a flag, registering it if needed; INDEX_NONE for NAME_None
+    int32 FindOrAdd(FName FlagName);
+
+    // Get the bit of a flag without registering it
+    int32 Find(FName FlagName) const
+    {
+        const int32* Bit = FlagBits.Find(FlagName);
+        return Bit ? *Bit : INDEX_NONE;
+    }
+
+    // Get the flag registered at a bit
+    FName GetFlagName(int32 Bit) const { return FlagNames.IsValidIndex(Bit) ? FlagNames[Bit] : NAME_None; }
+
+    // Number of registered flags
+    int32 Num() const { return FlagNames.Num(); }
+
+    // Number of flags that came from the manifest and have stable bits
+    int32 GetNumStableFlags() const { return NumStableFlags; }
+
+    // Hash of the names of the first Count flags, used to check a saved layout still matches
+    uint32 GetLayoutHash(int32 Count) const;
+
+    // Build a bit mask from flag names, registering any that are new
+    FKnowledgeBits MakeBits(const TArray<FName>& FlagNamesToSet);
+
+private:
+    TArray<FName> FlagNames;
+    TMap<FName, int32> FlagBits;
+
+    // Flags loaded from a manifest come first and keep their bits across sessions
+    int32 NumStableFlags = 0;
+};
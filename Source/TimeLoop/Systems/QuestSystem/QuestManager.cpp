@@ -13,31 +13,94 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+
 #include "QuestManager.h"
 #include "Systems/TimeSystem/TimeLoopSaveGame.h"
+#include "Algo/BinarySearch.h"
 
 UQuestManager::UQuestManager()
 {
     // Default initialization
+    LoopCount = 1;
+    LoopGeneration = 1;
+    
+    for (int32 StateIndex = 0; StateIndex < NumQuestStates; ++StateIndex)
+    {
+        StateHeads[StateIndex] = INDEX_NONE;
+        StateTails[StateIndex] = INDEX_NONE;
+        StateCounts[StateIndex] = 0;
+    }
 }
 
 void UQuestManager::Initialize()
 {
+    // Give cooked flags their stable bits before any content registers new ones
+    FKnowledgeFlagRegistry& Registry = FKnowledgeFlagRegistry::Get();
+    if (Registry.GetNumStableFlags() == 0 && !Registry.LoadManifest(FKnowledgeFlagRegistry::GetDefaultManifestPath()))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: No knowledge flag manifest found, saved knowledge will be stored by name"));
+    }
+    
     UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Initialized"));
 }
 
 void UQuestManager::AddQuest(const FQuest& Quest)
 {
-    // Add to quest map
-    Quests.Add(Quest.QuestId, Quest);
+    // Replace an existing quest in place so its index stays stable
+    int32 QuestIndex;
+    if (const int32* ExistingIndex = QuestIndices.Find(Quest.QuestId))
+    {
+        QuestIndex = *ExistingIndex;
+        UnregisterObjectiveTriggers(QuestIndex);
+        UnregisterObjectives(QuestIndex);
+        UnlinkQuestState(QuestIndex);
+        Quests[QuestIndex] = Quest;
+        
+        // Retire the old version's prerequisites; the reverse indices skip retired slots
+        const FQuestPrerequisiteState& OldState = PrerequisiteStates[QuestIndex];
+        for (int32 SlotIndex = OldState.FirstSlot; SlotIndex < OldState.FirstSlot + OldState.NumSlots; ++SlotIndex)
+        {
+            PrerequisiteSlots[SlotIndex].QuestIndex = INDEX_NONE;
+        }
+        PrerequisiteStates[QuestIndex] = FQuestPrerequisiteState();
+    }
+    else
+    {
+        QuestIndex = Quests.Add(Quest);
+        QuestIndices.Add(Quest.QuestId, QuestIndex);
+        PrerequisiteStates.AddDefaulted();
+        StateLinks.AddDefaulted();
+        Baselines.AddDefaulted();
+        DirtyGenerations.Add(0);
+        ObjectiveProgress.AddDefaulted();
+    }
+    
+    LinkQuestState(QuestIndex);
+    
+    RegisterObjectives(QuestIndex);
+    RegisterPrerequisites(QuestIndex);
+    RegisterObjectiveTriggers(QuestIndex);
+    CaptureBaseline(QuestIndex);
+    
+    // Quests added earlier may have been waiting on this one
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    OnQuestStateChanged(QuestIndex, Worklist, ChangedQuests);
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
     
     UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Added quest %s"), *Quest.QuestId.ToString());
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
 }
 
 void UQuestManager::UpdateQuestState(FName QuestId, EQuestState NewState)
 {
     // Make sure the quest exists
-    if (!Quests.Contains(QuestId))
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    if (!QuestIndex)
     {
         UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Cannot update state for non-existent quest %s"), 
             *QuestId.ToString());
@@ -45,105 +108,117 @@ void UQuestManager::UpdateQuestState(FName QuestId, EQuestState NewState)
     }
     
     // Update the quest state
-    FQuest& Quest = Quests[QuestId];
-    EQuestState OldState = Quest.State;
-    Quest.State = NewState;
+    const EQuestState OldState = Quests[*QuestIndex].State;
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    SetQuestStateInternal(*QuestIndex, NewState, Worklist, ChangedQuests);
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
     
     UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Quest %s state changed from %d to %d"), 
         *QuestId.ToString(), static_cast<int32>(OldState), static_cast<int32>(NewState));
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
 }
 
 void UQuestManager::CompleteObjective(FName QuestId, FName ObjectiveId)
 {
     // Make sure the quest exists
-    if (!Quests.Contains(QuestId))
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    if (!QuestIndex)
     {
         UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Cannot complete objective for non-existent quest %s"), 
             *QuestId.ToString());
         return;
     }
     
-    // Get the quest
-    FQuest& Quest = Quests[QuestId];
-    
     // Find the objective
-    bool bFoundObjective = false;
-    for (FQuestObjective& Objective : Quest.Objectives)
-    {
-        if (Objective.ObjectiveId == ObjectiveId)
-        {
-            // Mark it as completed
-            Objective.bCompleted = true;
-            bFoundObjective = true;
-            
-            UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Completed objective %s for quest %s"), 
-                *ObjectiveId.ToString(), *QuestId.ToString());
-            break;
-        }
-    }
-    
-    if (!bFoundObjective)
+    const int32 ObjectiveIndex = FindObjectiveIndex(*QuestIndex, ObjectiveId);
+    if (ObjectiveIndex == INDEX_NONE)
     {
         UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Could not find objective %s in quest %s"), 
             *ObjectiveId.ToString(), *QuestId.ToString());
+        return;
     }
     
-    // Check if all objectives are now completed
-    if (bFoundObjective && AreAllObjectivesCompleted(Quest))
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    CompleteObjectiveInternal(*QuestIndex, ObjectiveIndex, Worklist, ChangedQuests);
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    if (ChangedQuests.Num() > 0)
     {
-        // Auto-complete quest
-        UpdateQuestState(QuestId, EQuestState::Completed);
-        
-        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: All objectives completed, quest %s marked as completed"), 
-            *QuestId.ToString());
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
     }
 }
 
 bool UQuestManager::IsObjectiveCompleted(FName QuestId, FName ObjectiveId) const
 {
     // Make sure the quest exists
-    if (!Quests.Contains(QuestId))
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    if (!QuestIndex)
     {
         return false;
     }
     
-    // Get the quest
-    const FQuest& Quest = Quests[QuestId];
-    
-    // Find the objective
-    for (const FQuestObjective& Objective : Quest.Objectives)
-    {
-        if (Objective.ObjectiveId == ObjectiveId)
-        {
-            return Objective.bCompleted;
-        }
-    }
-    
-    return false;
+    const int32 ObjectiveIndex = FindObjectiveIndex(*QuestIndex, ObjectiveId);
+    return ObjectiveIndex != INDEX_NONE && ObjectiveProgress[*QuestIndex].IsCompleted(ObjectiveIndex);
+}
+
+bool UQuestManager::AreAllObjectivesCompletedForQuest(FName QuestId) const
+{
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    return QuestIndex && ObjectiveProgress[*QuestIndex].AreAllCompleted();
 }
 
 FQuest UQuestManager::GetQuest(FName QuestId) const
 {
     // Return the quest if it exists
-    if (Quests.Contains(QuestId))
+    if (const FQuest* Quest = FindQuest(QuestId))
     {
-        return Quests[QuestId];
+        return *Quest;
     }
     
     // Return an empty quest if not found
     return FQuest();
 }
 
+const FQuest* UQuestManager::FindQuest(FName QuestId) const
+{
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    return QuestIndex ? &Quests[*QuestIndex] : nullptr;
+}
+
+FQuestStateView UQuestManager::GetQuestsInState(EQuestState State) const
+{
+    const int32 StateIndex = static_cast<int32>(State);
+    return FQuestStateView(Quests, StateLinks, StateHeads[StateIndex], StateCounts[StateIndex]);
+}
+
+int32 UQuestManager::GetQuestCountInState(EQuestState State) const
+{
+    return StateCounts[static_cast<int32>(State)];
+}
+
+void UQuestManager::GetQuestIdsInState(EQuestState State, TArray<FName>& OutQuestIds) const
+{
+    OutQuestIds.Reset(GetQuestCountInState(State));
+    for (const FQuest& Quest : GetQuestsInState(State))
+    {
+        OutQuestIds.Add(Quest.QuestId);
+    }
+}
+
 TArray<FQuest> UQuestManager::GetActiveQuests() const
 {
     TArray<FQuest> ActiveQuests;
+    ActiveQuests.Reserve(GetQuestCountInState(EQuestState::InProgress));
     
-    for (const auto& Pair : Quests)
+    for (const FQuest& Quest : GetQuestsInState(EQuestState::InProgress))
     {
-        if (Pair.Value.State == EQuestState::InProgress)
-        {
-            ActiveQuests.Add(Pair.Value);
-        }
+        ActiveQuests.Add(Quest);
     }
     
     return ActiveQuests;
@@ -152,13 +227,11 @@ TArray<FQuest> UQuestManager::GetActiveQuests() const
 TArray<FQuest> UQuestManager::GetCompletedQuests() const
 {
     TArray<FQuest> CompletedQuests;
+    CompletedQuests.Reserve(GetQuestCountInState(EQuestState::Completed));
     
-    for (const auto& Pair : Quests)
+    for (const FQuest& Quest : GetQuestsInState(EQuestState::Completed))
     {
-        if (Pair.Value.State == EQuestState::Completed)
-        {
-            CompletedQuests.Add(Pair.Value);
-        }
+        CompletedQuests.Add(Quest);
     }
     
     return CompletedQuests;
@@ -166,66 +239,378 @@ TArray<FQuest> UQuestManager::GetCompletedQuests() const
 
 void UQuestManager::ResetQuestsForNewDay()
 {
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    
+    // Only quests touched since the loop started can differ from their baseline
+    const TArray<int32> TouchedQuests = MoveTemp(DirtyQuests);
+    DirtyQuests.Reset();
+    
     // Reset non-persistent quests to their initial state
-    for (auto& Pair : Quests)
+    for (const int32 QuestIndex : TouchedQuests)
     {
-        FQuest& Quest = Pair.Value;
+        FQuest& Quest = Quests[QuestIndex];
         
-        // Skip quests that persist across loops
+        // Quests that persist across loops carry their progress into the next baseline
         if (Quest.bPersistAcrossLoops)
         {
             continue;
         }
         
-        // Reset quest state if it's in progress
-        if (Quest.State == EQuestState::InProgress)
+        const FQuestBaseline& Baseline = Baselines[QuestIndex];
+        SetObjectiveProgress(QuestIndex, Baseline.Objectives);
+        SetQuestStateInternal(QuestIndex, Baseline.State, Worklist, ChangedQuests);
+        
+        // Knowledge survives the loop, so the quest may be gated differently than at the baseline
+        if (ApplyPrerequisiteGate(QuestIndex))
         {
-            Quest.State = EQuestState::Available;
-            
-            // Reset all objectives
-            for (FQuestObjective& Objective : Quest.Objectives)
-            {
-                Objective.bCompleted = false;
-            }
-            
-            UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Reset quest %s for new day"), 
-                *Quest.QuestId.ToString());
+            Worklist.Add(QuestIndex);
+            ChangedQuests.AddUnique(Quest.QuestId);
         }
+        
+        UE_LOG(LogTemp, Log, TEXT("Quest Manager: Reset quest %s for new day"), 
+            *Quest.QuestId.ToString());
+    }
+    
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    // Whatever the reset settled on is the new loop's baseline
+    for (const int32 QuestIndex : TouchedQuests)
+    {
+        CaptureBaseline(QuestIndex);
+    }
+    for (const int32 QuestIndex : DirtyQuests)
+    {
+        CaptureBaseline(QuestIndex);
+    }
+    DirtyQuests.Reset();
+    ++LoopGeneration;
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
     }
     
-    UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Reset quests for new day"));
+    UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Reset quests for new day, %d quests had changed"), TouchedQuests.Num());
+}
+
+void UQuestManager::GetQuestsChangedThisLoop(TArray<FName>& OutQuestIds) const
+{
+    OutQuestIds.Reset(DirtyQuests.Num());
+    for (const int32 QuestIndex : DirtyQuests)
+    {
+        OutQuestIds.Add(Quests[QuestIndex].QuestId);
+    }
+}
+
+bool UQuestManager::WasQuestChangedThisLoop(FName QuestId) const
+{
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    return QuestIndex && DirtyGenerations[*QuestIndex] == LoopGeneration;
 }
 
 void UQuestManager::SetKnowledgeFlag(FName FlagName, bool bValue)
 {
-    // Set or update the knowledge flag
-    KnowledgeFlags.Add(FlagName, bValue);
+    const int32 Bit = FKnowledgeFlagRegistry::Get().FindOrAdd(FlagName);
+    if (Bit == INDEX_NONE)
+    {
+        return;
+    }
+    
+    // Set or clear the knowledge bit
+    const bool bChanged = bValue ? KnowledgeBits.Add(Bit) : KnowledgeBits.Remove(Bit);
     
     UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Knowledge flag %s set to %s"), 
         *FlagName.ToString(), bValue ? TEXT("true") : TEXT("false"));
+    
+    if (bChanged)
+    {
+        // Only quests gated on this flag are re-checked
+        TArray<int32> Worklist;
+        TArray<FName> ChangedQuests;
+        OnKnowledgeBitChanged(Bit, Worklist, ChangedQuests);
+        PropagateQuestStateChanges(Worklist, ChangedQuests);
+        
+        OnKnowledgeFlagsChanged.Broadcast(TArray<FName>{ FlagName });
+        if (bValue)
+        {
+            NotifyObjectiveEvent(EObjectiveTriggerType::KnowledgeLearned, FlagName);
+        }
+        if (ChangedQuests.Num() > 0)
+        {
+            OnQuestStatesChanged.Broadcast(ChangedQuests);
+        }
+    }
 }
 
-bool UQuestManager::HasKnowledgeFlag(FName FlagName) const
+void UQuestManager::SetKnowledgeFlags(const TArray<FName>& FlagNames)
 {
-    if (KnowledgeFlags.Contains(FlagName))
+    // Only flags that were not already set count as changes
+    FKnowledgeFlagRegistry& Registry = FKnowledgeFlagRegistry::Get();
+    TArray<FName> ChangedFlags;
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    for (const FName& FlagName : FlagNames)
     {
-        return KnowledgeFlags[FlagName];
+        const int32 Bit = Registry.FindOrAdd(FlagName);
+        if (Bit != INDEX_NONE && KnowledgeBits.Add(Bit))
+        {
+            ChangedFlags.Add(FlagName);
+            OnKnowledgeBitChanged(Bit, Worklist, ChangedQuests);
+        }
+    }
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    if (ChangedFlags.Num() > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Quest Manager: Set %d new knowledge flags"), ChangedFlags.Num());
+        OnKnowledgeFlagsChanged.Broadcast(ChangedFlags);
+    }
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
+    
+    for (const FName& FlagName : ChangedFlags)
+    {
+        NotifyObjectiveEvent(EObjectiveTriggerType::KnowledgeLearned, FlagName);
     }
-    return false;
+}
+
+void UQuestManager::MakeQuestsAvailable(const TArray<FName>& QuestIds)
+{
+    // Triggers only unlock quests; a quest already underway keeps its state
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    for (const FName& QuestId : QuestIds)
+    {
+        const int32* QuestIndex = QuestIndices.Find(QuestId);
+        if (!QuestIndex)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Cannot make non-existent quest %s available"), 
+                *QuestId.ToString());
+            continue;
+        }
+        
+        if (Quests[*QuestIndex].State == EQuestState::Unavailable)
+        {
+            SetQuestStateInternal(*QuestIndex, EQuestState::Available, Worklist, ChangedQuests);
+        }
+    }
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Quest Manager: Made %d quests available"), ChangedQuests.Num());
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
+}
+
+void UQuestManager::SetLoopCount(int32 NewLoopCount)
+{
+    if (NewLoopCount == LoopCount)
+    {
+        return;
+    }
+    
+    // Only prerequisites whose threshold lies between the old and new loop flip
+    const int32 LowLoop = FMath::Min(LoopCount, NewLoopCount);
+    const int32 HighLoop = FMath::Max(LoopCount, NewLoopCount);
+    LoopCount = NewLoopCount;
+    
+    auto GetMinLoop = [](const FLoopCountSlot& LoopSlot) { return LoopSlot.MinLoopCount; };
+    const int32 First = Algo::UpperBoundBy(LoopCountSlots, LowLoop, GetMinLoop);
+    const int32 Last = Algo::UpperBoundBy(LoopCountSlots, HighLoop, GetMinLoop);
+    if (First >= Last)
+    {
+        return;
+    }
+    
+    TArray<int32> AffectedSlots;
+    AffectedSlots.Reserve(Last - First);
+    for (int32 LoopSlotIndex = First; LoopSlotIndex < Last; ++LoopSlotIndex)
+    {
+        AffectedSlots.Add(LoopCountSlots[LoopSlotIndex].SlotIndex);
+    }
+    
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    RefreshPrerequisiteSlots(AffectedSlots, Worklist, ChangedQuests);
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
+}
+
+bool UQuestManager::ArePrerequisitesMet(FName QuestId) const
+{
+    const int32* QuestIndex = QuestIndices.Find(QuestId);
+    return QuestIndex && PrerequisiteStates[*QuestIndex].NumUnmet == 0;
+}
+
+TArray<FName> UQuestManager::FindPrerequisiteCycles() const
+{
+    // Kahn's algorithm over quest-state edges; whatever never drains sits on or behind a cycle
+    TArray<int32> InDegree;
+    InDegree.SetNumZeroed(Quests.Num());
+    TArray<TArray<int32>> Dependents;
+    Dependents.SetNum(Quests.Num());
+    
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        for (const FQuestPrerequisite& Prerequisite : Quests[QuestIndex].Prerequisites)
+        {
+            if (Prerequisite.Type != EQuestPrerequisiteType::QuestState)
+            {
+                continue;
+            }
+            
+            if (const int32* RequiredIndex = QuestIndices.Find(Prerequisite.QuestId))
+            {
+                Dependents[*RequiredIndex].Add(QuestIndex);
+                ++InDegree[QuestIndex];
+            }
+        }
+    }
+    
+    TArray<int32> Ready;
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        if (InDegree[QuestIndex] == 0)
+        {
+            Ready.Add(QuestIndex);
+        }
+    }
+    
+    while (Ready.Num() > 0)
+    {
+        const int32 QuestIndex = Ready.Pop(false);
+        for (const int32 DependentIndex : Dependents[QuestIndex])
+        {
+            if (--InDegree[DependentIndex] == 0)
+            {
+                Ready.Add(DependentIndex);
+            }
+        }
+    }
+    
+    TArray<FName> CyclicQuests;
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        if (InDegree[QuestIndex] > 0)
+        {
+            CyclicQuests.Add(Quests[QuestIndex].QuestId);
+        }
+    }
+    
+    if (CyclicQuests.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: %d quests have cyclic prerequisites"), CyclicQuests.Num());
+    }
+    
+    return CyclicQuests;
+}
+
+void UQuestManager::NotifyObjectiveEvent(EObjectiveTriggerType TriggerType, FName Target, int32 Hour)
+{
+    // One lookup finds every objective waiting on this event
+    const TArray<FObjectiveRef>* Found = ObjectiveTriggers.Find(MakeTriggerKey(TriggerType, Target, Hour));
+    if (!Found)
+    {
+        return;
+    }
+    
+    // Copied because objective listeners may add quests and rehash the index
+    const TArray<FObjectiveRef> Waiting = *Found;
+    TArray<int32> Worklist;
+    TArray<FName> ChangedQuests;
+    for (const FObjectiveRef& Ref : Waiting)
+    {
+        if (Quests[Ref.QuestIndex].State == EQuestState::InProgress && !ObjectiveProgress[Ref.QuestIndex].IsCompleted(Ref.ObjectiveIndex))
+        {
+            CompleteObjectiveInternal(Ref.QuestIndex, Ref.ObjectiveIndex, Worklist, ChangedQuests);
+        }
+    }
+    PropagateQuestStateChanges(Worklist, ChangedQuests);
+    
+    if (ChangedQuests.Num() > 0)
+    {
+        OnQuestStatesChanged.Broadcast(ChangedQuests);
+    }
+}
+
+void UQuestManager::NotifyItemAcquired(FName ItemID, int32 Count)
+{
+    NotifyObjectiveEvent(EObjectiveTriggerType::ItemAcquired, ItemID);
+}
+
+void UQuestManager::NotifyNPCInteracted(FName NPCId)
+{
+    NotifyObjectiveEvent(EObjectiveTriggerType::NPCInteracted, NPCId);
+}
+
+void UQuestManager::NotifyLocationReached(FName LocationId)
+{
+    NotifyObjectiveEvent(EObjectiveTriggerType::LocationReached, LocationId);
+}
+
+void UQuestManager::NotifyHourReached(int32 Hour)
+{
+    NotifyObjectiveEvent(EObjectiveTriggerType::TimeReached, NAME_None, Hour);
+}
+
+bool UQuestManager::HasKnowledgeFlag(FName FlagName) const
+{
+    return KnowledgeBits.Contains(FKnowledgeFlagRegistry::Get().Find(FlagName));
 }
 
 void UQuestManager::SavePlayerKnowledge(UTimeLoopSaveGame* SaveGame)
 {
     if (SaveGame)
     {
-        // Copy knowledge flags to save game
-        SaveGame->KnowledgeFlags = KnowledgeFlags;
+        const FKnowledgeFlagRegistry& Registry = FKnowledgeFlagRegistry::Get();
+        const int32 NumStableFlags = Registry.GetNumStableFlags();
+        
+        // Flags with manifest bits are saved as raw words
+        SaveGame->KnowledgeBits = KnowledgeBits.Words;
+        SaveGame->KnowledgeLayoutCount = NumStableFlags;
+        SaveGame->KnowledgeLayoutHash = Registry.GetLayoutHash(NumStableFlags);
+        
+        // Flags only registered at runtime have no stable bit, so save those by name
+        SaveGame->RuntimeKnowledgeFlags.Reset();
+        KnowledgeBits.ForEachSetBit([&](int32 Bit)
+        {
+            if (Bit >= NumStableFlags)
+            {
+                SaveGame->RuntimeKnowledgeFlags.Add(Registry.GetFlagName(Bit));
+            }
+        });
         
         // Copy persistent quest progress
         SaveGame->PersistentQuestProgress = PersistentProgress;
         
-        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Saved %d knowledge flags and %d progress values"), 
-            KnowledgeFlags.Num(), PersistentProgress.Num());
+        // Quests that persist across loops are saved as their state and packed objective bits
+        SaveGame->PersistentQuests.Reset();
+        for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+        {
+            const FQuest& Quest = Quests[QuestIndex];
+            if (!Quest.bPersistAcrossLoops)
+            {
+                continue;
+            }
+            
+            FSavedQuestProgress& Saved = SaveGame->PersistentQuests.AddDefaulted_GetRef();
+            Saved.QuestId = Quest.QuestId;
+            Saved.State = static_cast<uint8>(Quest.State);
+            Saved.CompletedObjectives = ObjectiveProgress[QuestIndex].Words;
+            Saved.ObjectiveLayoutHash = GetObjectiveLayoutHash(Quest);
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Saved %d knowledge flags, %d progress values and %d persistent quests"), 
+            KnowledgeBits.CountSetBits(), PersistentProgress.Num(), SaveGame->PersistentQuests.Num());
     }
 }
 
@@ -233,28 +618,493 @@ void UQuestManager::LoadPlayerKnowledge(UTimeLoopSaveGame* SaveGame)
 {
     if (SaveGame)
     {
-        // Load knowledge flags from save game
-        KnowledgeFlags = SaveGame->KnowledgeFlags;
+        FKnowledgeFlagRegistry& Registry = FKnowledgeFlagRegistry::Get();
+        const int32 SavedLayoutCount = SaveGame->KnowledgeLayoutCount;
+        
+        // The manifest only grows, so a save is valid while its prefix of the layout is unchanged
+        if (SavedLayoutCount <= Registry.GetNumStableFlags()
+            && Registry.GetLayoutHash(SavedLayoutCount) == SaveGame->KnowledgeLayoutHash)
+        {
+            KnowledgeBits.Words = SaveGame->KnowledgeBits;
+            KnowledgeBits.Truncate(SavedLayoutCount);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Saved knowledge layout does not match the flag manifest, discarding saved flags"));
+            KnowledgeBits.Words.Reset();
+        }
+        
+        for (const FName& FlagName : SaveGame->RuntimeKnowledgeFlags)
+        {
+            const int32 Bit = Registry.FindOrAdd(FlagName);
+            if (Bit != INDEX_NONE)
+            {
+                KnowledgeBits.Add(Bit);
+            }
+        }
         
         // Load persistent quest progress
         PersistentProgress = SaveGame->PersistentQuestProgress;
         
         UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Loaded %d knowledge flags and %d progress values"), 
-            KnowledgeFlags.Num(), PersistentProgress.Num());
+            KnowledgeBits.CountSetBits(), PersistentProgress.Num());
+        
+        // Restore persistent quests; their restored state becomes the loop's baseline
+        TArray<int32> Worklist;
+        TArray<FName> ChangedQuests;
+        for (const FSavedQuestProgress& Saved : SaveGame->PersistentQuests)
+        {
+            const int32* QuestIndex = QuestIndices.Find(Saved.QuestId);
+            if (!QuestIndex || !Quests[*QuestIndex].bPersistAcrossLoops || Saved.State >= NumQuestStates)
+            {
+                continue;
+            }
+            
+            const FQuest& Quest = Quests[*QuestIndex];
+            if (Saved.ObjectiveLayoutHash == GetObjectiveLayoutHash(Quest))
+            {
+                FObjectiveProgress Progress;
+                Progress.NumObjectives = Quest.Objectives.Num();
+                Progress.Words.SetNumZeroed((Quest.Objectives.Num() + 63) / 64);
+                for (int32 WordIndex = 0; WordIndex < Progress.Words.Num() && WordIndex < Saved.CompletedObjectives.Num(); ++WordIndex)
+                {
+                    Progress.Words[WordIndex] = Saved.CompletedObjectives[WordIndex];
+                }
+                
+                // Drop bits past the last objective before counting
+                if (Progress.NumObjectives % 64 != 0)
+                {
+                    Progress.Words.Last() &= ((uint64)1 << (Progress.NumObjectives % 64)) - 1;
+                }
+                for (uint64 Word : Progress.Words)
+                {
+                    Progress.NumCompleted += static_cast<int32>(FMath::CountBits(Word));
+                }
+                SetObjectiveProgress(*QuestIndex, Progress);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Objectives of quest %s changed since it was saved, discarding saved objective progress"), 
+                    *Saved.QuestId.ToString());
+            }
+            
+            SetQuestStateInternal(*QuestIndex, static_cast<EQuestState>(Saved.State), Worklist, ChangedQuests);
+            CaptureBaseline(*QuestIndex);
+        }
+        PropagateQuestStateChanges(Worklist, ChangedQuests);
+        
+        // Knowledge was replaced wholesale, so every knowledge gate may have moved
+        RefreshAllPrerequisites(ChangedQuests);
+        if (ChangedQuests.Num() > 0)
+        {
+            OnQuestStatesChanged.Broadcast(ChangedQuests);
+        }
     }
 }
 
-bool UQuestManager::AreAllObjectivesCompleted(const FQuest& Quest) const
+void UQuestManager::RegisterPrerequisites(int32 QuestIndex)
 {
-    // Check if all objectives are completed
-    for (const FQuestObjective& Objective : Quest.Objectives)
+    const FQuest& Quest = Quests[QuestIndex];
+    FQuestPrerequisiteState& State = PrerequisiteStates[QuestIndex];
+    State.FirstSlot = PrerequisiteSlots.Num();
+    State.NumSlots = Quest.Prerequisites.Num();
+    
+    for (int32 PrerequisiteIndex = 0; PrerequisiteIndex < Quest.Prerequisites.Num(); ++PrerequisiteIndex)
     {
-        if (!Objective.bCompleted)
+        const FQuestPrerequisite& Prerequisite = Quest.Prerequisites[PrerequisiteIndex];
+        
+        const int32 SlotIndex = PrerequisiteSlots.Num();
+        FPrerequisiteSlot& Slot = PrerequisiteSlots.AddDefaulted_GetRef();
+        Slot.QuestIndex = QuestIndex;
+        Slot.PrerequisiteIndex = PrerequisiteIndex;
+        Slot.KnowledgeBit = Prerequisite.Type == EQuestPrerequisiteType::KnowledgeFlag
+            ? FKnowledgeFlagRegistry::Get().FindOrAdd(Prerequisite.KnowledgeFlag)
+            : INDEX_NONE;
+        Slot.bMet = EvaluatePrerequisite(Slot);
+        
+        if (!Slot.bMet)
+        {
+            ++State.NumUnmet;
+        }
+        
+        // Index the slot by what it watches so changes only touch their dependents
+        switch (Prerequisite.Type)
+        {
+        case EQuestPrerequisiteType::QuestState:
+            QuestStateDependents.FindOrAdd(Prerequisite.QuestId).Add(SlotIndex);
+            break;
+            
+        case EQuestPrerequisiteType::KnowledgeFlag:
         {
-            return false;
+            const int32 Bit = Slot.KnowledgeBit;
+            if (Bit != INDEX_NONE)
+            {
+                if (KnowledgeDependents.Num() <= Bit)
+                {
+                    KnowledgeDependents.SetNum(Bit + 1);
+                }
+                KnowledgeDependents[Bit].Add(SlotIndex);
+            }
+            break;
+        }
+            
+        case EQuestPrerequisiteType::MinLoopCount:
+        {
+            const int32 InsertAt = Algo::UpperBoundBy(LoopCountSlots, Prerequisite.MinLoopCount,
+                [](const FLoopCountSlot& LoopSlot) { return LoopSlot.MinLoopCount; });
+            LoopCountSlots.Insert(FLoopCountSlot{ Prerequisite.MinLoopCount, SlotIndex }, InsertAt);
+            break;
         }
+        }
+    }
+    
+    ApplyPrerequisiteGate(QuestIndex);
+}
+
+bool UQuestManager::ApplyPrerequisiteGate(int32 QuestIndex)
+{
+    // A gated quest waits for its prerequisites; one with none keeps its authored state
+    FQuest& Quest = Quests[QuestIndex];
+    if (Quest.Prerequisites.Num() == 0)
+    {
+        return false;
     }
     
-    // All objectives are completed
+    const EQuestState GatedState = PrerequisiteStates[QuestIndex].NumUnmet == 0 ? EQuestState::Available : EQuestState::Unavailable;
+    if ((Quest.State != EQuestState::Unavailable && Quest.State != EQuestState::Available) || Quest.State == GatedState)
+    {
+        return false;
+    }
+    
+    UnlinkQuestState(QuestIndex);
+    Quest.State = GatedState;
+    LinkQuestState(QuestIndex);
     return true;
 }
+
+void UQuestManager::MarkQuestDirty(int32 QuestIndex)
+{
+    if (DirtyGenerations[QuestIndex] != LoopGeneration)
+    {
+        DirtyGenerations[QuestIndex] = LoopGeneration;
+        DirtyQuests.Add(QuestIndex);
+    }
+}
+
+void UQuestManager::CaptureBaseline(int32 QuestIndex)
+{
+    const FQuest& Quest = Quests[QuestIndex];
+    FQuestBaseline& Baseline = Baselines[QuestIndex];
+    
+    Baseline.State = Quest.State;
+    Baseline.Objectives = ObjectiveProgress[QuestIndex];
+}
+
+bool UQuestManager::EvaluatePrerequisite(const FPrerequisiteSlot& Slot) const
+{
+    const FQuestPrerequisite& Prerequisite = Quests[Slot.QuestIndex].Prerequisites[Slot.PrerequisiteIndex];
+    switch (Prerequisite.Type)
+    {
+    case EQuestPrerequisiteType::QuestState:
+    {
+        const FQuest* RequiredQuest = FindQuest(Prerequisite.QuestId);
+        return RequiredQuest && RequiredQuest->State == Prerequisite.RequiredState;
+    }
+        
+    case EQuestPrerequisiteType::KnowledgeFlag:
+        return HasKnowledgeBit(Slot.KnowledgeBit);
+        
+    case EQuestPrerequisiteType::MinLoopCount:
+        return LoopCount >= Prerequisite.MinLoopCount;
+    }
+    
+    return false;
+}
+
+void UQuestManager::RefreshPrerequisiteSlots(const TArray<int32>& SlotIndices, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    for (const int32 SlotIndex : SlotIndices)
+    {
+        FPrerequisiteSlot& Slot = PrerequisiteSlots[SlotIndex];
+        if (Slot.QuestIndex == INDEX_NONE)
+        {
+            continue;
+        }
+        
+        const bool bMet = EvaluatePrerequisite(Slot);
+        if (bMet == Slot.bMet)
+        {
+            continue;
+        }
+        Slot.bMet = bMet;
+        
+        // Availability only flips when the unmet count crosses zero
+        FQuestPrerequisiteState& State = PrerequisiteStates[Slot.QuestIndex];
+        const EQuestState CurrentState = Quests[Slot.QuestIndex].State;
+        if (bMet)
+        {
+            if (--State.NumUnmet == 0 && CurrentState == EQuestState::Unavailable)
+            {
+                SetQuestStateInternal(Slot.QuestIndex, EQuestState::Available, Worklist, OutChangedQuests);
+            }
+        }
+        else
+        {
+            if (State.NumUnmet++ == 0 && CurrentState == EQuestState::Available)
+            {
+                SetQuestStateInternal(Slot.QuestIndex, EQuestState::Unavailable, Worklist, OutChangedQuests);
+            }
+        }
+    }
+}
+
+void UQuestManager::LinkQuestState(int32 QuestIndex)
+{
+    const int32 StateIndex = static_cast<int32>(Quests[QuestIndex].State);
+    FQuestStateLink& Link = StateLinks[QuestIndex];
+    
+    Link.Prev = StateTails[StateIndex];
+    Link.Next = INDEX_NONE;
+    if (Link.Prev != INDEX_NONE)
+    {
+        StateLinks[Link.Prev].Next = QuestIndex;
+    }
+    else
+    {
+        StateHeads[StateIndex] = QuestIndex;
+    }
+    StateTails[StateIndex] = QuestIndex;
+    ++StateCounts[StateIndex];
+}
+
+void UQuestManager::UnlinkQuestState(int32 QuestIndex)
+{
+    const int32 StateIndex = static_cast<int32>(Quests[QuestIndex].State);
+    FQuestStateLink& Link = StateLinks[QuestIndex];
+    
+    if (Link.Prev != INDEX_NONE)
+    {
+        StateLinks[Link.Prev].Next = Link.Next;
+    }
+    else
+    {
+        StateHeads[StateIndex] = Link.Next;
+    }
+    
+    if (Link.Next != INDEX_NONE)
+    {
+        StateLinks[Link.Next].Prev = Link.Prev;
+    }
+    else
+    {
+        StateTails[StateIndex] = Link.Prev;
+    }
+    
+    Link = FQuestStateLink();
+    --StateCounts[StateIndex];
+}
+
+void UQuestManager::SetQuestStateInternal(int32 QuestIndex, EQuestState NewState, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    FQuest& Quest = Quests[QuestIndex];
+    if (Quest.State == NewState)
+    {
+        return;
+    }
+    
+    UnlinkQuestState(QuestIndex);
+    Quest.State = NewState;
+    LinkQuestState(QuestIndex);
+    MarkQuestDirty(QuestIndex);
+    OutChangedQuests.AddUnique(Quest.QuestId);
+    Worklist.Add(QuestIndex);
+}
+
+void UQuestManager::PropagateQuestStateChanges(TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    // A cycle in the prerequisite graph could flip forever, so bound the work
+    int32 StepsRemaining = FMath::Max(1, PrerequisiteSlots.Num()) * 4;
+    
+    while (Worklist.Num() > 0)
+    {
+        const int32 QuestIndex = Worklist.Pop(false);
+        if (const TArray<int32>* Dependents = QuestStateDependents.Find(Quests[QuestIndex].QuestId))
+        {
+            StepsRemaining -= Dependents->Num();
+        }
+        OnQuestStateChanged(QuestIndex, Worklist, OutChangedQuests);
+        
+        if (StepsRemaining < 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Stopped propagating quest prerequisites, the graph has a cycle"));
+            Worklist.Reset();
+        }
+    }
+}
+
+void UQuestManager::OnQuestStateChanged(int32 QuestIndex, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    if (const TArray<int32>* Dependents = QuestStateDependents.Find(Quests[QuestIndex].QuestId))
+    {
+        RefreshPrerequisiteSlots(*Dependents, Worklist, OutChangedQuests);
+    }
+}
+
+void UQuestManager::OnKnowledgeBitChanged(int32 Bit, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    if (KnowledgeDependents.IsValidIndex(Bit))
+    {
+        RefreshPrerequisiteSlots(KnowledgeDependents[Bit], Worklist, OutChangedQuests);
+    }
+}
+
+void UQuestManager::RefreshAllPrerequisites(TArray<FName>& OutChangedQuests)
+{
+    TArray<int32> AllSlots;
+    AllSlots.Reserve(PrerequisiteSlots.Num());
+    for (int32 SlotIndex = 0; SlotIndex < PrerequisiteSlots.Num(); ++SlotIndex)
+    {
+        AllSlots.Add(SlotIndex);
+    }
+    
+    TArray<int32> Worklist;
+    RefreshPrerequisiteSlots(AllSlots, Worklist, OutChangedQuests);
+    PropagateQuestStateChanges(Worklist, OutChangedQuests);
+}
+
+UQuestManager::FObjectiveTriggerKey UQuestManager::MakeTriggerKey(EObjectiveTriggerType TriggerType, FName Target, int32 Hour)
+{
+    // Only time triggers are keyed by hour, and they ignore the target
+    FObjectiveTriggerKey Key;
+    Key.Type = TriggerType;
+    Key.Target = TriggerType == EObjectiveTriggerType::TimeReached ? NAME_None : Target;
+    Key.Hour = TriggerType == EObjectiveTriggerType::TimeReached ? Hour : 0;
+    return Key;
+}
+
+void UQuestManager::RegisterObjectiveTriggers(int32 QuestIndex)
+{
+    const TArray<FQuestObjective>& Objectives = Quests[QuestIndex].Objectives;
+    for (int32 ObjectiveIndex = 0; ObjectiveIndex < Objectives.Num(); ++ObjectiveIndex)
+    {
+        const FQuestObjective& Objective = Objectives[ObjectiveIndex];
+        if (Objective.TriggerType != EObjectiveTriggerType::None)
+        {
+            ObjectiveTriggers.FindOrAdd(MakeTriggerKey(Objective.TriggerType, Objective.TriggerTarget, Objective.TriggerHour))
+                .Add(FObjectiveRef{ QuestIndex, ObjectiveIndex });
+        }
+    }
+}
+
+void UQuestManager::UnregisterObjectiveTriggers(int32 QuestIndex)
+{
+    for (const FQuestObjective& Objective : Quests[QuestIndex].Objectives)
+    {
+        if (Objective.TriggerType == EObjectiveTriggerType::None)
+        {
+            continue;
+        }
+        
+        const FObjectiveTriggerKey Key = MakeTriggerKey(Objective.TriggerType, Objective.TriggerTarget, Objective.TriggerHour);
+        if (TArray<FObjectiveRef>* Waiting = ObjectiveTriggers.Find(Key))
+        {
+            Waiting->RemoveAllSwap([QuestIndex](const FObjectiveRef& Ref) { return Ref.QuestIndex == QuestIndex; });
+            if (Waiting->Num() == 0)
+            {
+                ObjectiveTriggers.Remove(Key);
+            }
+        }
+    }
+}
+
+bool UQuestManager::CompleteObjectiveInternal(int32 QuestIndex, int32 ObjectiveIndex, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests)
+{
+    FQuest& Quest = Quests[QuestIndex];
+    FQuestObjective& Objective = Quest.Objectives[ObjectiveIndex];
+    
+    // Mark it as completed; the flag on the objective mirrors the bit for Blueprint copies
+    const bool bWasCompleted = !ObjectiveProgress[QuestIndex].MarkCompleted(ObjectiveIndex);
+    Objective.bCompleted = true;
+    MarkQuestDirty(QuestIndex);
+    
+    UE_LOG(LogTemp, Warning, TEXT("Quest Manager: Completed objective %s for quest %s"), 
+        *Objective.ObjectiveId.ToString(), *Quest.QuestId.ToString());
+    
+    if (!bWasCompleted)
+    {
+        OnObjectiveCompleted.Broadcast(Quest.QuestId, Objective.ObjectiveId);
+    }
+    
+    // Check if all objectives are now completed
+    if (ObjectiveProgress[QuestIndex].AreAllCompleted() && Quest.State != EQuestState::Completed)
+    {
+        // Auto-complete quest
+        SetQuestStateInternal(QuestIndex, EQuestState::Completed, Worklist, OutChangedQuests);
+        
+        UE_LOG(LogTemp, Warning, TEXT("Quest Manager: All objectives completed, quest %s marked as completed"), 
+            *Quest.QuestId.ToString());
+        return true;
+    }
+    
+    return false;
+}
+
+int32 UQuestManager::FindObjectiveIndex(int32 QuestIndex, FName ObjectiveId) const
+{
+    const int32* ObjectiveIndex = ObjectiveIndices.Find(TPair<int32, FName>(QuestIndex, ObjectiveId));
+    return ObjectiveIndex ? *ObjectiveIndex : INDEX_NONE;
+}
+
+void UQuestManager::RegisterObjectives(int32 QuestIndex)
+{
+    const TArray<FQuestObjective>& Objectives = Quests[QuestIndex].Objectives;
+    
+    FObjectiveProgress Progress;
+    Progress.NumObjectives = Objectives.Num();
+    Progress.Words.SetNumZeroed((Objectives.Num() + 63) / 64);
+    
+    for (int32 ObjectiveIndex = 0; ObjectiveIndex < Objectives.Num(); ++ObjectiveIndex)
+    {
+        ObjectiveIndices.Add(TPair<int32, FName>(QuestIndex, Objectives[ObjectiveIndex].ObjectiveId), ObjectiveIndex);
+        if (Objectives[ObjectiveIndex].bCompleted)
+        {
+            Progress.MarkCompleted(ObjectiveIndex);
+        }
+    }
+    
+    ObjectiveProgress[QuestIndex] = MoveTemp(Progress);
+}
+
+void UQuestManager::UnregisterObjectives(int32 QuestIndex)
+{
+    for (const FQuestObjective& Objective : Quests[QuestIndex].Objectives)
+    {
+        ObjectiveIndices.Remove(TPair<int32, FName>(QuestIndex, Objective.ObjectiveId));
+    }
+}
+
+void UQuestManager::SetObjectiveProgress(int32 QuestIndex, const FObjectiveProgress& Progress)
+{
+    TArray<FQuestObjective>& Objectives = Quests[QuestIndex].Objectives;
+    if (Progress.NumObjectives != Objectives.Num())
+    {
+        return;
+    }
+    
+    ObjectiveProgress[QuestIndex] = Progress;
+    for (int32 ObjectiveIndex = 0; ObjectiveIndex < Objectives.Num(); ++ObjectiveIndex)
+    {
+        Objectives[ObjectiveIndex].bCompleted = Progress.IsCompleted(ObjectiveIndex);
+    }
+}
+
+uint32 UQuestManager::GetObjectiveLayoutHash(const FQuest& Quest)
+{
+    uint32 Hash = 0;
+    for (const FQuestObjective& Objective : Quest.Objectives)
+    {
+        // Hash the text, not the FName index, which differs between sessions
+        Hash = HashCombine(Hash, GetTypeHash(Objective.ObjectiveId.ToString()));
+    }
+    return Hash;
+}
@@ -17,10 +17,16 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Systems/QuestSystem/KnowledgeFlagRegistry.h"
 #include "QuestManager.generated.h"
 
 class UTimeLoopSaveGame;
 
+// Delegates for batched quest system changes
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FKnowledgeFlagsChangedDelegate, const TArray<FName>&, ChangedFlags);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FQuestStatesChangedDelegate, const TArray<FName>&, ChangedQuests);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FObjectiveCompletedDelegate, FName, QuestId, FName, ObjectiveId);
+
 /**
  * EQuestState - Represents the possible states of a quest
  */
@@ -47,6 +53,70 @@ enum class EQuestType : uint8
     TimeLoop UMETA(DisplayName = "Time Loop")
 };
 
+/**
+ * EQuestPrerequisiteType - What a quest prerequisite depends on
+ */
+UENUM(BlueprintType)
+enum class EQuestPrerequisiteType : uint8
+{
+    QuestState UMETA(DisplayName = "Quest State"),
+    KnowledgeFlag UMETA(DisplayName = "Knowledge Flag"),
+    MinLoopCount UMETA(DisplayName = "Minimum Loop Count")
+};
+
+/**
+ * FQuestPrerequisite - A condition that must hold before a quest becomes available
+ */
+USTRUCT(BlueprintType)
+struct FQuestPrerequisite
+{
+    GENERATED_BODY()
+
+    // What this prerequisite depends on
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    EQuestPrerequisiteType Type;
+
+    // Quest whose state is required (QuestState)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    FName QuestId;
+
+    // State the required quest must be in (QuestState)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    EQuestState RequiredState;
+
+    // Flag the player must know (KnowledgeFlag)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    FName KnowledgeFlag;
+
+    // Loop the player must have reached (MinLoopCount)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    int32 MinLoopCount;
+
+    // Constructor
+    FQuestPrerequisite()
+        : Type(EQuestPrerequisiteType::QuestState)
+        , QuestId(NAME_None)
+        , RequiredState(EQuestState::Completed)
+        , KnowledgeFlag(NAME_None)
+        , MinLoopCount(1)
+    {
+    }
+};
+
+/**
+ * EObjectiveTriggerType - Gameplay events that can complete an objective on their own
+ */
+UENUM(BlueprintType)
+enum class EObjectiveTriggerType : uint8
+{
+    None UMETA(DisplayName = "None"),
+    ItemAcquired UMETA(DisplayName = "Item Acquired"),
+    NPCInteracted UMETA(DisplayName = "NPC Interacted"),
+    LocationReached UMETA(DisplayName = "Location Reached"),
+    KnowledgeLearned UMETA(DisplayName = "Knowledge Learned"),
+    TimeReached UMETA(DisplayName = "Time Reached")
+};
+
 /**
  * FQuestObjective - Represents a single objective within a quest
  */
@@ -67,10 +137,25 @@ struct FQuestObjective
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
     bool bCompleted;
 
+    // Event that completes this objective while its quest is in progress
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    EObjectiveTriggerType TriggerType;
+
+    // Item, NPC, location or knowledge flag the trigger waits for
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    FName TriggerTarget;
+
+    // Hour the trigger waits for (TimeReached)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    int32 TriggerHour;
+
     // Constructor
     FQuestObjective()
         : ObjectiveId(NAME_None)
         , bCompleted(false)
+        , TriggerType(EObjectiveTriggerType::None)
+        , TriggerTarget(NAME_None)
+        , TriggerHour(0)
     {
     }
 
@@ -79,6 +164,9 @@ struct FQuestObjective
         : ObjectiveId(InObjectiveId)
         , Description(InDescription)
         , bCompleted(false)
+        , TriggerType(EObjectiveTriggerType::None)
+        , TriggerTarget(NAME_None)
+        , TriggerHour(0)
     {
     }
 };
@@ -123,6 +211,10 @@ struct FQuest
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
     bool bPersistAcrossLoops;
 
+    // Conditions that make this quest available once all of them hold
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+    TArray<FQuestPrerequisite> Prerequisites;
+
     // Constructor
     FQuest()
         : QuestId(NAME_None)
@@ -146,6 +238,59 @@ struct FQuest
     }
 };
 
+/**
+ * FQuestStateLink - Links a quest into the intrusive list of its current state
+ */
+struct FQuestStateLink
+{
+    int32 Prev = INDEX_NONE;
+    int32 Next = INDEX_NONE;
+};
+
+/**
+ * FQuestStateView - Allocation-free view over the quests currently in one state
+ * Iterate with a range-based for; the view is invalidated by the next quest state change
+ */
+class FQuestStateView
+{
+public:
+    class FIterator
+    {
+    public:
+        FIterator(const TArray<FQuest>& InQuests, const TArray<FQuestStateLink>& InLinks, int32 InIndex)
+            : Quests(InQuests), Links(InLinks), Index(InIndex)
+        {
+        }
+
+        const FQuest& operator*() const { return Quests[Index]; }
+        const FQuest* operator->() const { return &Quests[Index]; }
+        FIterator& operator++() { Index = Links[Index].Next; return *this; }
+        bool operator!=(const FIterator& Other) const { return Index != Other.Index; }
+
+    private:
+        const TArray<FQuest>& Quests;
+        const TArray<FQuestStateLink>& Links;
+        int32 Index;
+    };
+
+    FQuestStateView(const TArray<FQuest>& InQuests, const TArray<FQuestStateLink>& InLinks, int32 InHead, int32 InNum)
+        : Quests(InQuests), Links(InLinks), Head(InHead), NumQuests(InNum)
+    {
+    }
+
+    FIterator begin() const { return FIterator(Quests, Links, Head); }
+    FIterator end() const { return FIterator(Quests, Links, INDEX_NONE); }
+
+    int32 Num() const { return NumQuests; }
+    bool IsEmpty() const { return NumQuests == 0; }
+
+private:
+    const TArray<FQuest>& Quests;
+    const TArray<FQuestStateLink>& Links;
+    int32 Head;
+    int32 NumQuests;
+};
+
 /**
  * UQuestManager - Manages quests and player knowledge
  */
@@ -176,22 +321,48 @@ public:
     UFUNCTION(BlueprintPure, Category = "Quest System")
     bool IsObjectiveCompleted(FName QuestId, FName ObjectiveId) const;
 
+    // Check if every objective of a quest is completed
+    UFUNCTION(BlueprintPure, Category = "Quest System")
+    bool AreAllObjectivesCompletedForQuest(FName QuestId) const;
+
     // Get a quest by ID
     UFUNCTION(BlueprintPure, Category = "Quest System")
     FQuest GetQuest(FName QuestId) const;
 
-    // Get all active quests
+    // Find a quest by ID without copying it; null if there is no such quest
+    const FQuest* FindQuest(FName QuestId) const;
+
+    // View the quests currently in a state, in the order they entered it
+    FQuestStateView GetQuestsInState(EQuestState State) const;
+
+    // Get the number of quests currently in a state
+    UFUNCTION(BlueprintPure, Category = "Quest System")
+    int32 GetQuestCountInState(EQuestState State) const;
+
+    // Fill an array with the IDs of the quests in a state, reusing its allocation
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    void GetQuestIdsInState(EQuestState State, TArray<FName>& OutQuestIds) const;
+
+    // Get copies of all active quests; prefer GetQuestsInState for per-frame polling
     UFUNCTION(BlueprintPure, Category = "Quest System")
     TArray<FQuest> GetActiveQuests() const;
 
-    // Get all completed quests
+    // Get copies of all completed quests; prefer GetQuestsInState for per-frame polling
     UFUNCTION(BlueprintPure, Category = "Quest System")
     TArray<FQuest> GetCompletedQuests() const;
 
-    // Reset quests for a new day/loop
+    // Reset quests for a new day/loop, touching only quests that changed since the loop started
     UFUNCTION(BlueprintCallable, Category = "Quest System")
     void ResetQuestsForNewDay();
 
+    // Fill an array with the IDs of quests whose state or objectives changed this loop
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    void GetQuestsChangedThisLoop(TArray<FName>& OutQuestIds) const;
+
+    // Check if a quest's state or objectives changed this loop
+    UFUNCTION(BlueprintPure, Category = "Quest System")
+    bool WasQuestChangedThisLoop(FName QuestId) const;
+
     // Set a knowledge flag for the player
     UFUNCTION(BlueprintCallable, Category = "Quest System")
     void SetKnowledgeFlag(FName FlagName, bool bValue = true);
@@ -200,26 +371,291 @@ public:
     UFUNCTION(BlueprintPure, Category = "Quest System")
     bool HasKnowledgeFlag(FName FlagName) const;
 
+    // Check a knowledge flag by its registry bit
+    bool HasKnowledgeBit(int32 Bit) const { return KnowledgeBits.Contains(Bit); }
+
+    // Get the player's knowledge as a packed bitset
+    const FKnowledgeBits& GetKnowledgeBits() const { return KnowledgeBits; }
+
+    // Set several knowledge flags at once with a single change notification
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    void SetKnowledgeFlags(const TArray<FName>& FlagNames);
+
+    // Make several unavailable quests available with a single change notification
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    void MakeQuestsAvailable(const TArray<FName>& QuestIds);
+
+    // Set the current loop, re-checking only quests gated on loop counts in between
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    void SetLoopCount(int32 NewLoopCount);
+
+    // Check if every prerequisite of a quest currently holds
+    UFUNCTION(BlueprintPure, Category = "Quest System")
+    bool ArePrerequisitesMet(FName QuestId) const;
+
+    // Check the prerequisite graph for cycles, returning the quests that can never become available
+    UFUNCTION(BlueprintCallable, Category = "Quest System")
+    TArray<FName> FindPrerequisiteCycles() const;
+
+    // Complete every in-progress objective waiting on a gameplay event
+    UFUNCTION(BlueprintCallable, Category = "Quest System|Triggers")
+    void NotifyObjectiveEvent(EObjectiveTriggerType TriggerType, FName Target, int32 Hour = 0);
+
+    // Report that the player acquired an item
+    UFUNCTION(BlueprintCallable, Category = "Quest System|Triggers")
+    void NotifyItemAcquired(FName ItemID, int32 Count);
+
+    // Report that the player interacted with an NPC
+    UFUNCTION(BlueprintCallable, Category = "Quest System|Triggers")
+    void NotifyNPCInteracted(FName NPCId);
+
+    // Report that the player reached a location
+    UFUNCTION(BlueprintCallable, Category = "Quest System|Triggers")
+    void NotifyLocationReached(FName LocationId);
+
+    // Report that the clock reached an hour
+    UFUNCTION(BlueprintCallable, Category = "Quest System|Triggers")
+    void NotifyHourReached(int32 Hour);
+
     // Save player knowledge to save game
     void SavePlayerKnowledge(UTimeLoopSaveGame* SaveGame);
 
     // Load player knowledge from save game
     void LoadPlayerKnowledge(UTimeLoopSaveGame* SaveGame);
 
+public:
+    // Delegate fired with the flags that became set by a call
+    UPROPERTY(BlueprintAssignable, Category = "Quest System|Events")
+    FKnowledgeFlagsChangedDelegate OnKnowledgeFlagsChanged;
+
+    // Delegate fired with the quests whose state changed in a call
+    UPROPERTY(BlueprintAssignable, Category = "Quest System|Events")
+    FQuestStatesChangedDelegate OnQuestStatesChanged;
+
+    // Delegate fired when an objective is completed
+    UPROPERTY(BlueprintAssignable, Category = "Quest System|Events")
+    FObjectiveCompletedDelegate OnObjectiveCompleted;
+
 protected:
-    // All quests in the game
+    // All quests in the game, addressed through QuestIndices
     UPROPERTY()
-    TMap<FName, FQuest> Quests;
+    TArray<FQuest> Quests;
 
-    // Player knowledge flags
-    UPROPERTY()
-    TMap<FName, bool> KnowledgeFlags;
+    // Index of each quest in Quests
+    TMap<FName, int32> QuestIndices;
+
+    // Player knowledge flags, indexed by FKnowledgeFlagRegistry bit
+    FKnowledgeBits KnowledgeBits;
 
     // Progress values that persist across loops
     UPROPERTY()
     TMap<FName, int32> PersistentProgress;
 
+    // Current loop, used by MinLoopCount prerequisites
+    int32 LoopCount;
+
 private:
-    // Check if a quest's objectives are all complete
-    bool AreAllObjectivesCompleted(const FQuest& Quest) const;
+    /** One registered prerequisite and whether it currently holds */
+    struct FPrerequisiteSlot
+    {
+        // Quest this prerequisite gates, INDEX_NONE once the quest was replaced
+        int32 QuestIndex;
+
+        // Index into the quest's Prerequisites
+        int32 PrerequisiteIndex;
+
+        // Registry bit of a knowledge flag prerequisite, resolved once at registration
+        int32 KnowledgeBit;
+
+        bool bMet;
+    };
+
+    /** Prerequisite bookkeeping kept alongside each quest */
+    struct FQuestPrerequisiteState
+    {
+        // This quest's range in PrerequisiteSlots
+        int32 FirstSlot = 0;
+        int32 NumSlots = 0;
+
+        int32 NumUnmet = 0;
+    };
+
+    /** A quest's objective completion, one bit per objective in Objectives order */
+    struct FObjectiveProgress
+    {
+        TArray<uint64, TInlineAllocator<1>> Words;
+        int32 NumCompleted = 0;
+        int32 NumObjectives = 0;
+
+        bool IsCompleted(int32 ObjectiveIndex) const
+        {
+            return (Words[ObjectiveIndex >> 6] & ((uint64)1 << (ObjectiveIndex & 63))) != 0;
+        }
+
+        // Set a bit, returning false if it was already set
+        bool MarkCompleted(int32 ObjectiveIndex)
+        {
+            uint64& Word = Words[ObjectiveIndex >> 6];
+            const uint64 Mask = (uint64)1 << (ObjectiveIndex & 63);
+            if (Word & Mask)
+            {
+                return false;
+            }
+            Word |= Mask;
+            ++NumCompleted;
+            return true;
+        }
+
+        // A quest with no objectives is never complete through them
+        bool AreAllCompleted() const
+        {
+            return NumCompleted == NumObjectives && NumObjectives > 0;
+        }
+    };
+
+    /** A quest's runtime state as it stood when the current loop started */
+    struct FQuestBaseline
+    {
+        EQuestState State = EQuestState::Unavailable;
+        FObjectiveProgress Objectives;
+    };
+
+    /** Key of the objective trigger index: what happened, to what, and when */
+    struct FObjectiveTriggerKey
+    {
+        EObjectiveTriggerType Type;
+        FName Target;
+        int32 Hour;
+
+        bool operator==(const FObjectiveTriggerKey& Other) const
+        {
+            return Type == Other.Type && Target == Other.Target && Hour == Other.Hour;
+        }
+
+        friend uint32 GetTypeHash(const FObjectiveTriggerKey& Key)
+        {
+            return HashCombine(HashCombine(::GetTypeHash(static_cast<uint8>(Key.Type)), GetTypeHash(Key.Target)), ::GetTypeHash(Key.Hour));
+        }
+    };
+
+    /** An objective waiting on a trigger */
+    struct FObjectiveRef
+    {
+        int32 QuestIndex;
+        int32 ObjectiveIndex;
+    };
+
+    /** A loop count prerequisite slot keyed by its threshold */
+    struct FLoopCountSlot
+    {
+        int32 MinLoopCount;
+        int32 SlotIndex;
+    };
+
+    // Register a quest's prerequisites and index them by what they depend on
+    void RegisterPrerequisites(int32 QuestIndex);
+
+    // Check one prerequisite slot against the current state
+    bool EvaluatePrerequisite(const FPrerequisiteSlot& Slot) const;
+
+    // Re-check a set of prerequisite slots, queueing quests whose availability changed
+    void RefreshPrerequisiteSlots(const TArray<int32>& SlotIndices, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Add a quest to the tail of its state's list, or take it out
+    void LinkQuestState(int32 QuestIndex);
+    void UnlinkQuestState(int32 QuestIndex);
+
+    // Move a gated quest between Unavailable and Available to match its prerequisites
+    bool ApplyPrerequisiteGate(int32 QuestIndex);
+
+    // Record that a quest differs from its baseline this loop
+    void MarkQuestDirty(int32 QuestIndex);
+
+    // Make a quest's current runtime state its baseline
+    void CaptureBaseline(int32 QuestIndex);
+
+    // Change a quest's state and queue it so dependent quests are re-checked
+    void SetQuestStateInternal(int32 QuestIndex, EQuestState NewState, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Propagate queued quest state changes to dependents until nothing else changes
+    void PropagateQuestStateChanges(TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Re-check prerequisites depending on a quest's state
+    void OnQuestStateChanged(int32 QuestIndex, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Re-check prerequisites depending on a knowledge bit
+    void OnKnowledgeBitChanged(int32 Bit, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Re-check every prerequisite, used after bulk loads
+    void RefreshAllPrerequisites(TArray<FName>& OutChangedQuests);
+
+    // Build the trigger index key for an objective, or for an incoming event
+    static FObjectiveTriggerKey MakeTriggerKey(EObjectiveTriggerType TriggerType, FName Target, int32 Hour);
+
+    // Add or remove a quest's objectives in the trigger index
+    void RegisterObjectiveTriggers(int32 QuestIndex);
+    void UnregisterObjectiveTriggers(int32 QuestIndex);
+
+    // Complete one objective, completing the quest when it was the last
+    bool CompleteObjectiveInternal(int32 QuestIndex, int32 ObjectiveIndex, TArray<int32>& Worklist, TArray<FName>& OutChangedQuests);
+
+    // Resolve an objective ID to its index in the quest's Objectives, or INDEX_NONE
+    int32 FindObjectiveIndex(int32 QuestIndex, FName ObjectiveId) const;
+
+    // Add or remove a quest's objectives in the objective index, and build its progress bits
+    void RegisterObjectives(int32 QuestIndex);
+    void UnregisterObjectives(int32 QuestIndex);
+
+    // Replace a quest's objective progress, mirroring it into the objectives' bCompleted
+    void SetObjectiveProgress(int32 QuestIndex, const FObjectiveProgress& Progress);
+
+    // Hash of a quest's objective IDs, to check saved progress bits still line up
+    static uint32 GetObjectiveLayoutHash(const FQuest& Quest);
+
+    // Number of EQuestState values
+    static constexpr int32 NumQuestStates = static_cast<int32>(EQuestState::Failed) + 1;
+
+    // State list links for each entry in Quests
+    TArray<FQuestStateLink> StateLinks;
+
+    // First and last quest in each state's list, and how many it holds
+    int32 StateHeads[NumQuestStates];
+    int32 StateTails[NumQuestStates];
+    int32 StateCounts[NumQuestStates];
+
+    // Loop-start state for each entry in Quests
+    TArray<FQuestBaseline> Baselines;
+
+    // Loop generation in which each quest was last marked dirty
+    TArray<uint32> DirtyGenerations;
+
+    // Quests changed since the loop started, in the order they first changed
+    TArray<int32> DirtyQuests;
+
+    // Bumped on every reset so old dirty marks expire without being cleared
+    uint32 LoopGeneration;
+
+    // Prerequisite state for each entry in Quests
+    TArray<FQuestPrerequisiteState> PrerequisiteStates;
+
+    // Every registered prerequisite
+    TArray<FPrerequisiteSlot> PrerequisiteSlots;
+
+    // Prerequisite slots depending on each quest's state, keyed by the quest they watch
+    TMap<FName, TArray<int32>> QuestStateDependents;
+
+    // Prerequisite slots depending on each knowledge bit, indexed by bit
+    TArray<TArray<int32>> KnowledgeDependents;
+
+    // Loop count prerequisite slots sorted by MinLoopCount
+    TArray<FLoopCountSlot> LoopCountSlots;
+
+    // Objectives waiting on each trigger
+    TMap<FObjectiveTriggerKey, TArray<FObjectiveRef>> ObjectiveTriggers;
+
+    // Objective completion for each entry in Quests
+    TArray<FObjectiveProgress> ObjectiveProgress;
+
+    // Index of each objective in its quest's Objectives, keyed by (quest index, objective ID)
+    TMap<TPair<int32, FName>, int32> ObjectiveIndices;
 };
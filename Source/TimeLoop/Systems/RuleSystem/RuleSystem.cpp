@@ -0,0 +1,519 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "RuleSystem.h"
+#include "Systems/TimeSystem/TimeManager.h"
+#include "Systems/CharacterSystem/NPCScheduler.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Components/InventoryComponent.h"
+
+namespace RuleFacts
+{
+    const FName Hour(TEXT("Time.Hour"));
+    const FName TimeOfDay(TEXT("Time.OfDay"));
+    const FName Loop(TEXT("Time.Loop"));
+    const FName Weather(TEXT("Weather"));
+}
+
+URuleSystem::URuleSystem()
+    : TimeManager(nullptr)
+    , NPCScheduler(nullptr)
+    , QuestManager(nullptr)
+    , bFlushingRuleChanges(false)
+{
+    // The root beta node matches before any condition is joined
+    FBetaNode& Root = BetaNodes.AddDefaulted_GetRef();
+    Root.bMatched = true;
+}
+
+void URuleSystem::Initialize(UTimeManager* InTimeManager, UNPCScheduler* InNPCScheduler, UQuestManager* InQuestManager)
+{
+    TimeManager = InTimeManager;
+    NPCScheduler = InNPCScheduler;
+    QuestManager = InQuestManager;
+    
+    if (TimeManager)
+    {
+        TimeManager->OnHourChanged.AddDynamic(this, &URuleSystem::OnHourChanged);
+        TimeManager->OnTimeOfDayChanged.AddDynamic(this, &URuleSystem::OnTimeOfDayChanged);
+        SetIntFact(RuleFacts::Hour, TimeManager->GetCurrentHour());
+        SetIntFact(RuleFacts::TimeOfDay, (int32)TimeManager->GetTimeOfDay());
+        SetIntFact(RuleFacts::Loop, TimeManager->GetLoopCount());
+    }
+    
+    if (NPCScheduler)
+    {
+        NPCScheduler->OnNPCLocationChanged.AddDynamic(this, &URuleSystem::OnNPCLocationChanged);
+    }
+    
+    if (QuestManager)
+    {
+        QuestManager->OnKnowledgeFlagsChanged.AddDynamic(this, &URuleSystem::OnKnowledgeFlagsChanged);
+    }
+    
+    UE_LOG(LogTemp, Warning, TEXT("Rule System: Initialized"));
+}
+
+FName URuleSystem::MakeKnowledgeFactKey(FName FlagName)
+{
+    return FName(*FString::Printf(TEXT("Knowledge.%s"), *FlagName.ToString()));
+}
+
+FName URuleSystem::MakeNPCLocationFactKey(FName NPCId)
+{
+    return FName(*FString::Printf(TEXT("NPC.%s.Location"), *NPCId.ToString()));
+}
+
+FName URuleSystem::MakeItemFactKey(FName ItemID)
+{
+    return FName(*FString::Printf(TEXT("Item.%s"), *ItemID.ToString()));
+}
+
+bool URuleSystem::TestCondition(const FRuleCondition& Condition, const FFact& Fact)
+{
+    if (Condition.NameValue != NAME_None)
+    {
+        const bool bEqual = Fact.NameValue == Condition.NameValue;
+        return Condition.Comparison == ERuleComparison::NotEqual ? !bEqual : bEqual;
+    }
+    
+    switch (Condition.Comparison)
+    {
+        case ERuleComparison::Equal:
+            return Fact.IntValue == Condition.IntValue;
+        case ERuleComparison::NotEqual:
+            return Fact.IntValue != Condition.IntValue;
+        case ERuleComparison::Less:
+            return Fact.IntValue < Condition.IntValue;
+        case ERuleComparison::LessOrEqual:
+            return Fact.IntValue <= Condition.IntValue;
+        case ERuleComparison::Greater:
+            return Fact.IntValue > Condition.IntValue;
+        case ERuleComparison::GreaterOrEqual:
+            return Fact.IntValue >= Condition.IntValue;
+        default:
+            return false;
+    }
+}
+
+int32 URuleSystem::FindOrAddAlphaNode(const FRuleCondition& Condition)
+{
+    // Name conditions ignore the integer operand, so it is left out of their key
+    const FString Key = Condition.NameValue != NAME_None
+        ? FString::Printf(TEXT("%s|%d|n|%s"), *Condition.FactKey.ToString(), (int32)Condition.Comparison, *Condition.NameValue.ToString())
+        : FString::Printf(TEXT("%s|%d|i|%d"), *Condition.FactKey.ToString(), (int32)Condition.Comparison, Condition.IntValue);
+    
+    if (const int32* Existing = AlphaNodeIndices.Find(Key))
+    {
+        return *Existing;
+    }
+    
+    if (!FactAlphaNodes.Contains(Condition.FactKey))
+    {
+        BindFactSource(Condition.FactKey);
+    }
+    
+    const FFact* Fact = Facts.Find(Condition.FactKey);
+    
+    const int32 AlphaIndex = AlphaNodes.AddDefaulted();
+    FAlphaNode& Alpha = AlphaNodes[AlphaIndex];
+    Alpha.Condition = Condition;
+    Alpha.bSatisfied = TestCondition(Condition, Fact ? *Fact : FFact());
+    
+    AlphaNodeIndices.Add(Key, AlphaIndex);
+    FactAlphaNodes.FindOrAdd(Condition.FactKey).Add(AlphaIndex);
+    return AlphaIndex;
+}
+
+void URuleSystem::BindFactSource(FName FactKey)
+{
+    // Knowledge and NPC facts otherwise only arrive with the next change event;
+    // item facts need nothing, since SyncItemCounts always pushes the whole inventory
+    static const FString KnowledgePrefix(TEXT("Knowledge."));
+    static const FString NPCPrefix(TEXT("NPC."));
+    static const FString LocationSuffix(TEXT(".Location"));
+    
+    const FString Key = FactKey.ToString();
+    if (Key.StartsWith(KnowledgePrefix, ESearchCase::CaseSensitive))
+    {
+        const FName FlagName(*Key.RightChop(KnowledgePrefix.Len()));
+        KnowledgeFactFlags.Add(FactKey, FlagName);
+        if (QuestManager && !Facts.Contains(FactKey))
+        {
+            Facts.Add(FactKey).IntValue = QuestManager->HasKnowledgeFlag(FlagName) ? 1 : 0;
+        }
+    }
+    else if (NPCScheduler && Key.StartsWith(NPCPrefix, ESearchCase::CaseSensitive) && Key.EndsWith(LocationSuffix, ESearchCase::CaseSensitive)
+        && !Facts.Contains(FactKey))
+    {
+        const FName NPCId(*Key.Mid(NPCPrefix.Len(), Key.Len() - NPCPrefix.Len() - LocationSuffix.Len()));
+        Facts.Add(FactKey).NameValue = NPCScheduler->GetNPCLocation(NPCId);
+    }
+}
+
+int32 URuleSystem::FindOrAddBetaNode(int32 Parent, int32 Alpha)
+{
+    const uint64 Key = ((uint64)(uint32)Parent << 32) | (uint32)Alpha;
+    if (const int32* Existing = BetaNodeIndices.Find(Key))
+    {
+        return *Existing;
+    }
+    
+    const int32 BetaIndex = BetaNodes.AddDefaulted();
+    FBetaNode& Beta = BetaNodes[BetaIndex];
+    Beta.Parent = Parent;
+    Beta.Alpha = Alpha;
+    Beta.bMatched = BetaNodes[Parent].bMatched && AlphaNodes[Alpha].bSatisfied;
+    
+    BetaNodes[Parent].Children.Add(BetaIndex);
+    AlphaNodes[Alpha].Successors.Add(BetaIndex);
+    BetaNodeIndices.Add(Key, BetaIndex);
+    return BetaIndex;
+}
+
+void URuleSystem::AddRule(const FGameRule& Rule)
+{
+    if (Rule.RuleId == NAME_None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Rule System: Ignoring rule without an ID"));
+        return;
+    }
+    
+    RemoveRule(Rule.RuleId);
+    
+    // Sorting the alpha nodes gives rules with common conditions common join prefixes
+    TArray<int32> AlphaIndices;
+    for (const FRuleCondition& Condition : Rule.Conditions)
+    {
+        AlphaIndices.AddUnique(FindOrAddAlphaNode(Condition));
+    }
+    AlphaIndices.Sort();
+    
+    int32 Terminal = 0;
+    for (int32 AlphaIndex : AlphaIndices)
+    {
+        Terminal = FindOrAddBetaNode(Terminal, AlphaIndex);
+    }
+    
+    const int32 RuleIndex = Rules.AddDefaulted();
+    FRuleEntry& Entry = Rules[RuleIndex];
+    Entry.Rule = Rule;
+    Entry.Terminal = Terminal;
+    BetaNodes[Terminal].Rules.Add(RuleIndex);
+    RuleIndices.Add(Rule.RuleId, RuleIndex);
+    
+    // A rule that already holds activates as it is added
+    if (BetaNodes[Terminal].bMatched)
+    {
+        QueueRuleChange(RuleIndex, true);
+        FlushRuleChanges();
+    }
+}
+
+void URuleSystem::RemoveRule(FName RuleId)
+{
+    int32 RuleIndex = INDEX_NONE;
+    if (!RuleIndices.RemoveAndCopyValue(RuleId, RuleIndex))
+    {
+        return;
+    }
+    
+    // Shared nodes stay in the network for other and future rules
+    FRuleEntry& Entry = Rules[RuleIndex];
+    BetaNodes[Entry.Terminal].Rules.RemoveSingleSwap(RuleIndex);
+    Entry.bRemoved = true;
+    Entry.bActive = false;
+}
+
+bool URuleSystem::IsRuleActive(FName RuleId) const
+{
+    const int32* RuleIndex = RuleIndices.Find(RuleId);
+    return RuleIndex && Rules[*RuleIndex].bActive;
+}
+
+void URuleSystem::SetIntFact(FName FactKey, int32 Value)
+{
+    const FFact* Existing = Facts.Find(FactKey);
+    FFact Fact = Existing ? *Existing : FFact();
+    Fact.IntValue = Value;
+    UpdateFact(FactKey, Fact);
+}
+
+void URuleSystem::SetNameFact(FName FactKey, FName Value)
+{
+    const FFact* Existing = Facts.Find(FactKey);
+    FFact Fact = Existing ? *Existing : FFact();
+    Fact.NameValue = Value;
+    UpdateFact(FactKey, Fact);
+}
+
+int32 URuleSystem::GetIntFact(FName FactKey) const
+{
+    const FFact* Fact = Facts.Find(FactKey);
+    return Fact ? Fact->IntValue : 0;
+}
+
+FName URuleSystem::GetNameFact(FName FactKey) const
+{
+    const FFact* Fact = Facts.Find(FactKey);
+    return Fact ? Fact->NameValue : NAME_None;
+}
+
+void URuleSystem::SetWeather(uint8 WeatherCondition)
+{
+    SetIntFact(RuleFacts::Weather, WeatherCondition);
+}
+
+void URuleSystem::SyncItemCounts(const TMap<FName, int32>& ItemCounts)
+{
+    // Items that left the inventory fall back to zero
+    TArray<FName> DroppedItems;
+    for (const FName& ItemID : HeldItems)
+    {
+        if (!ItemCounts.Contains(ItemID))
+        {
+            DroppedItems.Add(ItemID);
+        }
+    }
+    for (const FName& ItemID : DroppedItems)
+    {
+        HeldItems.Remove(ItemID);
+        SetIntFact(MakeItemFactKey(ItemID), 0);
+    }
+    
+    for (const TPair<FName, int32>& Pair : ItemCounts)
+    {
+        HeldItems.Add(Pair.Key);
+        SetIntFact(MakeItemFactKey(Pair.Key), Pair.Value);
+    }
+}
+
+void URuleSystem::SyncInventory(const UInventoryComponent* Inventory)
+{
+    if (!Inventory)
+    {
+        return;
+    }
+    
+    TMap<FName, int32> ItemCounts;
+    for (const FInventoryItem& Item : Inventory->GetAllItems())
+    {
+        ItemCounts.FindOrAdd(Item.GetItemID()) += Item.StackCount;
+    }
+    SyncItemCounts(ItemCounts);
+}
+
+void URuleSystem::SyncKnowledgeFacts()
+{
+    if (!QuestManager)
+    {
+        return;
+    }
+    
+    // Copied, since rule actions may add rules while facts change
+    const TMap<FName, FName> FactFlags = KnowledgeFactFlags;
+    for (const TPair<FName, FName>& Pair : FactFlags)
+    {
+        SetIntFact(Pair.Key, QuestManager->HasKnowledgeFlag(Pair.Value) ? 1 : 0);
+    }
+}
+
+void URuleSystem::UpdateFact(FName FactKey, const FFact& Fact)
+{
+    FFact& Stored = Facts.FindOrAdd(FactKey);
+    if (Stored.IntValue == Fact.IntValue && Stored.NameValue == Fact.NameValue)
+    {
+        return;
+    }
+    Stored = Fact;
+    
+    const TArray<int32>* AlphaIndices = FactAlphaNodes.Find(FactKey);
+    if (!AlphaIndices)
+    {
+        return;
+    }
+    
+    // Settle every alpha test on the fact before joining, so no join sees a half-updated fact
+    for (int32 AlphaIndex : *AlphaIndices)
+    {
+        FAlphaNode& Alpha = AlphaNodes[AlphaIndex];
+        const bool bSatisfied = TestCondition(Alpha.Condition, Fact);
+        if (bSatisfied == Alpha.bSatisfied)
+        {
+            continue;
+        }
+        
+        Alpha.bSatisfied = bSatisfied;
+        for (int32 BetaIndex : Alpha.Successors)
+        {
+            QueueBetaNode(BetaIndex);
+        }
+    }
+    
+    PropagateBetaNodes();
+    FlushRuleChanges();
+}
+
+void URuleSystem::QueueBetaNode(int32 BetaIndex)
+{
+    FBetaNode& Beta = BetaNodes[BetaIndex];
+    if (!Beta.bQueued)
+    {
+        Beta.bQueued = true;
+        DirtyBetaNodes.HeapPush(BetaIndex);
+    }
+}
+
+void URuleSystem::PropagateBetaNodes()
+{
+    // Children are always created after their parents, so popping the lowest index
+    // first re-tests each node once, after every parent above it has settled
+    while (DirtyBetaNodes.Num() > 0)
+    {
+        int32 BetaIndex = INDEX_NONE;
+        DirtyBetaNodes.HeapPop(BetaIndex, false);
+        
+        FBetaNode& Beta = BetaNodes[BetaIndex];
+        Beta.bQueued = false;
+        const bool bMatched = BetaNodes[Beta.Parent].bMatched && AlphaNodes[Beta.Alpha].bSatisfied;
+        if (bMatched == Beta.bMatched)
+        {
+            continue;
+        }
+        
+        Beta.bMatched = bMatched;
+        for (int32 RuleIndex : Beta.Rules)
+        {
+            QueueRuleChange(RuleIndex, bMatched);
+        }
+        for (int32 ChildIndex : Beta.Children)
+        {
+            QueueBetaNode(ChildIndex);
+        }
+    }
+}
+
+void URuleSystem::QueueRuleChange(int32 RuleIndex, bool bMatched)
+{
+    PendingRuleChanges.Add(TPair<int32, bool>(RuleIndex, bMatched));
+}
+
+void URuleSystem::FlushRuleChanges()
+{
+    // Actions that change facts queue more changes, which the outer flush picks up
+    if (bFlushingRuleChanges)
+    {
+        return;
+    }
+    
+    TGuardValue<bool> FlushGuard(bFlushingRuleChanges, true);
+    for (int32 ChangeIndex = 0; ChangeIndex < PendingRuleChanges.Num(); ++ChangeIndex)
+    {
+        const TPair<int32, bool> Change = PendingRuleChanges[ChangeIndex];
+        FRuleEntry& Entry = Rules[Change.Key];
+        if (Entry.bRemoved || Entry.bActive == Change.Value)
+        {
+            continue;
+        }
+        
+        Entry.bActive = Change.Value;
+        if (Change.Value)
+        {
+            ActivateRule(Entry);
+        }
+        else
+        {
+            OnRuleDeactivated.Broadcast(Entry.Rule.RuleId);
+        }
+    }
+    PendingRuleChanges.Reset();
+}
+
+void URuleSystem::ActivateRule(FRuleEntry& Entry)
+{
+    if (Entry.bFiredThisLoop && !Entry.Rule.bRepeatable)
+    {
+        return;
+    }
+    Entry.bFiredThisLoop = true;
+    
+    // Copy what the actions need; listeners may add rules and move the entry
+    const FName RuleId = Entry.Rule.RuleId;
+    const TArray<FName> KnowledgeFlagsToSet = Entry.Rule.KnowledgeFlagsToSet;
+    const TArray<FName> QuestsToMakeAvailable = Entry.Rule.QuestsToMakeAvailable;
+    
+    if (QuestManager)
+    {
+        if (KnowledgeFlagsToSet.Num() > 0)
+        {
+            QuestManager->SetKnowledgeFlags(KnowledgeFlagsToSet);
+        }
+        if (QuestsToMakeAvailable.Num() > 0)
+        {
+            QuestManager->MakeQuestsAvailable(QuestsToMakeAvailable);
+        }
+    }
+    
+    OnRuleActivated.Broadcast(RuleId);
+}
+
+void URuleSystem::ResetForNewDay()
+{
+    if (TimeManager)
+    {
+        SetIntFact(RuleFacts::Hour, TimeManager->GetCurrentHour());
+        SetIntFact(RuleFacts::TimeOfDay, (int32)TimeManager->GetTimeOfDay());
+        SetIntFact(RuleFacts::Loop, TimeManager->GetLoopCount());
+    }
+    
+    // Rules still holding at the start of the loop activate again, since their effects were reset
+    for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
+    {
+        FRuleEntry& Entry = Rules[RuleIndex];
+        Entry.bFiredThisLoop = false;
+        if (!Entry.bRemoved && Entry.bActive)
+        {
+            Entry.bActive = false;
+            QueueRuleChange(RuleIndex, true);
+        }
+    }
+    FlushRuleChanges();
+}
+
+void URuleSystem::OnHourChanged(int32 NewHour)
+{
+    SetIntFact(RuleFacts::Hour, NewHour);
+}
+
+void URuleSystem::OnTimeOfDayChanged(FName NewTimeOfDay)
+{
+    if (TimeManager)
+    {
+        SetIntFact(RuleFacts::TimeOfDay, (int32)TimeManager->GetTimeOfDay());
+    }
+}
+
+void URuleSystem::OnNPCLocationChanged(FName NPCId, FName LocationId)
+{
+    SetNameFact(MakeNPCLocationFactKey(NPCId), LocationId);
+}
+
+void URuleSystem::OnKnowledgeFlagsChanged(const TArray<FName>& ChangedFlags)
+{
+    for (const FName& FlagName : ChangedFlags)
+    {
+        SetIntFact(MakeKnowledgeFactKey(FlagName), QuestManager && QuestManager->HasKnowledgeFlag(FlagName) ? 1 : 0);
+    }
+}
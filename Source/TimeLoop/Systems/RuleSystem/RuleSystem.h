@@ -0,0 +1,322 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "RuleSystem.generated.h"
+
+class UTimeManager;
+class UNPCScheduler;
+class UQuestManager;
+class UInventoryComponent;
+
+// Delegate for rules whose conditions start or stop holding
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRuleActivationDelegate, FName, RuleId);
+
+/**
+ * ERuleComparison - How a condition compares a fact against its operand
+ */
+UENUM(BlueprintType)
+enum class ERuleComparison : uint8
+{
+    Equal UMETA(DisplayName = "Equal"),
+    NotEqual UMETA(DisplayName = "Not Equal"),
+    Less UMETA(DisplayName = "Less"),
+    LessOrEqual UMETA(DisplayName = "Less Or Equal"),
+    Greater UMETA(DisplayName = "Greater"),
+    GreaterOrEqual UMETA(DisplayName = "Greater Or Equal")
+};
+
+/**
+ * FRuleCondition - A test against one fact
+ * Facts hold an integer and a name; a condition with a NameValue compares names
+ * (Equal or NotEqual only), otherwise it compares integers. Facts never set read as 0 and None.
+ */
+USTRUCT(BlueprintType)
+struct FRuleCondition
+{
+    GENERATED_BODY()
+
+    // Fact to test, e.g. Time.Hour, Weather, Knowledge.<Flag>, NPC.<Id>.Location, Item.<Id>
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    FName FactKey;
+
+    // How to compare the fact
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    ERuleComparison Comparison;
+
+    // Integer operand
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    int32 IntValue;
+
+    // Name operand, used instead of IntValue when set
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    FName NameValue;
+
+    // Constructor
+    FRuleCondition()
+        : FactKey(NAME_None)
+        , Comparison(ERuleComparison::Equal)
+        , IntValue(0)
+        , NameValue(NAME_None)
+    {
+    }
+};
+
+/**
+ * FGameRule - Actions to run when every condition holds
+ * Actions are edge-triggered: they run once when the conditions start holding and
+ * again only after the conditions have stopped holding in between.
+ */
+USTRUCT(BlueprintType)
+struct FGameRule
+{
+    GENERATED_BODY()
+
+    // Unique ID for this rule
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    FName RuleId;
+
+    // Conditions that must all hold
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    TArray<FRuleCondition> Conditions;
+
+    // Knowledge flags to set when the rule activates
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    TArray<FName> KnowledgeFlagsToSet;
+
+    // Quests to make available when the rule activates
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    TArray<FName> QuestsToMakeAvailable;
+
+    // Whether the rule may activate more than once per loop
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+    bool bRepeatable;
+
+    // Constructor
+    FGameRule()
+        : RuleId(NAME_None)
+        , bRepeatable(true)
+    {
+    }
+};
+
+/**
+ * URuleSystem - Evaluates authored rules against facts gathered from every game system
+ *
+ * Conditions compile into a Rete-style network. Identical conditions share one alpha
+ * node, and rules whose sorted conditions share a prefix share the beta (join) nodes
+ * for it, so a fact change only re-tests the alpha nodes on that fact and walks the
+ * beta nodes whose match actually flips. Nothing is re-evaluated per tick.
+ */
+UCLASS(Blueprintable)
+class TIMELOOP_API URuleSystem : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    URuleSystem();
+
+    // Bind to the systems that provide facts and seed the current values
+    void Initialize(UTimeManager* InTimeManager, UNPCScheduler* InNPCScheduler, UQuestManager* InQuestManager);
+
+    // Register a rule, replacing any rule with the same ID
+    UFUNCTION(BlueprintCallable, Category = "Rule System")
+    void AddRule(const FGameRule& Rule);
+
+    // Unregister a rule
+    UFUNCTION(BlueprintCallable, Category = "Rule System")
+    void RemoveRule(FName RuleId);
+
+    // Whether a rule's conditions currently all hold
+    UFUNCTION(BlueprintPure, Category = "Rule System")
+    bool IsRuleActive(FName RuleId) const;
+
+    // Set an integer fact
+    UFUNCTION(BlueprintCallable, Category = "Rule System")
+    void SetIntFact(FName FactKey, int32 Value);
+
+    // Set a name fact
+    UFUNCTION(BlueprintCallable, Category = "Rule System")
+    void SetNameFact(FName FactKey, FName Value);
+
+    // Get an integer fact, 0 if never set
+    UFUNCTION(BlueprintPure, Category = "Rule System")
+    int32 GetIntFact(FName FactKey) const;
+
+    // Get a name fact, None if never set
+    UFUNCTION(BlueprintPure, Category = "Rule System")
+    FName GetNameFact(FName FactKey) const;
+
+    // Record the current weather
+    void SetWeather(uint8 WeatherCondition);
+
+    // Record the player's item counts; items no longer held drop to zero
+    void SyncItemCounts(const TMap<FName, int32>& ItemCounts);
+
+    // Record the item counts held in an inventory
+    void SyncInventory(const UInventoryComponent* Inventory);
+
+    // Re-read every knowledge fact a rule tests, after knowledge was replaced without change events
+    void SyncKnowledgeFacts();
+
+    // Clear activation history for a new loop; facts keep their values
+    void ResetForNewDay();
+
+    // Fact keys for per-entity facts
+    static FName MakeKnowledgeFactKey(FName FlagName);
+    static FName MakeNPCLocationFactKey(FName NPCId);
+    static FName MakeItemFactKey(FName ItemID);
+
+    // Number of shared nodes, for profiling
+    int32 GetNumAlphaNodes() const { return AlphaNodes.Num(); }
+    int32 GetNumBetaNodes() const { return BetaNodes.Num(); }
+
+    // Delegate fired when a rule's conditions start holding
+    UPROPERTY(BlueprintAssignable, Category = "Rule System|Events")
+    FRuleActivationDelegate OnRuleActivated;
+
+    // Delegate fired when an active rule's conditions stop holding
+    UPROPERTY(BlueprintAssignable, Category = "Rule System|Events")
+    FRuleActivationDelegate OnRuleDeactivated;
+
+private:
+    struct FFact
+    {
+        int32 IntValue = 0;
+        FName NameValue = NAME_None;
+    };
+
+    /** A single condition, shared by every rule that tests it */
+    struct FAlphaNode
+    {
+        FRuleCondition Condition;
+        bool bSatisfied = false;
+
+        // Beta nodes that join this test onto their parent
+        TArray<int32> Successors;
+    };
+
+    /** The conjunction of its parent's tests and one alpha test */
+    struct FBetaNode
+    {
+        int32 Parent = INDEX_NONE;
+        int32 Alpha = INDEX_NONE;
+        bool bMatched = false;
+        bool bQueued = false;
+        TArray<int32> Children;
+
+        // Rules whose full condition list ends here
+        TArray<int32> Rules;
+    };
+
+    struct FRuleEntry
+    {
+        FGameRule Rule;
+        int32 Terminal = INDEX_NONE;
+        bool bActive = false;
+        bool bFiredThisLoop = false;
+        bool bRemoved = false;
+    };
+
+    // Compare a fact against a condition
+    static bool TestCondition(const FRuleCondition& Condition, const FFact& Fact);
+
+    // Find or create the alpha node for a condition
+    int32 FindOrAddAlphaNode(const FRuleCondition& Condition);
+
+    // Seed a newly tested fact from the system that provides it, if no change has reported it yet
+    void BindFactSource(FName FactKey);
+
+    // Find or create the beta node joining an alpha node onto a parent
+    int32 FindOrAddBetaNode(int32 Parent, int32 Alpha);
+
+    // Store a fact and propagate the alpha nodes that flip
+    void UpdateFact(FName FactKey, const FFact& Fact);
+
+    // Mark a beta node for re-testing
+    void QueueBetaNode(int32 BetaIndex);
+
+    // Re-test queued beta nodes in creation order, queueing children whose parent flipped
+    void PropagateBetaNodes();
+
+    // Queue a rule whose terminal match changed
+    void QueueRuleChange(int32 RuleIndex, bool bMatched);
+
+    // Run queued activations; actions may change facts and queue more
+    void FlushRuleChanges();
+
+    // Apply a rule's built-in actions and notify listeners
+    void ActivateRule(FRuleEntry& Entry);
+
+    UFUNCTION()
+    void OnHourChanged(int32 NewHour);
+
+    UFUNCTION()
+    void OnTimeOfDayChanged(FName NewTimeOfDay);
+
+    UFUNCTION()
+    void OnNPCLocationChanged(FName NPCId, FName LocationId);
+
+    UFUNCTION()
+    void OnKnowledgeFlagsChanged(const TArray<FName>& ChangedFlags);
+
+    // Systems that provide facts and receive actions
+    UPROPERTY()
+    UTimeManager* TimeManager;
+
+    UPROPERTY()
+    UNPCScheduler* NPCScheduler;
+
+    UPROPERTY()
+    UQuestManager* QuestManager;
+
+    // Current facts, mapped by key
+    TMap<FName, FFact> Facts;
+
+    // Flag behind each knowledge fact some rule tests
+    TMap<FName, FName> KnowledgeFactFlags;
+
+    // Alpha nodes testing each fact
+    TMap<FName, TArray<int32>> FactAlphaNodes;
+
+    TArray<FAlphaNode> AlphaNodes;
+
+    // Alpha nodes by their condition, for sharing
+    TMap<FString, int32> AlphaNodeIndices;
+
+    // Beta node 0 is the always-matched root
+    TArray<FBetaNode> BetaNodes;
+
+    // Beta nodes by (parent, alpha), for sharing
+    TMap<uint64, int32> BetaNodeIndices;
+
+    // Min-heap of beta nodes waiting to be re-tested
+    TArray<int32> DirtyBetaNodes;
+
+    TArray<FRuleEntry> Rules;
+    TMap<FName, int32> RuleIndices;
+
+    // Rule matches that flipped during propagation, in order
+    TArray<TPair<int32, bool>> PendingRuleChanges;
+
+    // Guards against nested flushes when actions change facts
+    bool bFlushingRuleChanges;
+
+    // Item facts currently above zero
+    TSet<FName> HeldItems;
+};
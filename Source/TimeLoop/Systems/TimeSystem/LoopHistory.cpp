@@ -0,0 +1,805 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "LoopHistory.h"
+#include "TimeLoopSaveArchive.h"
+#include "TimeLoop/Systems/QuestSystem/QuestManager.h"
+#include "TimeLoop/Systems/CharacterSystem/NPCScheduler.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    void WriteVarint(TArray<uint8>& Out, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Out.Add(static_cast<uint8>(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.Add(static_cast<uint8>(Value));
+    }
+
+    uint32 ZigZag(int32 Value)
+    {
+        return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    }
+
+    int32 UnZigZag(uint32 Value)
+    {
+        return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+    }
+
+    /** Reads varints from one column; reads past the end yield zero */
+    struct FVarintReader
+    {
+        const uint8* Pos;
+        const uint8* End;
+
+        uint32 Next()
+        {
+            uint32 Value = 0;
+            for (int32 Shift = 0; Pos < End && Shift < 35; Shift += 7)
+            {
+                const uint8 Byte = *Pos++;
+                Value |= static_cast<uint32>(Byte & 0x7F) << Shift;
+                if (!(Byte & 0x80))
+                {
+                    break;
+                }
+            }
+            return Value;
+        }
+    };
+
+    /** Writes a column as (value, run length) varint pairs */
+    struct FRunWriter
+    {
+        TArray<uint8>& Out;
+        uint32 Value = 0;
+        uint32 Run = 0;
+
+        explicit FRunWriter(TArray<uint8>& InOut) : Out(InOut) {}
+
+        void Add(uint32 NewValue)
+        {
+            if (Run > 0 && NewValue == Value)
+            {
+                ++Run;
+                return;
+            }
+            Finish();
+            Value = NewValue;
+            Run = 1;
+        }
+
+        void Finish()
+        {
+            if (Run > 0)
+            {
+                WriteVarint(Out, Value);
+                WriteVarint(Out, Run);
+                Run = 0;
+            }
+        }
+    };
+
+    struct FRunReader
+    {
+        FVarintReader Reader;
+        uint32 Value = 0;
+        uint32 Remaining = 0;
+
+        uint32 Next()
+        {
+            if (Remaining == 0)
+            {
+                Value = Reader.Next();
+                Remaining = FMath::Max<uint32>(Reader.Next(), 1);
+            }
+            --Remaining;
+            return Value;
+        }
+    };
+}
+
+ULoopHistory::ULoopHistory()
+    : QuestManager(nullptr)
+    , NumSealedLoops(0)
+    , bRecording(false)
+{
+}
+
+void ULoopHistory::BeginDestroy()
+{
+    Flush();
+    Super::BeginDestroy();
+}
+
+void ULoopHistory::Initialize(UQuestManager* InQuestManager, UNPCScheduler* InNPCScheduler)
+{
+    QuestManager = InQuestManager;
+    
+    if (QuestManager)
+    {
+        QuestManager->OnKnowledgeFlagsChanged.AddDynamic(this, &ULoopHistory::OnKnowledgeFlagsChanged);
+        QuestManager->OnQuestStatesChanged.AddDynamic(this, &ULoopHistory::OnQuestStatesChanged);
+    }
+    
+    if (InNPCScheduler)
+    {
+        InNPCScheduler->OnNPCInteracted.AddDynamic(this, &ULoopHistory::OnNPCInteracted);
+    }
+    
+    BeginLoop();
+}
+
+void ULoopHistory::BeginLoop()
+{
+    CurrentRow = FRow();
+    bRecording = true;
+}
+
+void ULoopHistory::EndLoop(int32 LoopIndex, int32 EndMinute, ELoopEndReason EndReason)
+{
+    CurrentRow.LoopIndex = LoopIndex;
+    CurrentRow.EndMinute = EndMinute;
+    CurrentRow.EndReason = static_cast<uint8>(EndReason);
+    for (TArray<uint32>& List : CurrentRow.Lists)
+    {
+        List.Sort();
+    }
+    
+    TailRows.Add(MoveTemp(CurrentRow));
+    CurrentRow = FRow();
+    
+    // Nothing is recorded between a loop ending and the next beginning, while systems reset
+    bRecording = false;
+    
+    if (TailRows.Num() >= BlockSize)
+    {
+        FBlock& Block = Blocks.AddDefaulted_GetRef();
+        EncodeBlock(TailRows, Block);
+        NumSealedLoops += TailRows.Num();
+        TailRows.Reset();
+    }
+}
+
+void ULoopHistory::RecordLocationVisit(FName LocationId)
+{
+    RecordName(ELoopHistoryColumn::LocationsVisited, LocationId);
+}
+
+void ULoopHistory::RecordName(ELoopHistoryColumn Column, FName Name)
+{
+    if (!bRecording || Name.IsNone())
+    {
+        return;
+    }
+    
+    CurrentRow.Lists[static_cast<int32>(Column)].AddUnique(FindOrAddNameId(Name));
+}
+
+uint32 ULoopHistory::FindOrAddNameId(FName Name)
+{
+    if (const uint32* Id = NameIds.Find(Name))
+    {
+        return *Id;
+    }
+    
+    const uint32 Id = Names.Add(Name);
+    NameIds.Add(Name, Id);
+    return Id;
+}
+
+void ULoopHistory::OnKnowledgeFlagsChanged(const TArray<FName>& ChangedFlags)
+{
+    for (const FName& Flag : ChangedFlags)
+    {
+        if (QuestManager && QuestManager->HasKnowledgeFlag(Flag))
+        {
+            RecordName(ELoopHistoryColumn::FlagsLearned, Flag);
+        }
+    }
+}
+
+void ULoopHistory::OnQuestStatesChanged(const TArray<FName>& ChangedQuests)
+{
+    for (const FName& QuestId : ChangedQuests)
+    {
+        const FQuest* Quest = QuestManager ? QuestManager->FindQuest(QuestId) : nullptr;
+        if (Quest && Quest->State == EQuestState::Completed)
+        {
+            RecordName(ELoopHistoryColumn::QuestsCompleted, QuestId);
+        }
+    }
+}
+
+void ULoopHistory::OnNPCInteracted(FName NPCId)
+{
+    RecordName(ELoopHistoryColumn::NPCsMet, NPCId);
+}
+
+void ULoopHistory::EncodeBlock(TArrayView<const FRow> Rows, FBlock& OutBlock)
+{
+    OutBlock = FBlock();
+    OutBlock.NumLoops = Rows.Num();
+    if (Rows.Num() == 0)
+    {
+        return;
+    }
+    OutBlock.FirstLoop = Rows[0].LoopIndex;
+    OutBlock.LastLoop = Rows[0].LoopIndex;
+    
+    TArray<uint8>& Bytes = OutBlock.Bytes;
+    
+    // Loop indices nearly always step by one, which collapses to a single run
+    OutBlock.ColumnOffsets[LoopIndexColumn] = Bytes.Num();
+    {
+        FRunWriter Runs(Bytes);
+        int32 Previous = 0;
+        for (const FRow& Row : Rows)
+        {
+            Runs.Add(ZigZag(Row.LoopIndex - Previous));
+            Previous = Row.LoopIndex;
+            OutBlock.FirstLoop = FMath::Min(OutBlock.FirstLoop, Row.LoopIndex);
+            OutBlock.LastLoop = FMath::Max(OutBlock.LastLoop, Row.LoopIndex);
+        }
+        Runs.Finish();
+    }
+    
+    OutBlock.ColumnOffsets[EndMinuteColumn] = Bytes.Num();
+    {
+        int32 Previous = 0;
+        for (const FRow& Row : Rows)
+        {
+            WriteVarint(Bytes, ZigZag(Row.EndMinute - Previous));
+            Previous = Row.EndMinute;
+        }
+    }
+    
+    OutBlock.ColumnOffsets[EndReasonColumn] = Bytes.Num();
+    {
+        FRunWriter Runs(Bytes);
+        for (const FRow& Row : Rows)
+        {
+            Runs.Add(Row.EndReason);
+        }
+        Runs.Finish();
+    }
+    
+    for (int32 Column = 0; Column < NumListColumns; ++Column)
+    {
+        OutBlock.ColumnOffsets[FirstListCountColumn + Column] = Bytes.Num();
+        FRunWriter Runs(Bytes);
+        for (const FRow& Row : Rows)
+        {
+            Runs.Add(Row.Lists[Column].Num());
+        }
+        Runs.Finish();
+    }
+    
+    for (int32 Column = 0; Column < NumListColumns; ++Column)
+    {
+        OutBlock.ColumnOffsets[FirstListIdColumn + Column] = Bytes.Num();
+        for (const FRow& Row : Rows)
+        {
+            // Sorted ids are stored as gaps from the previous one
+            uint32 Previous = 0;
+            for (const uint32 Id : Row.Lists[Column])
+            {
+                WriteVarint(Bytes, Id - Previous);
+                Previous = Id;
+                OutBlock.Blooms[Column] |= BloomBit(Id);
+            }
+        }
+    }
+    
+    OutBlock.ColumnOffsets[NumBlockColumns] = Bytes.Num();
+}
+
+void ULoopHistory::DecodeLoopIndices(const FBlock& Block, TArray<int32>& OutLoopIndices)
+{
+    OutLoopIndices.SetNumUninitialized(Block.NumLoops);
+    FRunReader Runs{ { Block.Bytes.GetData() + Block.ColumnOffsets[LoopIndexColumn], Block.Bytes.GetData() + Block.ColumnOffsets[LoopIndexColumn + 1] } };
+    
+    int32 Previous = 0;
+    for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+    {
+        Previous += UnZigZag(Runs.Next());
+        OutLoopIndices[Row] = Previous;
+    }
+}
+
+void ULoopHistory::DecodeEndMinutes(const FBlock& Block, TArray<int32>& OutEndMinutes)
+{
+    OutEndMinutes.SetNumUninitialized(Block.NumLoops);
+    FVarintReader Reader{ Block.Bytes.GetData() + Block.ColumnOffsets[EndMinuteColumn], Block.Bytes.GetData() + Block.ColumnOffsets[EndMinuteColumn + 1] };
+    
+    int32 Previous = 0;
+    for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+    {
+        Previous += UnZigZag(Reader.Next());
+        OutEndMinutes[Row] = Previous;
+    }
+}
+
+void ULoopHistory::DecodeEndReasons(const FBlock& Block, TArray<uint8>& OutEndReasons)
+{
+    OutEndReasons.SetNumUninitialized(Block.NumLoops);
+    FRunReader Runs{ { Block.Bytes.GetData() + Block.ColumnOffsets[EndReasonColumn], Block.Bytes.GetData() + Block.ColumnOffsets[EndReasonColumn + 1] } };
+    
+    for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+    {
+        OutEndReasons[Row] = static_cast<uint8>(Runs.Next());
+    }
+}
+
+void ULoopHistory::DecodeList(const FBlock& Block, int32 Column, TFunctionRef<void(int32 Row, TArrayView<const uint32> Ids)> Visitor)
+{
+    const int32 CountColumn = FirstListCountColumn + Column;
+    const int32 IdColumn = FirstListIdColumn + Column;
+    FRunReader Counts{ { Block.Bytes.GetData() + Block.ColumnOffsets[CountColumn], Block.Bytes.GetData() + Block.ColumnOffsets[CountColumn + 1] } };
+    FVarintReader Ids{ Block.Bytes.GetData() + Block.ColumnOffsets[IdColumn], Block.Bytes.GetData() + Block.ColumnOffsets[IdColumn + 1] };
+    
+    TArray<uint32, TInlineAllocator<64>> RowIds;
+    for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+    {
+        // A count larger than the bytes left can only come from damage; clamp it
+        const uint32 Count = FMath::Min<uint32>(Counts.Next(), static_cast<uint32>(Ids.End - Ids.Pos));
+        
+        RowIds.Reset();
+        uint32 Previous = 0;
+        for (uint32 Index = 0; Index < Count; ++Index)
+        {
+            Previous += Ids.Next();
+            RowIds.Add(Previous);
+        }
+        Visitor(Row, RowIds);
+    }
+}
+
+void ULoopHistory::DecodeBlock(const FBlock& Block, TArray<FRow>& OutRows)
+{
+    TArray<int32> LoopIndices;
+    TArray<int32> EndMinutes;
+    TArray<uint8> EndReasons;
+    DecodeLoopIndices(Block, LoopIndices);
+    DecodeEndMinutes(Block, EndMinutes);
+    DecodeEndReasons(Block, EndReasons);
+    
+    const int32 FirstRow = OutRows.Num();
+    OutRows.AddDefaulted(Block.NumLoops);
+    for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+    {
+        FRow& Out = OutRows[FirstRow + Row];
+        Out.LoopIndex = LoopIndices[Row];
+        Out.EndMinute = EndMinutes[Row];
+        Out.EndReason = EndReasons[Row];
+    }
+    
+    for (int32 Column = 0; Column < NumListColumns; ++Column)
+    {
+        DecodeList(Block, Column, [&OutRows, FirstRow, Column](int32 Row, TArrayView<const uint32> Ids)
+        {
+            OutRows[FirstRow + Row].Lists[Column].Append(Ids.GetData(), Ids.Num());
+        });
+    }
+}
+
+void ULoopHistory::ForEachBlock(int32 FirstLoop, int32 LastLoop, TFunctionRef<bool(const FBlock& Block)> Visitor) const
+{
+    for (const FBlock& Block : Blocks)
+    {
+        if (Block.LastLoop < FirstLoop || Block.FirstLoop > LastLoop)
+        {
+            continue;
+        }
+        if (!Visitor(Block))
+        {
+            return;
+        }
+    }
+    
+    // The tail is at most one block's worth of rows, cheap to pack on demand
+    if (TailRows.Num() > 0)
+    {
+        FBlock TailBlock;
+        EncodeBlock(TailRows, TailBlock);
+        if (TailBlock.LastLoop >= FirstLoop && TailBlock.FirstLoop <= LastLoop)
+        {
+            Visitor(TailBlock);
+        }
+    }
+}
+
+TArray<FLoopRecord> ULoopHistory::GetLoops(int32 FirstLoop, int32 LastLoop) const
+{
+    TArray<FLoopRecord> Records;
+    TArray<FRow> Rows;
+    
+    ForEachBlock(FirstLoop, LastLoop, [&](const FBlock& Block)
+    {
+        Rows.Reset();
+        DecodeBlock(Block, Rows);
+        for (const FRow& Row : Rows)
+        {
+            if (Row.LoopIndex < FirstLoop || Row.LoopIndex > LastLoop)
+            {
+                continue;
+            }
+            
+            FLoopRecord& Record = Records.AddDefaulted_GetRef();
+            Record.LoopIndex = Row.LoopIndex;
+            Record.EndMinute = Row.EndMinute;
+            Record.EndReason = static_cast<ELoopEndReason>(Row.EndReason);
+            
+            TArray<FName>* Lists[NumListColumns] = { &Record.FlagsLearned, &Record.QuestsCompleted, &Record.NPCsMet, &Record.LocationsVisited };
+            for (int32 Column = 0; Column < NumListColumns; ++Column)
+            {
+                for (const uint32 Id : Row.Lists[Column])
+                {
+                    if (Names.IsValidIndex(Id))
+                    {
+                        Lists[Column]->Add(Names[Id]);
+                    }
+                }
+            }
+        }
+        return true;
+    });
+    
+    return Records;
+}
+
+int32 ULoopHistory::CountLoopsWith(ELoopHistoryColumn Column, FName Name, int32 FirstLoop, int32 LastLoop) const
+{
+    const uint32* Id = NameIds.Find(Name);
+    if (!Id)
+    {
+        return 0;
+    }
+    
+    const int32 ColumnIndex = static_cast<int32>(Column);
+    const uint64 Bloom = BloomBit(*Id);
+    int32 Count = 0;
+    TArray<int32> LoopIndices;
+    
+    ForEachBlock(FirstLoop, LastLoop, [&](const FBlock& Block)
+    {
+        if (!(Block.Blooms[ColumnIndex] & Bloom))
+        {
+            return true;
+        }
+        
+        DecodeLoopIndices(Block, LoopIndices);
+        DecodeList(Block, ColumnIndex, [&](int32 Row, TArrayView<const uint32> Ids)
+        {
+            if (LoopIndices[Row] >= FirstLoop && LoopIndices[Row] <= LastLoop && Algo::BinarySearch(Ids, *Id) != INDEX_NONE)
+            {
+                ++Count;
+            }
+        });
+        return true;
+    });
+    
+    return Count;
+}
+
+int32 ULoopHistory::FindFirstLoopWith(ELoopHistoryColumn Column, FName Name) const
+{
+    const uint32* Id = NameIds.Find(Name);
+    if (!Id)
+    {
+        return INDEX_NONE;
+    }
+    
+    const int32 ColumnIndex = static_cast<int32>(Column);
+    const uint64 Bloom = BloomBit(*Id);
+    int32 FirstLoop = INDEX_NONE;
+    TArray<int32> LoopIndices;
+    
+    ForEachBlock(MIN_int32, MAX_int32, [&](const FBlock& Block)
+    {
+        if (!(Block.Blooms[ColumnIndex] & Bloom))
+        {
+            return true;
+        }
+        
+        DecodeLoopIndices(Block, LoopIndices);
+        DecodeList(Block, ColumnIndex, [&](int32 Row, TArrayView<const uint32> Ids)
+        {
+            if (FirstLoop == INDEX_NONE && Algo::BinarySearch(Ids, *Id) != INDEX_NONE)
+            {
+                FirstLoop = LoopIndices[Row];
+            }
+        });
+        
+        // Loops are recorded in order, so the first block with a match has the answer
+        return FirstLoop == INDEX_NONE;
+    });
+    
+    return FirstLoop;
+}
+
+TMap<FName, int32> ULoopHistory::GetColumnHistogram(ELoopHistoryColumn Column, int32 FirstLoop, int32 LastLoop) const
+{
+    const int32 ColumnIndex = static_cast<int32>(Column);
+    TArray<int32> CountsById;
+    CountsById.SetNumZeroed(Names.Num());
+    TArray<int32> LoopIndices;
+    
+    ForEachBlock(FirstLoop, LastLoop, [&](const FBlock& Block)
+    {
+        DecodeLoopIndices(Block, LoopIndices);
+        DecodeList(Block, ColumnIndex, [&](int32 Row, TArrayView<const uint32> Ids)
+        {
+            if (LoopIndices[Row] < FirstLoop || LoopIndices[Row] > LastLoop)
+            {
+                return;
+            }
+            for (const uint32 Id : Ids)
+            {
+                if (CountsById.IsValidIndex(Id))
+                {
+                    ++CountsById[Id];
+                }
+            }
+        });
+        return true;
+    });
+    
+    TMap<FName, int32> Histogram;
+    for (int32 Id = 0; Id < CountsById.Num(); ++Id)
+    {
+        if (CountsById[Id] > 0)
+        {
+            Histogram.Add(Names[Id], CountsById[Id]);
+        }
+    }
+    return Histogram;
+}
+
+int32 ULoopHistory::CountLoopsEndedBy(ELoopEndReason EndReason, int32 FirstLoop, int32 LastLoop) const
+{
+    int32 Count = 0;
+    TArray<int32> LoopIndices;
+    TArray<uint8> EndReasons;
+    
+    ForEachBlock(FirstLoop, LastLoop, [&](const FBlock& Block)
+    {
+        DecodeLoopIndices(Block, LoopIndices);
+        DecodeEndReasons(Block, EndReasons);
+        for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+        {
+            if (LoopIndices[Row] >= FirstLoop && LoopIndices[Row] <= LastLoop && EndReasons[Row] == static_cast<uint8>(EndReason))
+            {
+                ++Count;
+            }
+        }
+        return true;
+    });
+    
+    return Count;
+}
+
+float ULoopHistory::GetAverageEndMinute(int32 FirstLoop, int32 LastLoop) const
+{
+    int64 Total = 0;
+    int32 Count = 0;
+    TArray<int32> LoopIndices;
+    TArray<int32> EndMinutes;
+    
+    ForEachBlock(FirstLoop, LastLoop, [&](const FBlock& Block)
+    {
+        DecodeLoopIndices(Block, LoopIndices);
+        DecodeEndMinutes(Block, EndMinutes);
+        for (int32 Row = 0; Row < Block.NumLoops; ++Row)
+        {
+            if (LoopIndices[Row] >= FirstLoop && LoopIndices[Row] <= LastLoop)
+            {
+                Total += EndMinutes[Row];
+                ++Count;
+            }
+        }
+        return true;
+    });
+    
+    return Count > 0 ? static_cast<float>(Total) / Count : 0.0f;
+}
+
+int32 ULoopHistory::GetSerializedSize() const
+{
+    TArray<uint8> Bytes;
+    Write(Bytes);
+    return Bytes.Num();
+}
+
+void ULoopHistory::SerializeBlock(FArchive& Ar, FBlock& Block)
+{
+    Ar << Block.FirstLoop << Block.LastLoop << Block.NumLoops;
+    for (uint64& Bloom : Block.Blooms)
+    {
+        Ar << Bloom;
+    }
+    for (uint32& Offset : Block.ColumnOffsets)
+    {
+        Ar << Offset;
+    }
+    Ar << Block.Bytes;
+}
+
+void ULoopHistory::Write(TArray<uint8>& OutBytes) const
+{
+    OutBytes.Reset();
+    FMemoryWriter Ar(OutBytes);
+    
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    Ar << FileMagic << FileVersion;
+    
+    TArray<FName> NameTable = Names;
+    Ar << NameTable;
+    
+    // The tail is written packed like any other block and unpacked again on load
+    FBlock TailBlock;
+    EncodeBlock(TailRows, TailBlock);
+    
+    int32 NumBlocks = Blocks.Num() + 1;
+    Ar << NumBlocks;
+    for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+    {
+        // Saving leaves the block untouched
+        SerializeBlock(Ar, BlockIndex < Blocks.Num() ? const_cast<FBlock&>(Blocks[BlockIndex]) : TailBlock);
+    }
+}
+
+bool ULoopHistory::Read(const TArray<uint8>& Bytes)
+{
+    FMemoryReader Ar(Bytes);
+    
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    Ar << FileMagic << FileVersion;
+    if (Ar.IsError() || FileMagic != Magic || FileVersion != Version)
+    {
+        return false;
+    }
+    
+    TArray<FName> NameTable;
+    Ar << NameTable;
+    
+    int32 NumBlocks = 0;
+    Ar << NumBlocks;
+    if (Ar.IsError() || NumBlocks < 1)
+    {
+        return false;
+    }
+    
+    TArray<FBlock> NewBlocks;
+    for (int32 BlockIndex = 0; BlockIndex < NumBlocks && !Ar.IsError(); ++BlockIndex)
+    {
+        FBlock& Block = NewBlocks.AddDefaulted_GetRef();
+        SerializeBlock(Ar, Block);
+        
+        // Offsets must be ordered and inside the block for the decoders to stay in bounds
+        bool bValid = Block.NumLoops >= 0 && Block.ColumnOffsets[NumBlockColumns] <= (uint32)Block.Bytes.Num();
+        for (int32 Column = 0; Column < NumBlockColumns; ++Column)
+        {
+            bValid &= Block.ColumnOffsets[Column] <= Block.ColumnOffsets[Column + 1];
+        }
+        if (!bValid)
+        {
+            return false;
+        }
+    }
+    if (Ar.IsError())
+    {
+        return false;
+    }
+    
+    // The last block is the unsealed tail
+    TArray<FRow> NewTail;
+    DecodeBlock(NewBlocks.Last(), NewTail);
+    NewBlocks.Pop();
+    
+    Names = MoveTemp(NameTable);
+    NameIds.Reset();
+    for (int32 Id = 0; Id < Names.Num(); ++Id)
+    {
+        NameIds.Add(Names[Id], Id);
+    }
+    
+    Blocks = MoveTemp(NewBlocks);
+    TailRows = MoveTemp(NewTail);
+    NumSealedLoops = 0;
+    for (const FBlock& Block : Blocks)
+    {
+        NumSealedLoops += Block.NumLoops;
+    }
+    
+    // Ids noted so far this loop referred to the old name table
+    CurrentRow = FRow();
+    return true;
+}
+
+void ULoopHistory::SaveToFile(const FString& Path)
+{
+    Flush();
+    
+    TArray<uint8> Bytes;
+    Write(Bytes);
+    
+    PendingWrite = Async(EAsyncExecution::ThreadPool, [Bytes = MoveTemp(Bytes), Path]()
+    {
+        const bool bSuccess = FTimeLoopSaveArchive::WriteFileAtomic(Bytes, Path);
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Loop History: Failed to write %s"), *Path);
+        }
+        return bSuccess;
+    });
+}
+
+bool ULoopHistory::LoadFromFile(const FString& Path)
+{
+    Flush();
+    
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+    
+    if (!Read(Bytes))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Loop History: %s is not a valid history"), *Path);
+        return false;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Loop History: Loaded %d loops (%d bytes)"), GetNumLoops(), Bytes.Num());
+    return true;
+}
+
+void ULoopHistory::Reset()
+{
+    Flush();
+    
+    Names.Reset();
+    NameIds.Reset();
+    Blocks.Reset();
+    NumSealedLoops = 0;
+    TailRows.Reset();
+    CurrentRow = FRow();
+}
+
+void ULoopHistory::Flush()
+{
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+        PendingWrite = TFuture<bool>();
+    }
+}
+
+FString ULoopHistory::GetSlotPath(const FString& SlotName)
+{
+    return FPaths::ChangeExtension(FTimeLoopSaveArchive::GetSlotPath(SlotName), TEXT("tlhistory"));
+}
@@ -0,0 +1,279 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
+#include "LoopHistory.generated.h"
+
+class UTimeManager;
+class UQuestManager;
+class UNPCScheduler;
+
+/**
+ * ELoopEndReason - Why a loop ended
+ */
+UENUM(BlueprintType)
+enum class ELoopEndReason : uint8
+{
+    Reset UMETA(DisplayName = "Reset"),
+    Death UMETA(DisplayName = "Death"),
+    DayEnded UMETA(DisplayName = "Day Ended")
+};
+
+/**
+ * ELoopHistoryColumn - The per-loop name lists the history records
+ */
+UENUM(BlueprintType)
+enum class ELoopHistoryColumn : uint8
+{
+    FlagsLearned UMETA(DisplayName = "Flags Learned"),
+    QuestsCompleted UMETA(DisplayName = "Quests Completed"),
+    NPCsMet UMETA(DisplayName = "NPCs Met"),
+    LocationsVisited UMETA(DisplayName = "Locations Visited")
+};
+
+/**
+ * FLoopRecord - What happened during one loop
+ */
+USTRUCT(BlueprintType)
+struct FLoopRecord
+{
+    GENERATED_BODY()
+
+    // Loop count the loop was played under
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    int32 LoopIndex;
+
+    // Clock time the loop ended, in minutes after midnight
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    int32 EndMinute;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    ELoopEndReason EndReason;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    TArray<FName> FlagsLearned;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    TArray<FName> QuestsCompleted;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    TArray<FName> NPCsMet;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Loop History")
+    TArray<FName> LocationsVisited;
+
+    // Constructor
+    FLoopRecord()
+        : LoopIndex(0)
+        , EndMinute(0)
+        , EndReason(ELoopEndReason::Reset)
+    {
+    }
+};
+
+/**
+ * ULoopHistory - Columnar archive of every loop the player has lived through
+ *
+ * Finished loops are packed into immutable blocks of BlockSize loops. Within a block each
+ * field is its own column: loop indices and end times are delta-encoded varints, end
+ * reasons and list lengths are run-length encoded, and each loop's names are dictionary
+ * ids, sorted and delta-encoded. A scan decodes only the columns a query needs, and each
+ * block keeps a small bloom mask per list column so lookups for one name skip blocks that
+ * cannot contain it. Loops since the last full block stay as plain rows until it fills.
+ */
+UCLASS(BlueprintType)
+class TIMELOOP_API ULoopHistory : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    ULoopHistory();
+
+    // Finish any background write before the history goes away
+    virtual void BeginDestroy() override;
+
+    // Start recording from the game's systems
+    void Initialize(UQuestManager* InQuestManager, UNPCScheduler* InNPCScheduler);
+
+    // Begin recording a new loop, discarding anything noted since the last one ended
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    void BeginLoop();
+
+    // Finish the loop being recorded and append it to the history
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    void EndLoop(int32 LoopIndex, int32 EndMinute, ELoopEndReason EndReason);
+
+    // Note a name in one of the current loop's columns
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    void RecordName(ELoopHistoryColumn Column, FName Name);
+
+    // Note that the player visited a location this loop
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    void RecordLocationVisit(FName LocationId);
+
+    // Number of finished loops recorded
+    UFUNCTION(BlueprintPure, Category = "Loop History")
+    int32 GetNumLoops() const { return NumSealedLoops + TailRows.Num(); }
+
+    // Every recorded loop with a loop index in [FirstLoop, LastLoop]
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    TArray<FLoopRecord> GetLoops(int32 FirstLoop, int32 LastLoop) const;
+
+    // Number of loops in [FirstLoop, LastLoop] whose column contains a name
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    int32 CountLoopsWith(ELoopHistoryColumn Column, FName Name, int32 FirstLoop, int32 LastLoop) const;
+
+    // Earliest loop whose column contains a name, or -1
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    int32 FindFirstLoopWith(ELoopHistoryColumn Column, FName Name) const;
+
+    // How many loops in [FirstLoop, LastLoop] contain each name of a column
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    TMap<FName, int32> GetColumnHistogram(ELoopHistoryColumn Column, int32 FirstLoop, int32 LastLoop) const;
+
+    // Number of loops in [FirstLoop, LastLoop] that ended for a reason
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    int32 CountLoopsEndedBy(ELoopEndReason EndReason, int32 FirstLoop, int32 LastLoop) const;
+
+    // Mean end time of the loops in [FirstLoop, LastLoop], in minutes after midnight
+    UFUNCTION(BlueprintCallable, Category = "Loop History")
+    float GetAverageEndMinute(int32 FirstLoop, int32 LastLoop) const;
+
+    // Bytes the history occupies when saved
+    UFUNCTION(BlueprintPure, Category = "Loop History")
+    int32 GetSerializedSize() const;
+
+    // Serialize the history
+    void Write(TArray<uint8>& OutBytes) const;
+
+    // Replace the history with serialized data, leaving it untouched if the data is invalid
+    bool Read(const TArray<uint8>& Bytes);
+
+    // Write the history to a file in the background; a write still running is waited on first
+    void SaveToFile(const FString& Path);
+
+    // Replace the history with a file's contents
+    bool LoadFromFile(const FString& Path);
+
+    // Forget every recorded loop
+    void Reset();
+
+    // Block until a background write has finished
+    void Flush();
+
+    // Path of the history belonging to a save slot
+    static FString GetSlotPath(const FString& SlotName);
+
+    // Loops per sealed block
+    static constexpr int32 BlockSize = 128;
+
+    static constexpr uint32 Magic = 0x53484C54; // "TLHS"
+    static constexpr uint32 Version = 1;
+
+private:
+    static constexpr int32 NumListColumns = 4;
+
+    /** A loop as dictionary ids; each list is sorted and unique */
+    struct FRow
+    {
+        int32 LoopIndex = 0;
+        int32 EndMinute = 0;
+        uint8 EndReason = 0;
+        TArray<uint32> Lists[NumListColumns];
+    };
+
+    /** Column offsets into a block's bytes */
+    enum EBlockColumn : int32
+    {
+        LoopIndexColumn,
+        EndMinuteColumn,
+        EndReasonColumn,
+        FirstListCountColumn,
+        FirstListIdColumn = FirstListCountColumn + NumListColumns,
+        NumBlockColumns = FirstListIdColumn + NumListColumns
+    };
+
+    struct FBlock
+    {
+        int32 FirstLoop = 0;
+        int32 LastLoop = 0;
+        int32 NumLoops = 0;
+
+        // One bit per id hash, per list column
+        uint64 Blooms[NumListColumns] = {};
+
+        // Start of each column in Bytes, plus the end
+        uint32 ColumnOffsets[NumBlockColumns + 1] = {};
+
+        TArray<uint8> Bytes;
+    };
+
+    // Pack rows into a block
+    static void EncodeBlock(TArrayView<const FRow> Rows, FBlock& OutBlock);
+
+    // Unpack every column of a block, appending its rows
+    static void DecodeBlock(const FBlock& Block, TArray<FRow>& OutRows);
+
+    // Save or load a block's header and bytes
+    static void SerializeBlock(FArchive& Ar, FBlock& Block);
+
+    // Decode one of a block's varint columns
+    static void DecodeLoopIndices(const FBlock& Block, TArray<int32>& OutLoopIndices);
+    static void DecodeEndMinutes(const FBlock& Block, TArray<int32>& OutEndMinutes);
+    static void DecodeEndReasons(const FBlock& Block, TArray<uint8>& OutEndReasons);
+
+    // Visit each loop's ids in a list column
+    static void DecodeList(const FBlock& Block, int32 Column, TFunctionRef<void(int32 Row, TArrayView<const uint32> Ids)> Visitor);
+
+    static uint64 BloomBit(uint32 Id) { return (uint64)1 << (Id * 0x9E3779B1u >> 26); }
+
+    // Visit the sealed blocks, then the tail packed as a block, that overlap [FirstLoop, LastLoop]
+    void ForEachBlock(int32 FirstLoop, int32 LastLoop, TFunctionRef<bool(const FBlock& Block)> Visitor) const;
+
+    uint32 FindOrAddNameId(FName Name);
+
+    UFUNCTION()
+    void OnKnowledgeFlagsChanged(const TArray<FName>& ChangedFlags);
+
+    UFUNCTION()
+    void OnQuestStatesChanged(const TArray<FName>& ChangedQuests);
+
+    UFUNCTION()
+    void OnNPCInteracted(FName NPCId);
+
+    UPROPERTY()
+    UQuestManager* QuestManager;
+
+    // Names referenced by any column; ids index into this
+    TArray<FName> Names;
+    TMap<FName, uint32> NameIds;
+
+    TArray<FBlock> Blocks;
+    int32 NumSealedLoops;
+
+    // Finished loops not yet packed into a block
+    TArray<FRow> TailRows;
+
+    // Loop being recorded
+    FRow CurrentRow;
+    bool bRecording;
+
+    TFuture<bool> PendingWrite;
+};
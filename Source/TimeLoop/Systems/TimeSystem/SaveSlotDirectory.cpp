@@ -0,0 +1,151 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "SaveSlotDirectory.h"
+#include "TimeLoopSaveArchive.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+TArray<FSaveSlotInfo> USaveSlotDirectory::GetSlots()
+{
+    Refresh();
+    
+    TArray<FSaveSlotInfo> Slots;
+    for (const TPair<FString, FCachedSlot>& Pair : Cache)
+    {
+        if (Pair.Value.bValid)
+        {
+            Slots.Add(Pair.Value.Info);
+        }
+    }
+    
+    Slots.Sort([](const FSaveSlotInfo& A, const FSaveSlotInfo& B) { return A.Timestamp > B.Timestamp; });
+    return Slots;
+}
+
+void USaveSlotDirectory::Refresh()
+{
+    IFileManager& FileManager = IFileManager::Get();
+    const FString Directory = FPaths::GetPath(FTimeLoopSaveArchive::GetSlotPath(TEXT("")));
+    
+    TArray<FString> Files;
+    FileManager.FindFiles(Files, *(Directory / TEXT("*.tlsave")), true, false);
+    
+    // Work out which files are new or changed since they were cached
+    TSet<FString> Present;
+    TArray<FString> StaleSlots;
+    TArray<FFileStatData> StaleStats;
+    TArray<FDateTime> StaleSummaryTimes;
+    for (const FString& File : Files)
+    {
+        const FString SlotName = FPaths::GetBaseFilename(File);
+        Present.Add(SlotName);
+        
+        // Journaled saves only touch the sidecar, so it is watched as well
+        const FFileStatData Stat = FileManager.GetStatData(*(Directory / File));
+        const FFileStatData SummaryStat = FileManager.GetStatData(*FTimeLoopSaveArchive::GetSummaryPath(Directory / File));
+        const FDateTime SummaryTime = SummaryStat.bIsValid ? SummaryStat.ModificationTime : FDateTime::MinValue();
+        const FCachedSlot* Cached = Cache.Find(SlotName);
+        if (!Cached || Cached->FileSize != Stat.FileSize || Cached->ModificationTime != Stat.ModificationTime
+            || Cached->SummaryModificationTime != SummaryTime)
+        {
+            StaleSlots.Add(SlotName);
+            StaleStats.Add(Stat);
+            StaleSummaryTimes.Add(SummaryTime);
+        }
+    }
+    
+    for (auto It = Cache.CreateIterator(); It; ++It)
+    {
+        if (!Present.Contains(It.Key()))
+        {
+            It.RemoveCurrent();
+        }
+    }
+    
+    if (StaleSlots.Num() == 0)
+    {
+        return;
+    }
+    
+    // Summaries are tiny; reading them in parallel hides per-file open latency
+    TArray<FCachedSlot> Fresh;
+    Fresh.SetNum(StaleSlots.Num());
+    ParallelFor(StaleSlots.Num(), [&](int32 Index)
+    {
+        FCachedSlot& Slot = Fresh[Index];
+        Slot.ModificationTime = StaleStats[Index].ModificationTime;
+        Slot.FileSize = StaleStats[Index].FileSize;
+        Slot.SummaryModificationTime = StaleSummaryTimes[Index];
+        Slot.Info.SlotName = StaleSlots[Index];
+        
+        FTimeLoopSaveArchive::FSlotSummary Summary;
+        if (!FTimeLoopSaveArchive::ReadCurrentSummary(FTimeLoopSaveArchive::GetSlotPath(StaleSlots[Index]), Summary))
+        {
+            return;
+        }
+        
+        Slot.bValid = true;
+        Slot.Info.LoopCount = Summary.LoopCount;
+        Slot.Info.DayMinute = Summary.DayMinute;
+        Slot.Info.Timestamp = FDateTime(Summary.TimestampTicks);
+        Slot.Info.PlayTimeSeconds = Summary.PlayTimeSeconds;
+        Slot.Info.bHasThumbnail = Summary.ThumbnailSize > 0;
+        Slot.ThumbnailOffset = Summary.ThumbnailOffset;
+        Slot.ThumbnailSize = Summary.ThumbnailSize;
+    });
+    
+    for (int32 Index = 0; Index < StaleSlots.Num(); ++Index)
+    {
+        if (!Fresh[Index].bValid)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Slot Directory: %s has no readable summary"), *StaleSlots[Index]);
+        }
+        Cache.Add(StaleSlots[Index], MoveTemp(Fresh[Index]));
+    }
+}
+
+void USaveSlotDirectory::InvalidateSlot(const FString& SlotName)
+{
+    Cache.Remove(SlotName);
+}
+
+TArray<uint8> USaveSlotDirectory::LoadThumbnail(const FString& SlotName) const
+{
+    TArray<uint8> Thumbnail;
+    
+    const FCachedSlot* Cached = Cache.Find(SlotName);
+    if (!Cached || !Cached->bValid || Cached->ThumbnailSize == 0)
+    {
+        return Thumbnail;
+    }
+    
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FTimeLoopSaveArchive::GetSlotPath(SlotName), FILEREAD_Silent));
+    if (!Reader || (uint64)Reader->TotalSize() < Cached->ThumbnailOffset + Cached->ThumbnailSize)
+    {
+        return Thumbnail;
+    }
+    
+    Thumbnail.SetNumUninitialized(Cached->ThumbnailSize);
+    Reader->Seek(Cached->ThumbnailOffset);
+    Reader->Serialize(Thumbnail.GetData(), Thumbnail.Num());
+    if (Reader->IsError())
+    {
+        Thumbnail.Reset();
+    }
+    return Thumbnail;
+}
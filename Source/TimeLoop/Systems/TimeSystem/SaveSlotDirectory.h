@@ -0,0 +1,109 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "SaveSlotDirectory.generated.h"
+
+/**
+ * FSaveSlotInfo - What a load menu shows for one save slot
+ */
+USTRUCT(BlueprintType)
+struct FSaveSlotInfo
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    FString SlotName;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    int32 LoopCount;
+
+    // Clock time of the save, in minutes after midnight
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    int32 DayMinute;
+
+    // When the save was made (UTC)
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    FDateTime Timestamp;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    float PlayTimeSeconds;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Save Slots")
+    bool bHasThumbnail;
+
+    // Constructor
+    FSaveSlotInfo()
+        : LoopCount(0)
+        , DayMinute(0)
+        , PlayTimeSeconds(0.0f)
+        , bHasThumbnail(false)
+    {
+    }
+};
+
+/**
+ * USaveSlotDirectory - Cached listing of the save slots on disk
+ *
+ * Listing reads only the fixed-size summary at the front of each save, never the archive
+ * behind it, or the newer one in its summary sidecar after journaled saves, and reads the
+ * summaries of new or changed files in parallel. Entries are cached against each file's
+ * size and modification time and its sidecar's, so refreshing an unchanged directory
+ * costs one directory scan.
+ */
+UCLASS(BlueprintType)
+class TIMELOOP_API USaveSlotDirectory : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // Refresh the cache and return every readable slot, most recent first
+    UFUNCTION(BlueprintCallable, Category = "Save Slots")
+    TArray<FSaveSlotInfo> GetSlots();
+
+    // Re-read changed slot summaries
+    UFUNCTION(BlueprintCallable, Category = "Save Slots")
+    void Refresh();
+
+    // Forget a slot's cached summary so the next refresh reads it again
+    UFUNCTION(BlueprintCallable, Category = "Save Slots")
+    void InvalidateSlot(const FString& SlotName);
+
+    // Read a slot's thumbnail bytes without loading the rest of the save
+    UFUNCTION(BlueprintCallable, Category = "Save Slots")
+    TArray<uint8> LoadThumbnail(const FString& SlotName) const;
+
+private:
+    struct FCachedSlot
+    {
+        FSaveSlotInfo Info;
+        FDateTime ModificationTime;
+        int64 FileSize = 0;
+
+        // Modification time of the summary sidecar, FDateTime::MinValue() without one
+        FDateTime SummaryModificationTime;
+        uint64 ThumbnailOffset = 0;
+        uint32 ThumbnailSize = 0;
+
+        // False for files whose summary could not be read
+        bool bValid = false;
+    };
+
+    TMap<FString, FCachedSlot> Cache;
+};
@@ -0,0 +1,130 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "TimeLoopAsyncSaver.h"
+#include "TimeLoopSaveGame.h"
+#include "Async/Async.h"
+
+FTimeLoopAsyncSaver::~FTimeLoopAsyncSaver()
+{
+    // A worker may still be reading the snapshot
+    if (InFlightResult.IsValid())
+    {
+        InFlightResult.Wait();
+    }
+}
+
+void FTimeLoopAsyncSaver::Save(UTimeLoopSaveGame* Snapshot, const FString& Path, FOnAsyncSaveComplete OnComplete)
+{
+    check(IsInGameThread());
+    
+    if (!Snapshot)
+    {
+        OnComplete.ExecuteIfBound(false);
+        return;
+    }
+    
+    // A newer snapshot supersedes whatever was waiting; its callbacks ride along
+    if (!Pending)
+    {
+        Pending = MakeUnique<FRequest>();
+    }
+    else
+    {
+        UE_LOG(LogTemp, Log, TEXT("Async Saver: Coalescing save into a newer snapshot"));
+    }
+    Pending->Snapshot.Reset(Snapshot);
+    Pending->Path = Path;
+    Pending->Callbacks.Add(MoveTemp(OnComplete));
+    
+    if (!InFlight)
+    {
+        StartPending();
+    }
+}
+
+void FTimeLoopAsyncSaver::StartPending()
+{
+    InFlight = MoveTemp(Pending);
+    const uint32 Sequence = ++InFlightSequence;
+    
+    // The snapshot stays referenced by InFlight, and the base by Committed, until the game thread finishes the request
+    const UTimeLoopSaveGame* Snapshot = InFlight->Snapshot.Get();
+    const UTimeLoopSaveGame* Base = Committed.Get();
+    const FString Path = InFlight->Path;
+    const ESaveCompression CheckpointCompression = Compression;
+    FTimeLoopSaveJournal* SaveJournal = &Journal;
+    TWeakPtr<FTimeLoopAsyncSaver> WeakThis = AsShared();
+    
+    // The destructor waits on the worker, so the journal outlives it
+    InFlightResult = Async(EAsyncExecution::ThreadPool, [Snapshot, Base, Path, CheckpointCompression, SaveJournal, WeakThis, Sequence]()
+    {
+        const bool bSuccess = SaveJournal->Commit(Base, *Snapshot, Path, CheckpointCompression);
+        
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Sequence, bSuccess]()
+        {
+            if (TSharedPtr<FTimeLoopAsyncSaver> Saver = WeakThis.Pin())
+            {
+                Saver->FinishInFlight(Sequence, bSuccess);
+            }
+        });
+        return bSuccess;
+    });
+}
+
+void FTimeLoopAsyncSaver::FinishInFlight(uint32 Sequence, bool bSuccess)
+{
+    // Flush may already have finished this request
+    if (!InFlight || Sequence != InFlightSequence)
+    {
+        return;
+    }
+    
+    TUniquePtr<FRequest> Finished = MoveTemp(InFlight);
+    InFlightResult = TFuture<bool>();
+    
+    // A failed write leaves no base to diff against; the next save checkpoints
+    if (bSuccess)
+    {
+        Committed.Reset(Finished->Snapshot.Get());
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("Async Saver: Failed to write %s"), *Finished->Path);
+        Committed.Reset();
+    }
+    
+    if (Pending)
+    {
+        StartPending();
+    }
+    
+    for (FOnAsyncSaveComplete& Callback : Finished->Callbacks)
+    {
+        Callback.ExecuteIfBound(bSuccess);
+    }
+}
+
+void FTimeLoopAsyncSaver::Flush()
+{
+    check(IsInGameThread());
+    
+    while (InFlight)
+    {
+        const bool bSuccess = InFlightResult.Get();
+        FinishInFlight(InFlightSequence, bSuccess);
+    }
+}
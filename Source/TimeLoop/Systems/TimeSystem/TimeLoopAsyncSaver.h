@@ -0,0 +1,84 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "UObject/StrongObjectPtr.h"
+#include "TimeLoopSaveJournal.h"
+#include "TimeLoopSaveGame.h"
+
+class UTimeLoopSaveGame;
+
+// Called on the game thread once a requested save has been written, or has failed
+DECLARE_DELEGATE_OneParam(FOnAsyncSaveComplete, bool /* bSuccess */);
+
+/**
+ * FTimeLoopAsyncSaver - Writes save game snapshots on a background thread
+ *
+ * The game thread hands over a snapshot it will not touch again; a worker commits it to
+ * the save journal, appending only what changed since the last snapshot it wrote and
+ * compacting into a compressed checkpoint when the journal grows too long. At most one
+ * save is in flight. Snapshots requested meanwhile coalesce into a single pending save of
+ * the newest one, whose completion also answers the callbacks of the snapshots it replaced.
+ */
+class TIMELOOP_API FTimeLoopAsyncSaver : public TSharedFromThis<FTimeLoopAsyncSaver>
+{
+public:
+    ~FTimeLoopAsyncSaver();
+
+    // Save a snapshot; must be called on the game thread
+    void Save(UTimeLoopSaveGame* Snapshot, const FString& Path, FOnAsyncSaveComplete OnComplete);
+
+    // Whether a save is being written or waiting to be
+    bool IsBusy() const { return InFlight.IsValid() || Pending.IsValid(); }
+
+    // Block until every requested save has been written, running their callbacks
+    void Flush();
+
+    // Codec checkpoints are compressed with
+    ESaveCompression Compression = ESaveCompression::LZ4;
+
+    // Journal size that triggers compaction into a new checkpoint; set before the first save
+    void SetCompactionThreshold(int64 Bytes) { Journal.CompactionThreshold = Bytes; }
+
+private:
+    struct FRequest
+    {
+        TStrongObjectPtr<UTimeLoopSaveGame> Snapshot;
+        FString Path;
+        TArray<FOnAsyncSaveComplete> Callbacks;
+    };
+
+    // Hand the pending request to a worker
+    void StartPending();
+
+    // Finish the in-flight request with the given sequence number; stale notifications are ignored
+    void FinishInFlight(uint32 Sequence, bool bSuccess);
+
+    TUniquePtr<FRequest> InFlight;
+    TFuture<bool> InFlightResult;
+    uint32 InFlightSequence = 0;
+
+    TUniquePtr<FRequest> Pending;
+
+    // Only the in-flight worker touches the journal
+    FTimeLoopSaveJournal Journal;
+
+    // Last snapshot written successfully, the base the next delta is taken against
+    TStrongObjectPtr<UTimeLoopSaveGame> Committed;
+};
@@ -0,0 +1,756 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "TimeLoopSaveArchive.h"
+#include "TimeLoopSaveGame.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    constexpr uint64 SectionAlignment = 8;
+
+    uint64 AlignOffset(uint64 Offset)
+    {
+        return (Offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+    }
+
+    /** Collects each distinct name once and hands out its index */
+    struct FStringTableBuilder
+    {
+        TMap<FName, uint32> Indices;
+        TArray<FName> Names;
+
+        uint32 Add(FName Name)
+        {
+            if (const uint32* Existing = Indices.Find(Name))
+            {
+                return *Existing;
+            }
+            const uint32 Index = Names.Add(Name);
+            Indices.Add(Name, Index);
+            return Index;
+        }
+    };
+
+    /** One section's records, appended as raw bytes */
+    struct FSectionBuilder
+    {
+        uint32 Id = 0;
+        uint32 Count = 0;
+        TArray<uint8> Data;
+
+        template <typename RecordType>
+        void Add(const RecordType& Record)
+        {
+            Data.Append(reinterpret_cast<const uint8*>(&Record), sizeof(RecordType));
+            ++Count;
+        }
+
+        template <typename RecordType>
+        void Append(const TArray<RecordType>& Records)
+        {
+            Data.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(RecordType));
+            Count += Records.Num();
+        }
+    };
+
+    /** Bounds-checked access to the sections of a loaded archive */
+    struct FSectionReader
+    {
+        TArrayView<const uint8> Bytes;
+        TArrayView<const FTimeLoopSaveArchive::FSectionEntry> Entries;
+
+        const FTimeLoopSaveArchive::FSectionEntry* Find(uint32 Id) const
+        {
+            for (const FTimeLoopSaveArchive::FSectionEntry& Entry : Entries)
+            {
+                if (Entry.Id == Id)
+                {
+                    return &Entry;
+                }
+            }
+            return nullptr;
+        }
+
+        // View a section as records in place; a missing section is empty, a malformed one fails
+        template <typename RecordType>
+        bool Get(uint32 Id, TArrayView<const RecordType>& OutRecords) const
+        {
+            OutRecords = TArrayView<const RecordType>();
+            const FTimeLoopSaveArchive::FSectionEntry* Entry = Find(Id);
+            if (!Entry)
+            {
+                return true;
+            }
+            
+            const uint64 RecordBytes = (uint64)Entry->Count * sizeof(RecordType);
+            if (Entry->Offset % SectionAlignment != 0 || RecordBytes > Entry->Size
+                || Entry->Offset > (uint64)Bytes.Num() || Entry->Size > (uint64)Bytes.Num() - Entry->Offset)
+            {
+                return false;
+            }
+            
+            OutRecords = TArrayView<const RecordType>(reinterpret_cast<const RecordType*>(Bytes.GetData() + Entry->Offset), Entry->Count);
+            return true;
+        }
+    };
+
+    // Each codec has its own container magic, so a file names the codec that wrote it
+    FName GetCompressionFormat(uint32 ContainerMagic)
+    {
+        switch (ContainerMagic)
+        {
+        case FTimeLoopSaveArchive::ZlibCompressedMagic:
+            return NAME_Zlib;
+        case FTimeLoopSaveArchive::Lz4CompressedMagic:
+            return NAME_LZ4;
+        default:
+            return NAME_None;
+        }
+    }
+
+    // Resolve a string table index, None if out of range
+    FName GetName(const TArray<FName>& Names, uint32 Index)
+    {
+        return Index < (uint32)Names.Num() ? Names[Index] : NAME_None;
+    }
+}
+
+void FTimeLoopSaveArchive::Write(const UTimeLoopSaveGame& SaveGame, TArray<uint8>& OutBytes)
+{
+    FStringTableBuilder StringTable;
+    TArray<FSectionBuilder> Sections;
+    
+    FSectionBuilder& MetaSection = Sections.AddDefaulted_GetRef();
+    MetaSection.Id = Meta;
+    FMetaRecord MetaRecord;
+    MetaRecord.LoopCount = SaveGame.LoopCount;
+    MetaRecord.KnowledgeLayoutCount = SaveGame.KnowledgeLayoutCount;
+    MetaRecord.KnowledgeLayoutHash = SaveGame.KnowledgeLayoutHash;
+    MetaRecord.Reserved = 0;
+    MetaSection.Add(MetaRecord);
+    
+    FSectionBuilder& KnowledgeSection = Sections.AddDefaulted_GetRef();
+    KnowledgeSection.Id = Knowledge;
+    KnowledgeSection.Append(SaveGame.KnowledgeBits);
+    
+    auto AddNameList = [&Sections, &StringTable](uint32 Id, const TArray<FName>& Names)
+    {
+        FSectionBuilder& Section = Sections.AddDefaulted_GetRef();
+        Section.Id = Id;
+        for (const FName& Name : Names)
+        {
+            Section.Add(StringTable.Add(Name));
+        }
+    };
+    
+    auto AddFloatMap = [&Sections, &StringTable](uint32 Id, const TMap<FName, float>& Values)
+    {
+        FSectionBuilder& Section = Sections.AddDefaulted_GetRef();
+        Section.Id = Id;
+        for (const TPair<FName, float>& Pair : Values)
+        {
+            Section.Add(FNameFloatRecord{ StringTable.Add(Pair.Key), Pair.Value });
+        }
+    };
+    
+    AddNameList(RuntimeKnowledge, SaveGame.RuntimeKnowledgeFlags);
+    AddFloatMap(Relationships, SaveGame.NPCRelationships);
+    AddFloatMap(GrowthValues, SaveGame.PlayerGrowthValues);
+    AddNameList(Locations, SaveGame.DiscoveredLocations);
+    AddNameList(Items, SaveGame.PersistentItems);
+    
+    FSectionBuilder& ProgressSection = Sections.AddDefaulted_GetRef();
+    ProgressSection.Id = QuestProgressValues;
+    for (const TPair<FName, int32>& Pair : SaveGame.PersistentQuestProgress)
+    {
+        ProgressSection.Add(FNameIntRecord{ StringTable.Add(Pair.Key), Pair.Value });
+    }
+    
+    // Quest records point into one shared word section so every record keeps a fixed size
+    FSectionBuilder QuestSection;
+    QuestSection.Id = PersistentQuests;
+    FSectionBuilder WordSection;
+    WordSection.Id = PersistentQuestWords;
+    for (const FSavedQuestProgress& Quest : SaveGame.PersistentQuests)
+    {
+        FQuestRecord Record;
+        Record.Name = StringTable.Add(Quest.QuestId);
+        Record.ObjectiveLayoutHash = Quest.ObjectiveLayoutHash;
+        Record.FirstWord = WordSection.Count;
+        Record.NumWords = (uint16)FMath::Min(Quest.CompletedObjectives.Num(), (int32)MAX_uint16);
+        Record.State = Quest.State;
+        Record.Reserved = 0;
+        QuestSection.Add(Record);
+        
+        for (int32 WordIndex = 0; WordIndex < Record.NumWords; ++WordIndex)
+        {
+            WordSection.Add(Quest.CompletedObjectives[WordIndex]);
+        }
+    }
+    Sections.Add(MoveTemp(QuestSection));
+    Sections.Add(MoveTemp(WordSection));
+    
+    // The string table is written once every other section has added its names
+    FSectionBuilder& StringSection = Sections.AddDefaulted_GetRef();
+    StringSection.Id = Strings;
+    StringSection.Count = StringTable.Names.Num();
+    {
+        TArray<uint32> Offsets;
+        TArray<uint8> Text;
+        Offsets.Reserve(StringTable.Names.Num() + 1);
+        for (const FName& Name : StringTable.Names)
+        {
+            Offsets.Add(Text.Num());
+            const FTCHARToUTF8 Utf8(*Name.ToString());
+            Text.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+        }
+        Offsets.Add(Text.Num());
+        
+        StringSection.Data.Append(reinterpret_cast<const uint8*>(Offsets.GetData()), Offsets.Num() * sizeof(uint32));
+        StringSection.Data.Append(Text);
+    }
+    
+    // Checksums are filled in once every section is laid out
+    FSectionBuilder& ChecksumSection = Sections.AddDefaulted_GetRef();
+    ChecksumSection.Id = Checksums;
+    ChecksumSection.Count = Sections.Num() + 1;
+    ChecksumSection.Data.SetNumZeroed(ChecksumSection.Count * sizeof(uint32));
+    
+    // Lay out the header, section table and aligned sections
+    const uint64 TableOffset = sizeof(FHeader);
+    uint64 Offset = AlignOffset(TableOffset + Sections.Num() * sizeof(FSectionEntry));
+    
+    TArray<FSectionEntry> Entries;
+    Entries.Reserve(Sections.Num());
+    for (const FSectionBuilder& Section : Sections)
+    {
+        Entries.Add(FSectionEntry{ Section.Id, Section.Count, Offset, (uint64)Section.Data.Num() });
+        Offset = AlignOffset(Offset + Section.Data.Num());
+    }
+    
+    FHeader Header;
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.NumSections = Sections.Num();
+    Header.Reserved = 0;
+    Header.FileSize = Offset;
+    
+    OutBytes.Reset(Offset);
+    OutBytes.SetNumZeroed(Offset);
+    FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(FHeader));
+    FMemory::Memcpy(OutBytes.GetData() + TableOffset, Entries.GetData(), Entries.Num() * sizeof(FSectionEntry));
+    for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+    {
+        FMemory::Memcpy(OutBytes.GetData() + Entries[SectionIndex].Offset, Sections[SectionIndex].Data.GetData(), Sections[SectionIndex].Data.Num());
+    }
+    
+    uint32* ChecksumData = reinterpret_cast<uint32*>(OutBytes.GetData() + Entries.Last().Offset);
+    ChecksumData[0] = FCrc::MemCrc32(OutBytes.GetData(), (int32)(TableOffset + Entries.Num() * sizeof(FSectionEntry)));
+    for (int32 SectionIndex = 0; SectionIndex < Sections.Num() - 1; ++SectionIndex)
+    {
+        ChecksumData[SectionIndex + 1] = FCrc::MemCrc32(Sections[SectionIndex].Data.GetData(), Sections[SectionIndex].Data.Num());
+    }
+}
+
+bool FTimeLoopSaveArchive::Read(TArrayView<const uint8> Bytes, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc)
+{
+    // Saved files lead with a summary; the archive follows it
+    if (Bytes.Num() >= (int32)sizeof(FSlotSummary) && reinterpret_cast<const FSlotSummary*>(Bytes.GetData())->Magic == SummaryMagic)
+    {
+        const FSlotSummary& Summary = *reinterpret_cast<const FSlotSummary*>(Bytes.GetData());
+        if (Summary.Version != Version || Summary.BodySize > (uint64)Bytes.Num() - sizeof(FSlotSummary)
+            || (Summary.SummaryCrc != 0 && Summary.SummaryCrc != ComputeSummaryCrc(Summary)))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Archive: Slot summary is damaged"));
+            return false;
+        }
+        
+        const TArrayView<const uint8> Body = Bytes.Slice(sizeof(FSlotSummary), (int32)Summary.BodySize);
+        if (FCrc::MemCrc32(Body.GetData(), Body.Num()) != Summary.BodyCrc)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Archive: Checksum mismatch, the save is damaged"));
+            return false;
+        }
+        
+        if (!Read(Body, OutSaveGame))
+        {
+            return false;
+        }
+        
+        OutSaveGame.DayMinute = Summary.DayMinute;
+        OutSaveGame.SaveTimestamp = FDateTime(Summary.TimestampTicks);
+        OutSaveGame.PlayTimeSeconds = Summary.PlayTimeSeconds;
+        if (OutBodyCrc)
+        {
+            *OutBodyCrc = Summary.BodyCrc;
+        }
+        return true;
+    }
+    
+    if (Bytes.Num() < (int32)sizeof(FHeader))
+    {
+        return false;
+    }
+    
+    // Files from before summaries existed are identified by their whole contents
+    if (OutBodyCrc)
+    {
+        *OutBodyCrc = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+    }
+    
+    // Compressed files cannot be read in place, so inflate them first
+    if (!GetCompressionFormat(reinterpret_cast<const FHeader*>(Bytes.GetData())->Magic).IsNone())
+    {
+        TArray<uint8> Inflated;
+        return Decompress(Bytes, Inflated) && Read(Inflated, OutSaveGame);
+    }
+    
+    const FHeader& Header = *reinterpret_cast<const FHeader*>(Bytes.GetData());
+    if (Header.Magic != Magic || Header.Version != Version || Header.FileSize > (uint64)Bytes.Num()
+        || sizeof(FHeader) + (uint64)Header.NumSections * sizeof(FSectionEntry) > Header.FileSize)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Archive: Not a version %u time loop archive"), Version);
+        return false;
+    }
+    
+    FSectionReader Reader;
+    Reader.Bytes = Bytes.Left((int32)Header.FileSize);
+    Reader.Entries = TArrayView<const FSectionEntry>(reinterpret_cast<const FSectionEntry*>(Bytes.GetData() + sizeof(FHeader)), Header.NumSections);
+    
+    // Archives written before checksums existed have no checksum section and are trusted as they are
+    TArrayView<const uint32> SectionCrcs;
+    if (!Reader.Get(Checksums, SectionCrcs))
+    {
+        return false;
+    }
+    if (SectionCrcs.Num() > 0)
+    {
+        const uint64 TableEnd = sizeof(FHeader) + (uint64)Header.NumSections * sizeof(FSectionEntry);
+        if (SectionCrcs.Num() != (int32)Header.NumSections + 1 || FCrc::MemCrc32(Bytes.GetData(), (int32)TableEnd) != SectionCrcs[0])
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Archive: Section table failed its checksum"));
+            return false;
+        }
+        
+        for (int32 EntryIndex = 0; EntryIndex < Reader.Entries.Num(); ++EntryIndex)
+        {
+            const FSectionEntry& Entry = Reader.Entries[EntryIndex];
+            if (Entry.Id == Checksums)
+            {
+                continue;
+            }
+            if (Entry.Offset > Header.FileSize || Entry.Size > Header.FileSize - Entry.Offset
+                || FCrc::MemCrc32(Bytes.GetData() + Entry.Offset, (int32)Entry.Size) != SectionCrcs[EntryIndex + 1])
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Save Archive: Section %d failed its checksum"), EntryIndex);
+                return false;
+            }
+        }
+    }
+    
+    // Names are the only data converted on load; everything else is read where it lies
+    TArray<FName> Names;
+    if (const FSectionEntry* StringEntry = Reader.Find(Strings))
+    {
+        TArrayView<const uint32> Offsets;
+        const uint64 OffsetBytes = ((uint64)StringEntry->Count + 1) * sizeof(uint32);
+        if (StringEntry->Size < OffsetBytes || StringEntry->Offset % SectionAlignment != 0
+            || StringEntry->Offset > (uint64)Reader.Bytes.Num() || StringEntry->Size > (uint64)Reader.Bytes.Num() - StringEntry->Offset)
+        {
+            return false;
+        }
+        
+        const uint8* SectionData = Reader.Bytes.GetData() + StringEntry->Offset;
+        Offsets = TArrayView<const uint32>(reinterpret_cast<const uint32*>(SectionData), StringEntry->Count + 1);
+        const ANSICHAR* Text = reinterpret_cast<const ANSICHAR*>(SectionData + OffsetBytes);
+        const uint64 TextSize = StringEntry->Size - OffsetBytes;
+        
+        Names.Reserve(StringEntry->Count);
+        for (uint32 NameIndex = 0; NameIndex < StringEntry->Count; ++NameIndex)
+        {
+            const uint32 Start = Offsets[NameIndex];
+            const uint32 End = Offsets[NameIndex + 1];
+            if (Start > End || End > TextSize)
+            {
+                return false;
+            }
+            const FUTF8ToTCHAR Converted(Text + Start, End - Start);
+            Names.Add(FName(Converted.Length(), Converted.Get()));
+        }
+    }
+    
+    TArrayView<const FMetaRecord> MetaRecords;
+    TArrayView<const uint64> KnowledgeWords;
+    TArrayView<const uint32> RuntimeFlags;
+    TArrayView<const FNameFloatRecord> RelationshipRecords;
+    TArrayView<const FNameFloatRecord> GrowthRecords;
+    TArrayView<const FNameIntRecord> ProgressRecords;
+    TArrayView<const FQuestRecord> QuestRecords;
+    TArrayView<const uint64> QuestWords;
+    TArrayView<const uint32> LocationNames;
+    TArrayView<const uint32> ItemNames;
+    if (!Reader.Get(Meta, MetaRecords) || MetaRecords.Num() != 1
+        || !Reader.Get(Knowledge, KnowledgeWords)
+        || !Reader.Get(RuntimeKnowledge, RuntimeFlags)
+        || !Reader.Get(Relationships, RelationshipRecords)
+        || !Reader.Get(GrowthValues, GrowthRecords)
+        || !Reader.Get(QuestProgressValues, ProgressRecords)
+        || !Reader.Get(PersistentQuests, QuestRecords)
+        || !Reader.Get(PersistentQuestWords, QuestWords)
+        || !Reader.Get(Locations, LocationNames)
+        || !Reader.Get(Items, ItemNames))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Archive: Archive has a malformed section"));
+        return false;
+    }
+    
+    const FMetaRecord& MetaRecord = MetaRecords[0];
+    OutSaveGame.LoopCount = MetaRecord.LoopCount;
+    OutSaveGame.KnowledgeLayoutCount = MetaRecord.KnowledgeLayoutCount;
+    OutSaveGame.KnowledgeLayoutHash = MetaRecord.KnowledgeLayoutHash;
+    OutSaveGame.KnowledgeBits = TArray<uint64>(KnowledgeWords.GetData(), KnowledgeWords.Num());
+    
+    auto ReadNameList = [&Names](TArrayView<const uint32> Indices, TArray<FName>& OutNames)
+    {
+        OutNames.Reset(Indices.Num());
+        for (uint32 Index : Indices)
+        {
+            const FName Name = GetName(Names, Index);
+            if (Name != NAME_None)
+            {
+                OutNames.Add(Name);
+            }
+        }
+    };
+    
+    auto ReadFloatMap = [&Names](TArrayView<const FNameFloatRecord> Records, TMap<FName, float>& OutValues)
+    {
+        OutValues.Reset();
+        OutValues.Reserve(Records.Num());
+        for (const FNameFloatRecord& Record : Records)
+        {
+            const FName Name = GetName(Names, Record.Name);
+            if (Name != NAME_None)
+            {
+                OutValues.Add(Name, Record.Value);
+            }
+        }
+    };
+    
+    ReadNameList(RuntimeFlags, OutSaveGame.RuntimeKnowledgeFlags);
+    ReadFloatMap(RelationshipRecords, OutSaveGame.NPCRelationships);
+    ReadFloatMap(GrowthRecords, OutSaveGame.PlayerGrowthValues);
+    ReadNameList(LocationNames, OutSaveGame.DiscoveredLocations);
+    ReadNameList(ItemNames, OutSaveGame.PersistentItems);
+    
+    OutSaveGame.PersistentQuestProgress.Reset();
+    OutSaveGame.PersistentQuestProgress.Reserve(ProgressRecords.Num());
+    for (const FNameIntRecord& Record : ProgressRecords)
+    {
+        const FName Name = GetName(Names, Record.Name);
+        if (Name != NAME_None)
+        {
+            OutSaveGame.PersistentQuestProgress.Add(Name, Record.Value);
+        }
+    }
+    
+    OutSaveGame.PersistentQuests.Reset(QuestRecords.Num());
+    for (const FQuestRecord& Record : QuestRecords)
+    {
+        const FName Name = GetName(Names, Record.Name);
+        if (Name == NAME_None || (uint64)Record.FirstWord + Record.NumWords > (uint64)QuestWords.Num())
+        {
+            continue;
+        }
+        
+        FSavedQuestProgress& Quest = OutSaveGame.PersistentQuests.AddDefaulted_GetRef();
+        Quest.QuestId = Name;
+        Quest.State = Record.State;
+        Quest.ObjectiveLayoutHash = Record.ObjectiveLayoutHash;
+        Quest.CompletedObjectives = TArray<uint64>(QuestWords.GetData() + Record.FirstWord, Record.NumWords);
+    }
+    
+    return true;
+}
+
+bool FTimeLoopSaveArchive::SaveToFile(const UTimeLoopSaveGame& SaveGame, const FString& Path)
+{
+    return SaveToFile(SaveGame, Path, ESaveCompression::None);
+}
+
+bool FTimeLoopSaveArchive::SaveToFile(const UTimeLoopSaveGame& SaveGame, const FString& Path, ESaveCompression Compression, uint32* OutBodyCrc)
+{
+    TArray<uint8> Body;
+    Write(SaveGame, Body);
+    
+    if (Compression != ESaveCompression::None)
+    {
+        TArray<uint8> Compressed;
+        Compress(Body, Compressed, Compression);
+        Body = MoveTemp(Compressed);
+    }
+    
+    FSlotSummary Summary;
+    FMemory::Memzero(Summary);
+    Summary.Magic = SummaryMagic;
+    Summary.Version = Version;
+    FillSummary(SaveGame, Summary);
+    Summary.BodyCrc = FCrc::MemCrc32(Body.GetData(), Body.Num());
+    Summary.BodySize = Body.Num();
+    if (SaveGame.Thumbnail.Num() > 0)
+    {
+        Summary.ThumbnailOffset = sizeof(FSlotSummary) + Body.Num();
+        Summary.ThumbnailSize = SaveGame.Thumbnail.Num();
+    }
+    Summary.SummaryCrc = ComputeSummaryCrc(Summary);
+    
+    TArray<uint8> Bytes;
+    Bytes.Reserve(sizeof(FSlotSummary) + Body.Num() + SaveGame.Thumbnail.Num());
+    Bytes.Append(reinterpret_cast<const uint8*>(&Summary), sizeof(FSlotSummary));
+    Bytes.Append(Body);
+    Bytes.Append(SaveGame.Thumbnail);
+    
+    if (OutBodyCrc)
+    {
+        *OutBodyCrc = Summary.BodyCrc;
+    }
+    if (!WriteFileAtomic(Bytes, Path, true))
+    {
+        return false;
+    }
+    
+    // The new file carries its own summary; a sidecar left from the previous one is out of date
+    IFileManager::Get().Delete(*GetSummaryPath(Path), false, false, true);
+    return true;
+}
+
+void FTimeLoopSaveArchive::FillSummary(const UTimeLoopSaveGame& SaveGame, FSlotSummary& OutSummary)
+{
+    OutSummary.LoopCount = SaveGame.LoopCount;
+    OutSummary.DayMinute = SaveGame.DayMinute;
+    OutSummary.TimestampTicks = SaveGame.SaveTimestamp.GetTicks();
+    OutSummary.PlayTimeSeconds = (uint32)FMath::Max(0, FMath::RoundToInt(SaveGame.PlayTimeSeconds));
+}
+
+bool FTimeLoopSaveArchive::ReadCurrentSummary(const FString& Path, FSlotSummary& OutSummary)
+{
+    if (!ReadSummary(Path, OutSummary))
+    {
+        return false;
+    }
+    
+    // A sidecar written for an older archive at this path no longer applies
+    FSlotSummary Sidecar;
+    if (ReadSummary(GetSummaryPath(Path), Sidecar) && Sidecar.BodyCrc == OutSummary.BodyCrc && Sidecar.BodySize == OutSummary.BodySize)
+    {
+        OutSummary = Sidecar;
+    }
+    return true;
+}
+
+bool FTimeLoopSaveArchive::ReadSummary(const FString& Path, FSlotSummary& OutSummary)
+{
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path, FILEREAD_Silent));
+    if (!Reader || Reader->TotalSize() < (int64)sizeof(FSlotSummary))
+    {
+        return false;
+    }
+    
+    Reader->Serialize(&OutSummary, sizeof(FSlotSummary));
+    return !Reader->IsError() && OutSummary.Magic == SummaryMagic && OutSummary.Version == Version
+        && (OutSummary.SummaryCrc == 0 || OutSummary.SummaryCrc == ComputeSummaryCrc(OutSummary));
+}
+
+uint32 FTimeLoopSaveArchive::ComputeSummaryCrc(const FSlotSummary& Summary)
+{
+    FSlotSummary Copy = Summary;
+    Copy.SummaryCrc = 0;
+    return FCrc::MemCrc32(&Copy, sizeof(FSlotSummary));
+}
+
+bool FTimeLoopSaveArchive::UpdateSummary(const FString& Path, const UTimeLoopSaveGame& SaveGame)
+{
+    FSlotSummary Summary;
+    if (!ReadSummary(Path, Summary))
+    {
+        return false;
+    }
+    
+    // Only display fields change; BodyCrc ties the sidecar to the archive it describes
+    FillSummary(SaveGame, Summary);
+    Summary.SummaryCrc = ComputeSummaryCrc(Summary);
+    
+    // The saved file is never written in place, so a torn write can only lose the sidecar
+    TArray<uint8> Bytes;
+    Bytes.Append(reinterpret_cast<const uint8*>(&Summary), sizeof(FSlotSummary));
+    return WriteFileAtomic(Bytes, GetSummaryPath(Path));
+}
+
+void FTimeLoopSaveArchive::Compress(const TArray<uint8>& ArchiveBytes, TArray<uint8>& OutBytes, ESaveCompression Compression)
+{
+    if (Compression == ESaveCompression::None)
+    {
+        OutBytes = ArchiveBytes;
+        return;
+    }
+    
+    const FName Format = Compression == ESaveCompression::Zlib ? NAME_Zlib : NAME_LZ4;
+    const uint32 ContainerMagic = Compression == ESaveCompression::Zlib ? ZlibCompressedMagic : Lz4CompressedMagic;
+    
+    int32 CompressedSize = FCompression::CompressMemoryBound(Format, ArchiveBytes.Num());
+    OutBytes.SetNumUninitialized(sizeof(FCompressedHeader) + CompressedSize);
+    
+    // Incompressible data is stored as the plain archive
+    if (!FCompression::CompressMemory(Format, OutBytes.GetData() + sizeof(FCompressedHeader), CompressedSize, ArchiveBytes.GetData(), ArchiveBytes.Num())
+        || CompressedSize >= ArchiveBytes.Num())
+    {
+        OutBytes = ArchiveBytes;
+        return;
+    }
+    
+    FCompressedHeader Header;
+    Header.Magic = ContainerMagic;
+    Header.Version = Version;
+    Header.UncompressedSize = ArchiveBytes.Num();
+    Header.CompressedSize = CompressedSize;
+    FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(FCompressedHeader));
+    OutBytes.SetNum(sizeof(FCompressedHeader) + CompressedSize, false);
+}
+
+bool FTimeLoopSaveArchive::Decompress(TArrayView<const uint8> Bytes, TArray<uint8>& OutArchiveBytes)
+{
+    if (Bytes.Num() < (int32)sizeof(FCompressedHeader))
+    {
+        return false;
+    }
+    
+    const FCompressedHeader& Compressed = *reinterpret_cast<const FCompressedHeader*>(Bytes.GetData());
+    const FName Format = GetCompressionFormat(Compressed.Magic);
+    if (Format.IsNone() || Compressed.Version != Version || Compressed.CompressedSize > (uint64)Bytes.Num() - sizeof(FCompressedHeader)
+        || Compressed.UncompressedSize > (uint64)MAX_int32)
+    {
+        return false;
+    }
+    
+    OutArchiveBytes.SetNumUninitialized((int32)Compressed.UncompressedSize);
+    if (!FCompression::UncompressMemory(Format, OutArchiveBytes.GetData(), OutArchiveBytes.Num(), 
+        Bytes.GetData() + sizeof(FCompressedHeader), (int32)Compressed.CompressedSize))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Archive: Failed to decompress archive"));
+        return false;
+    }
+    return true;
+}
+
+bool FTimeLoopSaveArchive::WriteFileAtomic(const TArray<uint8>& Bytes, const FString& Path, bool bKeepBackup)
+{
+    // A crash mid-write leaves the temporary file behind, never a torn save
+    const FString TempPath = Path + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+    {
+        return false;
+    }
+    
+    // The file being replaced becomes the fallback should the new one turn out damaged
+    IFileManager& FileManager = IFileManager::Get();
+    if (bKeepBackup && FileManager.FileExists(*Path))
+    {
+        FileManager.Move(*GetBackupPath(Path), *Path, true, true);
+    }
+    
+    if (!FileManager.Move(*Path, *TempPath, true, true))
+    {
+        FileManager.Delete(*TempPath);
+        return false;
+    }
+    return true;
+}
+
+bool FTimeLoopSaveArchive::LoadFromFile(const FString& Path, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc, bool* bOutUsedBackup)
+{
+    if (bOutUsedBackup)
+    {
+        *bOutUsedBackup = false;
+    }
+    
+    if (LoadSingleFile(Path, OutSaveGame, OutBodyCrc))
+    {
+        return true;
+    }
+    
+    const FString BackupPath = GetBackupPath(Path);
+    if (!IFileManager::Get().FileExists(*BackupPath))
+    {
+        return false;
+    }
+    
+    UE_LOG(LogTemp, Warning, TEXT("Save Archive: %s is missing or damaged, loading the previous copy"), *Path);
+    if (!LoadSingleFile(BackupPath, OutSaveGame, OutBodyCrc))
+    {
+        return false;
+    }
+    
+    if (bOutUsedBackup)
+    {
+        *bOutUsedBackup = true;
+    }
+    return true;
+}
+
+bool FTimeLoopSaveArchive::LoadSingleFile(const FString& Path, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc)
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    
+    // The region must be released before its handle, hence the declaration order
+    TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Path));
+    if (MappedFile)
+    {
+        TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+        if (Region)
+        {
+            return Read(TArrayView<const uint8>(Region->GetMappedPtr(), (int32)Region->GetMappedSize()), OutSaveGame, OutBodyCrc);
+        }
+    }
+    
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+    return Read(Bytes, OutSaveGame, OutBodyCrc);
+}
+
+FString FTimeLoopSaveArchive::GetBackupPath(const FString& Path)
+{
+    return Path + TEXT(".bak");
+}
+
+FString FTimeLoopSaveArchive::GetSummaryPath(const FString& Path)
+{
+    return FPaths::ChangeExtension(Path, TEXT("tlsummary"));
+}
+
+FString FTimeLoopSaveArchive::GetSlotPath(const FString& SlotName)
+{
+    return FPaths::ProjectSavedDir() / TEXT("SaveGames") / (SlotName + TEXT(".tlsave"));
+}
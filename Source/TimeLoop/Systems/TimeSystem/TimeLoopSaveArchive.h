@@ -0,0 +1,197 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTimeLoopSaveGame;
+enum class ESaveCompression : uint8;
+
+/**
+ * FTimeLoopSaveArchive - Compact binary form of UTimeLoopSaveGame
+ *
+ * Layout, every section 8-byte aligned:
+ *   FHeader        magic, version, section count, file size
+ *   FSectionEntry  one per section: id, element count, offset, size
+ *   sections       fixed-layout records; names are uint32 indices into the string table
+ *
+ * Loading memory-maps the file and reads each section in place, converting only the
+ * string table into FNames. Unknown sections are skipped, so newer writers can add
+ * sections without breaking older readers of the same major version. The checksum
+ * section holds a CRC32 of the header and section table and of every other section;
+ * a mismatch fails the load rather than reading damaged records.
+ *
+ * A file may instead hold the archive compressed behind an FCompressedHeader, whose
+ * magic names the codec; such files are decompressed into memory before reading.
+ *
+ * Saved files start with a fixed-size FSlotSummary ahead of the archive: what a load menu
+ * shows, the archive's size and CRC, and where an optional thumbnail follows it. Listing
+ * slots reads only this summary; loading checks the CRC before trusting the archive.
+ * Saves that only append to a journal never rewrite the file; their newer summary goes to
+ * a <slot>.tlsummary sidecar instead, which counts only while its BodyCrc still matches.
+ *
+ * Replacing a file keeps the previous one beside it as <path>.bak, and loading falls back
+ * to that copy when the file is missing or fails validation, as after a power loss.
+ */
+class TIMELOOP_API FTimeLoopSaveArchive
+{
+public:
+    static constexpr uint32 Magic = 0x56534C54; // "TLSV"
+    static constexpr uint32 Version = 1;
+    static constexpr uint32 ZlibCompressedMagic = 0x5A534C54; // "TLSZ"
+    static constexpr uint32 Lz4CompressedMagic = 0x34534C54; // "TLS4"
+    static constexpr uint32 SummaryMagic = 0x4D534C54; // "TLSM"
+
+    /** Ids of the sections this version writes */
+    enum ESectionId : uint32
+    {
+        Strings = 0x53525453,              // "STRS" uint32 offsets[Count + 1], then UTF-8 text
+        Meta = 0x4154454D,                 // "META" FMetaRecord
+        Knowledge = 0x574F4E4B,            // "KNOW" uint64 words
+        RuntimeKnowledge = 0x574E4B52,     // "RKNW" uint32 names
+        Relationships = 0x534C4552,        // "RELS" FNameFloatRecord
+        GrowthValues = 0x574F5247,         // "GROW" FNameFloatRecord
+        QuestProgressValues = 0x47525051,  // "QPRG" FNameIntRecord
+        PersistentQuests = 0x53545351,     // "QSTS" FQuestRecord
+        PersistentQuestWords = 0x44525751, // "QWRD" uint64 words referenced by FQuestRecord
+        Locations = 0x53434F4C,            // "LOCS" uint32 names
+        Items = 0x4D455449,                // "ITEM" uint32 names
+        Checksums = 0x53435243             // "CRCS" uint32 CRC of header and table, then one per section in table order (0 for this one)
+    };
+
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 NumSections;
+        uint32 Reserved;
+        uint64 FileSize;
+    };
+
+    struct FCompressedHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 UncompressedSize;
+        uint64 CompressedSize;
+    };
+
+    struct FSlotSummary
+    {
+        uint32 Magic;
+        uint32 Version;
+        int32 LoopCount;
+        int32 DayMinute;
+        int64 TimestampTicks;
+        uint32 PlayTimeSeconds;
+        uint32 BodyCrc;
+        uint64 BodySize;
+        uint64 ThumbnailOffset;
+        uint32 ThumbnailSize;
+
+        // CRC of the summary with this field zeroed; 0 means unchecked
+        uint32 SummaryCrc;
+    };
+
+    struct FSectionEntry
+    {
+        uint32 Id;
+        uint32 Count;
+        uint64 Offset;
+        uint64 Size;
+    };
+
+    struct FMetaRecord
+    {
+        int32 LoopCount;
+        int32 KnowledgeLayoutCount;
+        uint32 KnowledgeLayoutHash;
+        uint32 Reserved;
+    };
+
+    struct FNameFloatRecord
+    {
+        uint32 Name;
+        float Value;
+    };
+
+    struct FNameIntRecord
+    {
+        uint32 Name;
+        int32 Value;
+    };
+
+    struct FQuestRecord
+    {
+        uint32 Name;
+        uint32 ObjectiveLayoutHash;
+        uint32 FirstWord;
+        uint16 NumWords;
+        uint8 State;
+        uint8 Reserved;
+    };
+
+    // Serialize a save game
+    static void Write(const UTimeLoopSaveGame& SaveGame, TArray<uint8>& OutBytes);
+
+    // Deserialize a save game, leaving it untouched and returning false if the data is not a valid archive
+    static bool Read(TArrayView<const uint8> Bytes, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc = nullptr);
+
+    // Write a save game to a file, replacing any existing file only once the new one is complete; OutBodyCrc receives the archive's CRC
+    static bool SaveToFile(const UTimeLoopSaveGame& SaveGame, const FString& Path, ESaveCompression Compression, uint32* OutBodyCrc = nullptr);
+    static bool SaveToFile(const UTimeLoopSaveGame& SaveGame, const FString& Path);
+
+    // Wrap archive bytes in a compressed container; incompressible data is kept as is
+    static void Compress(const TArray<uint8>& ArchiveBytes, TArray<uint8>& OutBytes, ESaveCompression Compression);
+
+    // Unwrap a compressed container
+    static bool Decompress(TArrayView<const uint8> Bytes, TArray<uint8>& OutArchiveBytes);
+
+    // Write bytes to a temporary file and rename it over the destination, optionally keeping the old file as <path>.bak
+    static bool WriteFileAtomic(const TArray<uint8>& Bytes, const FString& Path, bool bKeepBackup = false);
+
+    // Read a save game from a memory-mapped file, falling back to a plain read where mapping is unsupported, and to the backup copy if the file is bad
+    static bool LoadFromFile(const FString& Path, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc = nullptr, bool* bOutUsedBackup = nullptr);
+
+    // Read just the summary at the front of a saved file
+    static bool ReadSummary(const FString& Path, FSlotSummary& OutSummary);
+
+    // Read the newest summary of a saved file, preferring its sidecar while that still describes the same archive
+    static bool ReadCurrentSummary(const FString& Path, FSlotSummary& OutSummary);
+
+    // Record the summary of a newer snapshot of the same archive in the sidecar, leaving the saved file untouched
+    static bool UpdateSummary(const FString& Path, const UTimeLoopSaveGame& SaveGame);
+
+    // Path of the summary sidecar of a saved file
+    static FString GetSummaryPath(const FString& Path);
+
+    // Path of the archive for a save slot
+    static FString GetSlotPath(const FString& SlotName);
+
+    // Path of the previous good copy of a file
+    static FString GetBackupPath(const FString& Path);
+
+private:
+    // Fill a summary's display fields from a save game
+    static void FillSummary(const UTimeLoopSaveGame& SaveGame, FSlotSummary& OutSummary);
+
+    // CRC of a summary excluding its own checksum field
+    static uint32 ComputeSummaryCrc(const FSlotSummary& Summary);
+
+    // Load one copy of a file, without falling back
+    static bool LoadSingleFile(const FString& Path, UTimeLoopSaveGame& OutSaveGame, uint32* OutBodyCrc);
+};
@@ -19,4 +19,8 @@ UTimeLoopSaveGame::UTimeLoopSaveGame()
 {
     // Initialize with default values
     LoopCount = 1;
+    KnowledgeLayoutCount = 0;
+    KnowledgeLayoutHash = 0;
+    DayMinute = 0;
+    PlayTimeSeconds = 0.0f;
 }
@@ -19,6 +19,48 @@
 #include "GameFramework/SaveGame.h"
 #include "TimeLoopSaveGame.generated.h"
 
+/**
+ * ESaveCompression - Codec save archives are compressed with
+ */
+UENUM(BlueprintType)
+enum class ESaveCompression : uint8
+{
+	None UMETA(DisplayName = "None"),
+	LZ4 UMETA(DisplayName = "LZ4"),
+	Zlib UMETA(DisplayName = "Zlib")
+};
+
+/**
+ * FSavedQuestProgress - Progress of a quest that persists across loops
+ * Objective completion is packed one bit per objective; the layout hash of the quest's
+ * objective IDs detects content changes that would make the bits line up differently.
+ */
+USTRUCT()
+struct FSavedQuestProgress
+{
+	GENERATED_BODY()
+	
+	UPROPERTY()
+	FName QuestId;
+	
+	// EQuestState value
+	UPROPERTY()
+	uint8 State;
+	
+	UPROPERTY()
+	TArray<uint64> CompletedObjectives;
+	
+	UPROPERTY()
+	uint32 ObjectiveLayoutHash;
+	
+	FSavedQuestProgress()
+		: QuestId(NAME_None)
+		, State(0)
+		, ObjectiveLayoutHash(0)
+	{
+	}
+};
+
 /**
  * UTimeLoopSaveGame - Stores persistent game data across time loops
  * This save game handles information that should persist when a time loop occurs
@@ -35,14 +77,30 @@ public:
 	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
 	int32 LoopCount;
 	
-	// Knowledge flags that the player has discovered
+	// Knowledge flags that the player has discovered, packed by knowledge registry bit
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
+	TArray<uint64> KnowledgeBits;
+	
+	// Number of manifest flags the knowledge bits were saved against
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
+	int32 KnowledgeLayoutCount;
+	
+	// Hash of the manifest flag names the knowledge bits were saved against
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
+	uint32 KnowledgeLayoutHash;
+	
+	// Known flags that were not in the manifest and so have no stable bit
 	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
-	TMap<FName, bool> KnowledgeFlags;
+	TArray<FName> RuntimeKnowledgeFlags;
 	
 	// Quest progress that persists between loops
 	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
 	TMap<FName, int32> PersistentQuestProgress;
 	
+	// State and objective progress of quests that persist across loops
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
+	TArray<FSavedQuestProgress> PersistentQuests;
+	
 	// NPC relationship values
 	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
 	TMap<FName, float> NPCRelationships;
@@ -58,4 +116,20 @@ public:
 	// Items that persist between loops (e.g., special keys)
 	UPROPERTY(VisibleAnywhere, Category = "Time Loop")
 	TArray<FName> PersistentItems;
+	
+	// Clock time of the save, in minutes after midnight
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop|Slot")
+	int32 DayMinute;
+	
+	// When the save was made (UTC)
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop|Slot")
+	FDateTime SaveTimestamp;
+	
+	// Total time played across sessions
+	UPROPERTY(VisibleAnywhere, Category = "Time Loop|Slot")
+	float PlayTimeSeconds;
+	
+	// Encoded image shown in the load menu; not read back when loading the save itself
+	UPROPERTY()
+	TArray<uint8> Thumbnail;
 };
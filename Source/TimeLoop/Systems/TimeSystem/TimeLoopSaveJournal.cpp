@@ -0,0 +1,495 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "TimeLoopSaveJournal.h"
+#include "TimeLoopSaveArchive.h"
+#include "TimeLoopSaveGame.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    /** Operations a delta record is made of; names are serialized as strings */
+    enum class EDeltaOp : uint8
+    {
+        LoopCount,          // int32
+        KnowledgeWord,      // int32 index, uint64 word
+        AddRuntimeFlag,     // name
+        RemoveRuntimeFlag,  // name
+        SetQuestProgress,   // name, int32
+        RemoveQuestProgress,// name
+        SetQuest,           // name, uint8 state, uint32 layout hash, uint64 words
+        RemoveQuest,        // name
+        SetRelationship,    // name, float
+        RemoveRelationship, // name
+        SetGrowth,          // name, float
+        RemoveGrowth,       // name
+        AddLocation,        // name
+        RemoveLocation,     // name
+        AddItem,            // name
+        RemoveItem,         // name
+        Progress            // int32 day minute, int64 timestamp ticks, float play time
+    };
+
+    void WriteOp(FArchive& Ar, EDeltaOp Op, int32& NumOps)
+    {
+        uint8 OpByte = static_cast<uint8>(Op);
+        Ar << OpByte;
+        ++NumOps;
+    }
+
+    void WriteNameOp(FArchive& Ar, EDeltaOp Op, FName Name, int32& NumOps)
+    {
+        WriteOp(Ar, Op, NumOps);
+        Ar << Name;
+    }
+
+    template <typename ValueType>
+    void DiffMap(FArchive& Ar, const TMap<FName, ValueType>& Base, const TMap<FName, ValueType>& Target, EDeltaOp SetOp, EDeltaOp RemoveOp, int32& NumOps)
+    {
+        for (const TPair<FName, ValueType>& Pair : Target)
+        {
+            const ValueType* BaseValue = Base.Find(Pair.Key);
+            if (!BaseValue || *BaseValue != Pair.Value)
+            {
+                FName Name = Pair.Key;
+                ValueType Value = Pair.Value;
+                WriteNameOp(Ar, SetOp, Name, NumOps);
+                Ar << Value;
+            }
+        }
+        
+        for (const TPair<FName, ValueType>& Pair : Base)
+        {
+            if (!Target.Contains(Pair.Key))
+            {
+                WriteNameOp(Ar, RemoveOp, Pair.Key, NumOps);
+            }
+        }
+    }
+
+    void DiffNames(FArchive& Ar, const TArray<FName>& Base, const TArray<FName>& Target, EDeltaOp AddOp, EDeltaOp RemoveOp, int32& NumOps)
+    {
+        // These lists are sets in practice; order is not preserved
+        const TSet<FName> BaseSet(Base);
+        const TSet<FName> TargetSet(Target);
+        
+        for (const FName& Name : Target)
+        {
+            if (!BaseSet.Contains(Name))
+            {
+                WriteNameOp(Ar, AddOp, Name, NumOps);
+            }
+        }
+        
+        for (const FName& Name : Base)
+        {
+            if (!TargetSet.Contains(Name))
+            {
+                WriteNameOp(Ar, RemoveOp, Name, NumOps);
+            }
+        }
+    }
+
+    const FSavedQuestProgress* FindQuest(const TArray<FSavedQuestProgress>& Quests, FName QuestId)
+    {
+        return Quests.FindByPredicate([QuestId](const FSavedQuestProgress& Quest) { return Quest.QuestId == QuestId; });
+    }
+}
+
+bool FTimeLoopSaveJournal::WriteDelta(const UTimeLoopSaveGame& Base, const UTimeLoopSaveGame& Target, TArray<uint8>& OutBytes)
+{
+    OutBytes.Reset();
+    
+    // Knowledge bits saved against a different manifest do not line up word for word
+    if (Base.KnowledgeLayoutCount != Target.KnowledgeLayoutCount
+        || Base.KnowledgeLayoutHash != Target.KnowledgeLayoutHash
+        || Base.KnowledgeBits.Num() != Target.KnowledgeBits.Num())
+    {
+        return false;
+    }
+    
+    FMemoryWriter Ar(OutBytes);
+    int32 NumOps = 0;
+    
+    // Play time and the clock move on every save, and only the archive's summary held them
+    if (Base.DayMinute != Target.DayMinute || Base.SaveTimestamp != Target.SaveTimestamp || Base.PlayTimeSeconds != Target.PlayTimeSeconds)
+    {
+        int32 DayMinute = Target.DayMinute;
+        int64 TimestampTicks = Target.SaveTimestamp.GetTicks();
+        float PlayTimeSeconds = Target.PlayTimeSeconds;
+        WriteOp(Ar, EDeltaOp::Progress, NumOps);
+        Ar << DayMinute << TimestampTicks << PlayTimeSeconds;
+    }
+    
+    if (Base.LoopCount != Target.LoopCount)
+    {
+        int32 LoopCount = Target.LoopCount;
+        WriteOp(Ar, EDeltaOp::LoopCount, NumOps);
+        Ar << LoopCount;
+    }
+    
+    for (int32 WordIndex = 0; WordIndex < Target.KnowledgeBits.Num(); ++WordIndex)
+    {
+        if (Base.KnowledgeBits[WordIndex] != Target.KnowledgeBits[WordIndex])
+        {
+            int32 Index = WordIndex;
+            uint64 Word = Target.KnowledgeBits[WordIndex];
+            WriteOp(Ar, EDeltaOp::KnowledgeWord, NumOps);
+            Ar << Index << Word;
+        }
+    }
+    
+    DiffNames(Ar, Base.RuntimeKnowledgeFlags, Target.RuntimeKnowledgeFlags, EDeltaOp::AddRuntimeFlag, EDeltaOp::RemoveRuntimeFlag, NumOps);
+    DiffMap(Ar, Base.PersistentQuestProgress, Target.PersistentQuestProgress, EDeltaOp::SetQuestProgress, EDeltaOp::RemoveQuestProgress, NumOps);
+    
+    for (const FSavedQuestProgress& Quest : Target.PersistentQuests)
+    {
+        const FSavedQuestProgress* BaseQuest = FindQuest(Base.PersistentQuests, Quest.QuestId);
+        if (!BaseQuest
+            || BaseQuest->State != Quest.State
+            || BaseQuest->ObjectiveLayoutHash != Quest.ObjectiveLayoutHash
+            || BaseQuest->CompletedObjectives != Quest.CompletedObjectives)
+        {
+            FSavedQuestProgress Copy = Quest;
+            WriteNameOp(Ar, EDeltaOp::SetQuest, Copy.QuestId, NumOps);
+            Ar << Copy.State << Copy.ObjectiveLayoutHash << Copy.CompletedObjectives;
+        }
+    }
+    
+    for (const FSavedQuestProgress& Quest : Base.PersistentQuests)
+    {
+        if (!FindQuest(Target.PersistentQuests, Quest.QuestId))
+        {
+            WriteNameOp(Ar, EDeltaOp::RemoveQuest, Quest.QuestId, NumOps);
+        }
+    }
+    
+    DiffMap(Ar, Base.NPCRelationships, Target.NPCRelationships, EDeltaOp::SetRelationship, EDeltaOp::RemoveRelationship, NumOps);
+    DiffMap(Ar, Base.PlayerGrowthValues, Target.PlayerGrowthValues, EDeltaOp::SetGrowth, EDeltaOp::RemoveGrowth, NumOps);
+    DiffNames(Ar, Base.DiscoveredLocations, Target.DiscoveredLocations, EDeltaOp::AddLocation, EDeltaOp::RemoveLocation, NumOps);
+    DiffNames(Ar, Base.PersistentItems, Target.PersistentItems, EDeltaOp::AddItem, EDeltaOp::RemoveItem, NumOps);
+    
+    return true;
+}
+
+bool FTimeLoopSaveJournal::ApplyDelta(TArrayView<const uint8> Bytes, UTimeLoopSaveGame& SaveGame)
+{
+    FMemoryReaderView Ar(Bytes);
+    
+    while (!Ar.AtEnd())
+    {
+        uint8 OpByte = 0;
+        Ar << OpByte;
+        
+        FName Name;
+        const EDeltaOp Op = static_cast<EDeltaOp>(OpByte);
+        if (Op != EDeltaOp::LoopCount && Op != EDeltaOp::KnowledgeWord && Op != EDeltaOp::Progress)
+        {
+            Ar << Name;
+        }
+        
+        switch (Op)
+        {
+        case EDeltaOp::LoopCount:
+            Ar << SaveGame.LoopCount;
+            break;
+            
+        case EDeltaOp::Progress:
+        {
+            int64 TimestampTicks = 0;
+            Ar << SaveGame.DayMinute << TimestampTicks << SaveGame.PlayTimeSeconds;
+            SaveGame.SaveTimestamp = FDateTime(TimestampTicks);
+            break;
+        }
+        
+        case EDeltaOp::KnowledgeWord:
+        {
+            int32 Index = 0;
+            uint64 Word = 0;
+            Ar << Index << Word;
+            if (!SaveGame.KnowledgeBits.IsValidIndex(Index))
+            {
+                return false;
+            }
+            SaveGame.KnowledgeBits[Index] = Word;
+            break;
+        }
+        
+        case EDeltaOp::AddRuntimeFlag:
+            SaveGame.RuntimeKnowledgeFlags.AddUnique(Name);
+            break;
+            
+        case EDeltaOp::RemoveRuntimeFlag:
+            SaveGame.RuntimeKnowledgeFlags.Remove(Name);
+            break;
+            
+        case EDeltaOp::SetQuestProgress:
+            Ar << SaveGame.PersistentQuestProgress.FindOrAdd(Name);
+            break;
+            
+        case EDeltaOp::RemoveQuestProgress:
+            SaveGame.PersistentQuestProgress.Remove(Name);
+            break;
+            
+        case EDeltaOp::SetQuest:
+        {
+            FSavedQuestProgress* Quest = SaveGame.PersistentQuests.FindByPredicate([Name](const FSavedQuestProgress& Saved) { return Saved.QuestId == Name; });
+            if (!Quest)
+            {
+                Quest = &SaveGame.PersistentQuests.AddDefaulted_GetRef();
+                Quest->QuestId = Name;
+            }
+            Ar << Quest->State << Quest->ObjectiveLayoutHash << Quest->CompletedObjectives;
+            break;
+        }
+        
+        case EDeltaOp::RemoveQuest:
+            SaveGame.PersistentQuests.RemoveAll([Name](const FSavedQuestProgress& Saved) { return Saved.QuestId == Name; });
+            break;
+            
+        case EDeltaOp::SetRelationship:
+            Ar << SaveGame.NPCRelationships.FindOrAdd(Name);
+            break;
+            
+        case EDeltaOp::RemoveRelationship:
+            SaveGame.NPCRelationships.Remove(Name);
+            break;
+            
+        case EDeltaOp::SetGrowth:
+            Ar << SaveGame.PlayerGrowthValues.FindOrAdd(Name);
+            break;
+            
+        case EDeltaOp::RemoveGrowth:
+            SaveGame.PlayerGrowthValues.Remove(Name);
+            break;
+            
+        case EDeltaOp::AddLocation:
+            SaveGame.DiscoveredLocations.AddUnique(Name);
+            break;
+            
+        case EDeltaOp::RemoveLocation:
+            SaveGame.DiscoveredLocations.Remove(Name);
+            break;
+            
+        case EDeltaOp::AddItem:
+            SaveGame.PersistentItems.AddUnique(Name);
+            break;
+            
+        case EDeltaOp::RemoveItem:
+            SaveGame.PersistentItems.Remove(Name);
+            break;
+            
+        default:
+            return false;
+        }
+        
+        if (Ar.IsError())
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool FTimeLoopSaveJournal::LoadFromFile(const FString& CheckpointPath, UTimeLoopSaveGame& OutSaveGame)
+{
+    uint32 CheckpointCrc = 0;
+    bool bUsedBackup = false;
+    if (!FTimeLoopSaveArchive::LoadFromFile(CheckpointPath, OutSaveGame, &CheckpointCrc, &bUsedBackup))
+    {
+        return false;
+    }
+    
+    const FString JournalPath = GetJournalPath(CheckpointPath);
+    if (!bUsedBackup)
+    {
+        if (IFileManager::Get().FileExists(*JournalPath) && !ReplayJournal(JournalPath, CheckpointCrc, OutSaveGame))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Journal: Ignoring journal that does not belong to checkpoint %s"), *CheckpointPath);
+        }
+        return true;
+    }
+    
+    // The previous checkpoint's journal was moved aside at compaction, unless the crash came before the new journal was written
+    const FString BackupJournalPath = FTimeLoopSaveArchive::GetBackupPath(JournalPath);
+    if (ReplayJournal(BackupJournalPath, CheckpointCrc, OutSaveGame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Journal: Fell back to the previous checkpoint of %s and its journal %s"), *CheckpointPath, *BackupJournalPath);
+    }
+    else if (ReplayJournal(JournalPath, CheckpointCrc, OutSaveGame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Journal: Fell back to the previous checkpoint of %s and its journal %s"), *CheckpointPath, *JournalPath);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Journal: Fell back to the previous checkpoint of %s, no journal belongs to it"), *CheckpointPath);
+    }
+    return true;
+}
+
+bool FTimeLoopSaveJournal::ReplayJournal(const FString& JournalPath, uint32 CheckpointCrc, UTimeLoopSaveGame& SaveGame)
+{
+    TArray<uint8> Journal;
+    if (!FFileHelper::LoadFileToArray(Journal, *JournalPath, FILEREAD_Silent) || Journal.Num() < (int32)sizeof(FHeader))
+    {
+        return false;
+    }
+    
+    FHeader Header;
+    FMemory::Memcpy(&Header, Journal.GetData(), sizeof(FHeader));
+    if (Header.Magic != Magic || Header.Version != Version || Header.CheckpointCrc != CheckpointCrc)
+    {
+        return false;
+    }
+    
+    int64 Offset = sizeof(FHeader);
+    int32 NumReplayed = 0;
+    while (Offset + (int64)sizeof(FRecordHeader) <= Journal.Num())
+    {
+        FRecordHeader Record;
+        FMemory::Memcpy(&Record, Journal.GetData() + Offset, sizeof(FRecordHeader));
+        const int64 PayloadOffset = Offset + sizeof(FRecordHeader);
+        
+        // Anything past a torn or corrupt record was never acknowledged as saved
+        if (Record.Magic != RecordMagic
+            || Record.Sequence != (uint32)NumReplayed
+            || PayloadOffset + (int64)Record.Size > Journal.Num()
+            || FCrc::MemCrc32(Journal.GetData() + PayloadOffset, Record.Size) != Record.Crc)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Save Journal: Discarding damaged journal tail after %d records"), NumReplayed);
+            break;
+        }
+        
+        if (!ApplyDelta(TArrayView<const uint8>(Journal.GetData() + PayloadOffset, Record.Size), SaveGame))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Save Journal: Record %d could not be applied"), NumReplayed);
+            break;
+        }
+        
+        Offset = PayloadOffset + Record.Size;
+        ++NumReplayed;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Save Journal: Replayed %d records from %s"), NumReplayed, *JournalPath);
+    return true;
+}
+
+FString FTimeLoopSaveJournal::GetJournalPath(const FString& CheckpointPath)
+{
+    return FPaths::ChangeExtension(CheckpointPath, TEXT("tljournal"));
+}
+
+bool FTimeLoopSaveJournal::Commit(const UTimeLoopSaveGame* Base, const UTimeLoopSaveGame& Snapshot, const FString& CheckpointPath, ESaveCompression Compression)
+{
+    // Deltas are only meaningful against what this journal last committed to the same checkpoint
+    if (!Base || CheckpointPath != CheckpointPathInUse || JournalSize >= CompactionThreshold)
+    {
+        return WriteCheckpoint(Snapshot, CheckpointPath, Compression);
+    }
+    
+    TArray<uint8> Payload;
+    if (!WriteDelta(*Base, Snapshot, Payload))
+    {
+        return WriteCheckpoint(Snapshot, CheckpointPath, Compression);
+    }
+    
+    // Nothing changed since the last save, not even the clock
+    if (Payload.Num() == 0)
+    {
+        FTimeLoopSaveArchive::UpdateSummary(CheckpointPath, Snapshot);
+        return true;
+    }
+    
+    if (!AppendRecord(Payload, GetJournalPath(CheckpointPath)))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Save Journal: Append failed, writing a checkpoint instead"));
+        return WriteCheckpoint(Snapshot, CheckpointPath, Compression);
+    }
+    
+    // Keep the slot summary a load menu reads in step with the journal
+    FTimeLoopSaveArchive::UpdateSummary(CheckpointPath, Snapshot);
+    
+    UE_LOG(LogTemp, Log, TEXT("Save Journal: Appended %d byte delta (journal now %lld bytes)"), Payload.Num(), JournalSize);
+    return true;
+}
+
+bool FTimeLoopSaveJournal::WriteCheckpoint(const UTimeLoopSaveGame& Snapshot, const FString& CheckpointPath, ESaveCompression Compression)
+{
+    // Until both files are written, nothing may be appended
+    CheckpointPathInUse.Reset();
+    
+    // The old journal stops matching as soon as the new checkpoint lands, so a crash in between loses nothing;
+    // the old checkpoint moves to its .bak, and the old journal follows it once the new journal is written
+    uint32 CheckpointCrc = 0;
+    if (!FTimeLoopSaveArchive::SaveToFile(Snapshot, CheckpointPath, Compression, &CheckpointCrc))
+    {
+        return false;
+    }
+    
+    FHeader Header;
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.CheckpointCrc = CheckpointCrc;
+    Header.Reserved = 0;
+    
+    TArray<uint8> HeaderBytes;
+    HeaderBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+    if (!FTimeLoopSaveArchive::WriteFileAtomic(HeaderBytes, GetJournalPath(CheckpointPath), true))
+    {
+        // The checkpoint alone is a complete save; the next commit simply checkpoints again
+        return true;
+    }
+    
+    CheckpointPathInUse = CheckpointPath;
+    JournalSize = sizeof(FHeader);
+    NextSequence = 0;
+    
+    UE_LOG(LogTemp, Log, TEXT("Save Journal: Wrote checkpoint %s"), *CheckpointPath);
+    return true;
+}
+
+bool FTimeLoopSaveJournal::AppendRecord(const TArray<uint8>& Payload, const FString& JournalPath)
+{
+    FRecordHeader Record;
+    Record.Magic = RecordMagic;
+    Record.Size = Payload.Num();
+    Record.Crc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+    Record.Sequence = NextSequence;
+    
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*JournalPath, FILEWRITE_Append));
+    if (!Writer)
+    {
+        return false;
+    }
+    
+    Writer->Serialize(&Record, sizeof(FRecordHeader));
+    Writer->Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+    Writer->Flush();
+    if (!Writer->Close())
+    {
+        return false;
+    }
+    
+    JournalSize += sizeof(FRecordHeader) + Payload.Num();
+    ++NextSequence;
+    return true;
+}
@@ -0,0 +1,103 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTimeLoopSaveGame;
+enum class ESaveCompression : uint8;
+
+/**
+ * FTimeLoopSaveJournal - Append-only log of save deltas on top of a full checkpoint
+ *
+ * The checkpoint is the save archive at the slot path; the journal beside it holds one
+ * record per save, each the changes since the previous one. Saving appends only what
+ * changed, so its cost follows the loop rather than the size of the whole save. Records
+ * also carry the day minute, timestamp and play time, which a checkpoint keeps only in its
+ * summary. Once the journal outgrows CompactionThreshold the next save writes a fresh
+ * checkpoint and starts an empty journal instead.
+ *
+ * Layout:
+ *   FHeader        magic, version, CRC of the checkpoint archive the journal applies to
+ *   records        FRecordHeader (magic, payload size, payload CRC, sequence), then delta ops
+ *
+ * Loading replays records in order and stops at the first torn or corrupt one, so a crash
+ * mid-append loses only that save. A journal whose checkpoint CRC does not match the
+ * checkpoint on disk was left behind by a compaction and is ignored.
+ *
+ * Compaction keeps the previous journal as <journal>.bak beside the previous checkpoint,
+ * so when loading falls back to that checkpoint its acknowledged deltas are replayed too.
+ *
+ * Commit is not thread-safe; calls must be serialized, as FTimeLoopAsyncSaver does.
+ */
+class TIMELOOP_API FTimeLoopSaveJournal
+{
+public:
+    static constexpr uint32 Magic = 0x4E4A4C54; // "TLJN"
+    static constexpr uint32 Version = 1;
+    static constexpr uint32 RecordMagic = 0x524A4C54; // "TLJR"
+
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 CheckpointCrc;
+        uint32 Reserved;
+    };
+
+    struct FRecordHeader
+    {
+        uint32 Magic;
+        uint32 Size;
+        uint32 Crc;
+        uint32 Sequence;
+    };
+
+    // Encode the changes that turn Base into Target; false when they cannot be expressed as a delta
+    static bool WriteDelta(const UTimeLoopSaveGame& Base, const UTimeLoopSaveGame& Target, TArray<uint8>& OutBytes);
+
+    // Apply encoded changes to a save game
+    static bool ApplyDelta(TArrayView<const uint8> Bytes, UTimeLoopSaveGame& SaveGame);
+
+    // Load a checkpoint and replay its journal over it
+    static bool LoadFromFile(const FString& CheckpointPath, UTimeLoopSaveGame& OutSaveGame);
+
+    // Path of the journal belonging to a checkpoint
+    static FString GetJournalPath(const FString& CheckpointPath);
+
+    // Persist a snapshot; Base is the snapshot last committed to the same path, or null if there is none
+    bool Commit(const UTimeLoopSaveGame* Base, const UTimeLoopSaveGame& Snapshot, const FString& CheckpointPath, ESaveCompression Compression);
+
+    // Journal size that triggers compaction into a new checkpoint
+    int64 CompactionThreshold = 256 * 1024;
+
+private:
+    // Replay a journal over the checkpoint it belongs to; false if the file is missing or belongs to another checkpoint
+    static bool ReplayJournal(const FString& JournalPath, uint32 CheckpointCrc, UTimeLoopSaveGame& SaveGame);
+
+    // Write a full checkpoint and start an empty journal for it
+    bool WriteCheckpoint(const UTimeLoopSaveGame& Snapshot, const FString& CheckpointPath, ESaveCompression Compression);
+
+    // Append one delta record to the journal
+    bool AppendRecord(const TArray<uint8>& Payload, const FString& JournalPath);
+
+    // Checkpoint the journal currently appends to; empty until one has been written
+    FString CheckpointPathInUse;
+
+    int64 JournalSize = 0;
+    uint32 NextSequence = 0;
+};
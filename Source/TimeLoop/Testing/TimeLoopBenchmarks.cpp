@@ -0,0 +1,653 @@
+// Copyright (C) 2025 Squeezle Canada
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "TimeLoopBenchmarks.h"
+#include "TimeLoop/Systems/TimeSystem/TimeLoopSaveGame.h"
+#include "TimeLoop/Systems/TimeSystem/TimeLoopSaveArchive.h"
+#include "TimeLoop/Systems/TimeSystem/TimeLoopSaveJournal.h"
+#include "TimeLoop/Systems/TimeSystem/LoopHistory.h"
+#include "TimeLoop/Systems/RuleSystem/RuleSystem.h"
+#include "TimeLoop/Components/InventoryComponent.h"
+#include "TimeLoop/UI/Widgets/InventoryWidget.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectArray.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // Scratch file for a benchmark, kept out of the player's save directory
+    FString GetBenchmarkPath(const TCHAR* FileName)
+    {
+        return FPaths::ProjectIntermediateDir() / TEXT("Benchmarks") / FileName;
+    }
+    
+    // A save game shaped like a late playthrough
+    UTimeLoopSaveGame* MakeBenchmarkSaveGame(int32 NumFlags, int32 NumNPCs)
+    {
+        UTimeLoopSaveGame* SaveGame = NewObject<UTimeLoopSaveGame>();
+        SaveGame->LoopCount = 42;
+        
+        SaveGame->KnowledgeBits.SetNumZeroed((NumFlags + 63) / 64);
+        for (int32 Bit = 0; Bit < NumFlags; Bit += 2)
+        {
+            SaveGame->KnowledgeBits[Bit >> 6] |= (uint64)1 << (Bit & 63);
+        }
+        SaveGame->KnowledgeLayoutCount = NumFlags;
+        
+        for (int32 FlagIndex = 0; FlagIndex < NumFlags; ++FlagIndex)
+        {
+            SaveGame->RuntimeKnowledgeFlags.Add(FName(*FString::Printf(TEXT("Benchmark_Flag_%d"), FlagIndex)));
+        }
+        
+        for (int32 NPCIndex = 0; NPCIndex < NumNPCs; ++NPCIndex)
+        {
+            const FName NPCId(*FString::Printf(TEXT("Benchmark_NPC_%d"), NPCIndex));
+            SaveGame->NPCRelationships.Add(NPCId, (NPCIndex % 200) - 100.0f);
+            SaveGame->PlayerGrowthValues.Add(NPCId, NPCIndex * 0.01f);
+            SaveGame->PersistentQuestProgress.Add(NPCId, NPCIndex);
+            
+            FSavedQuestProgress& Quest = SaveGame->PersistentQuests.AddDefaulted_GetRef();
+            Quest.QuestId = NPCId;
+            Quest.State = 2;
+            Quest.CompletedObjectives.Add(0x5555);
+            Quest.ObjectiveLayoutHash = NPCIndex;
+        }
+        
+        return SaveGame;
+    }
+}
+
+FString UTimeLoopBenchmarks::BenchmarkSaveFormats(int32 NumFlags, int32 NumNPCs, int32 Iterations)
+{
+    Iterations = FMath::Max(1, Iterations);
+    UTimeLoopSaveGame* SaveGame = MakeBenchmarkSaveGame(NumFlags, NumNPCs);
+    
+    const FString SlotName = TEXT("TimeLoopBenchmark");
+    const FString ArchivePath = GetBenchmarkPath(TEXT("TimeLoopBenchmark.tlsave"));
+    
+    // Tagged-property slot save
+    double SlotSaveSeconds = 0.0;
+    double SlotLoadSeconds = 0.0;
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        double StartTime = FPlatformTime::Seconds();
+        UGameplayStatics::SaveGameToSlot(SaveGame, SlotName, 0);
+        SlotSaveSeconds += FPlatformTime::Seconds() - StartTime;
+        
+        StartTime = FPlatformTime::Seconds();
+        UGameplayStatics::LoadGameFromSlot(SlotName, 0);
+        SlotLoadSeconds += FPlatformTime::Seconds() - StartTime;
+    }
+    
+    TArray<uint8> SlotBytes;
+    UGameplayStatics::SaveGameToMemory(SaveGame, SlotBytes);
+    
+    // Binary archive
+    double ArchiveSaveSeconds = 0.0;
+    double ArchiveLoadSeconds = 0.0;
+    bool bArchiveValid = true;
+    UTimeLoopSaveGame* Loaded = NewObject<UTimeLoopSaveGame>();
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        double StartTime = FPlatformTime::Seconds();
+        FTimeLoopSaveArchive::SaveToFile(*SaveGame, ArchivePath);
+        ArchiveSaveSeconds += FPlatformTime::Seconds() - StartTime;
+        
+        StartTime = FPlatformTime::Seconds();
+        bArchiveValid &= FTimeLoopSaveArchive::LoadFromFile(ArchivePath, *Loaded);
+        ArchiveLoadSeconds += FPlatformTime::Seconds() - StartTime;
+    }
+    
+    TArray<uint8> ArchiveBytes;
+    FTimeLoopSaveArchive::Write(*SaveGame, ArchiveBytes);
+    
+    bArchiveValid &= Loaded->RuntimeKnowledgeFlags == SaveGame->RuntimeKnowledgeFlags
+        && Loaded->KnowledgeBits == SaveGame->KnowledgeBits
+        && Loaded->NPCRelationships.Num() == SaveGame->NPCRelationships.Num()
+        && Loaded->PersistentQuests.Num() == SaveGame->PersistentQuests.Num();
+    
+    UGameplayStatics::DeleteGameInSlot(SlotName, 0);
+    IFileManager::Get().Delete(*ArchivePath);
+    IFileManager::Get().Delete(*FTimeLoopSaveArchive::GetBackupPath(ArchivePath));
+    
+    const FString Summary = FString::Printf(
+        TEXT("Save formats (%d flags, %d NPCs, %d runs): slot %d bytes, save %.3f ms, load %.3f ms | archive %d bytes, save %.3f ms, load %.3f ms%s"),
+        NumFlags, NumNPCs, Iterations,
+        SlotBytes.Num(), SlotSaveSeconds * 1000.0 / Iterations, SlotLoadSeconds * 1000.0 / Iterations,
+        ArchiveBytes.Num(), ArchiveSaveSeconds * 1000.0 / Iterations, ArchiveLoadSeconds * 1000.0 / Iterations,
+        bArchiveValid ? TEXT("") : TEXT(" (ARCHIVE ROUND TRIP FAILED)"));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkSaveCompression(int32 NumFlags, int32 NumNPCs, int32 Iterations)
+{
+    Iterations = FMath::Max(1, Iterations);
+    UTimeLoopSaveGame* SaveGame = MakeBenchmarkSaveGame(NumFlags, NumNPCs);
+    
+    TArray<uint8> ArchiveBytes;
+    FTimeLoopSaveArchive::Write(*SaveGame, ArchiveBytes);
+    const double ArchiveMB = ArchiveBytes.Num() / (1024.0 * 1024.0);
+    const FString TempPath = GetBenchmarkPath(TEXT("TimeLoopCompressionBenchmark.tlsave"));
+    
+    FString Summary = FString::Printf(TEXT("Save compression (%d flags, %d NPCs, %d runs, archive %d bytes):"), NumFlags, NumNPCs, Iterations, ArchiveBytes.Num());
+    
+    const ESaveCompression Codecs[] = { ESaveCompression::None, ESaveCompression::LZ4, ESaveCompression::Zlib };
+    const TCHAR* CodecNames[] = { TEXT("raw"), TEXT("lz4"), TEXT("zlib") };
+    for (int32 CodecIndex = 0; CodecIndex < UE_ARRAY_COUNT(Codecs); ++CodecIndex)
+    {
+        TArray<uint8> Compressed;
+        double CompressSeconds = 0.0;
+        double DecompressSeconds = 0.0;
+        double WriteSeconds = 0.0;
+        bool bRoundTrip = true;
+        
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            double StartTime = FPlatformTime::Seconds();
+            FTimeLoopSaveArchive::Compress(ArchiveBytes, Compressed, Codecs[CodecIndex]);
+            CompressSeconds += FPlatformTime::Seconds() - StartTime;
+            
+            // Raw output is the archive itself and has nothing to inflate
+            if (Codecs[CodecIndex] != ESaveCompression::None)
+            {
+                TArray<uint8> Inflated;
+                StartTime = FPlatformTime::Seconds();
+                bRoundTrip &= FTimeLoopSaveArchive::Decompress(Compressed, Inflated);
+                DecompressSeconds += FPlatformTime::Seconds() - StartTime;
+                bRoundTrip &= Inflated == ArchiveBytes;
+            }
+            
+            // Writing is where a smaller payload pays off on slow storage
+            StartTime = FPlatformTime::Seconds();
+            FFileHelper::SaveArrayToFile(Compressed, *TempPath);
+            WriteSeconds += FPlatformTime::Seconds() - StartTime;
+        }
+        
+        Summary += FString::Printf(TEXT(" | %s %d bytes (%.1f%%), compress %.1f MB/s, decompress %.1f MB/s, write %.3f ms, compress+write %.3f ms%s"),
+            CodecNames[CodecIndex], Compressed.Num(), 100.0 * Compressed.Num() / FMath::Max(1, ArchiveBytes.Num()),
+            CompressSeconds > 0.0 ? ArchiveMB * Iterations / CompressSeconds : 0.0,
+            DecompressSeconds > 0.0 ? ArchiveMB * Iterations / DecompressSeconds : 0.0,
+            WriteSeconds * 1000.0 / Iterations, (CompressSeconds + WriteSeconds) * 1000.0 / Iterations,
+            bRoundTrip ? TEXT("") : TEXT(" (ROUND TRIP FAILED)"));
+    }
+    
+    IFileManager::Get().Delete(*TempPath);
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkSaveJournal(int32 NumFlags, int32 NumNPCs, int32 NumSaves)
+{
+    NumSaves = FMath::Max(1, NumSaves);
+    UTimeLoopSaveGame* SaveGame = MakeBenchmarkSaveGame(NumFlags, NumNPCs);
+    SaveGame->DayMinute = 6 * 60;
+    SaveGame->SaveTimestamp = FDateTime::UtcNow();
+    SaveGame->PlayTimeSeconds = 100.0f;
+    
+    const FString ArchivePath = GetBenchmarkPath(TEXT("TimeLoopJournalBenchmark.tlsave"));
+    const FString JournalPath = FTimeLoopSaveJournal::GetJournalPath(ArchivePath);
+    FTimeLoopSaveJournal Journal;
+    
+    double StartTime = FPlatformTime::Seconds();
+    bool bValid = Journal.Commit(nullptr, *SaveGame, ArchivePath, ESaveCompression::None);
+    const double CheckpointSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    // Each save learns a flag, shifts a relationship and moves the clock on, as a short stretch of play would
+    double AppendSeconds = 0.0;
+    for (int32 SaveIndex = 0; SaveIndex < NumSaves; ++SaveIndex)
+    {
+        const UTimeLoopSaveGame* Base = DuplicateObject<UTimeLoopSaveGame>(SaveGame, GetTransientPackage());
+        
+        const int32 Bit = (SaveIndex * 2 + 1) % FMath::Max(1, NumFlags);
+        if (SaveGame->KnowledgeBits.IsValidIndex(Bit >> 6))
+        {
+            SaveGame->KnowledgeBits[Bit >> 6] |= (uint64)1 << (Bit & 63);
+        }
+        SaveGame->NPCRelationships.FindOrAdd(FName(TEXT("Benchmark_NPC_0"))) += 1.0f;
+        SaveGame->DayMinute = (SaveGame->DayMinute + 5) % (24 * 60);
+        SaveGame->SaveTimestamp += FTimespan::FromMinutes(1.0);
+        SaveGame->PlayTimeSeconds += 60.0f;
+        
+        StartTime = FPlatformTime::Seconds();
+        bValid &= Journal.Commit(Base, *SaveGame, ArchivePath, ESaveCompression::None);
+        AppendSeconds += FPlatformTime::Seconds() - StartTime;
+    }
+    const int64 JournalBytes = IFileManager::Get().FileSize(*JournalPath);
+    
+    // Play time and the clock must come back from the last save, not from the checkpoint's summary
+    UTimeLoopSaveGame* Loaded = NewObject<UTimeLoopSaveGame>();
+    StartTime = FPlatformTime::Seconds();
+    bValid &= FTimeLoopSaveJournal::LoadFromFile(ArchivePath, *Loaded);
+    const double LoadSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    bValid &= Loaded->PlayTimeSeconds == SaveGame->PlayTimeSeconds
+        && Loaded->DayMinute == SaveGame->DayMinute
+        && Loaded->SaveTimestamp == SaveGame->SaveTimestamp
+        && Loaded->KnowledgeBits == SaveGame->KnowledgeBits
+        && Loaded->NPCRelationships.FindRef(FName(TEXT("Benchmark_NPC_0"))) == SaveGame->NPCRelationships.FindRef(FName(TEXT("Benchmark_NPC_0")));
+    
+    IFileManager& FileManager = IFileManager::Get();
+    FileManager.Delete(*ArchivePath);
+    FileManager.Delete(*FTimeLoopSaveArchive::GetBackupPath(ArchivePath));
+    FileManager.Delete(*FTimeLoopSaveArchive::GetSummaryPath(ArchivePath));
+    FileManager.Delete(*JournalPath);
+    FileManager.Delete(*FTimeLoopSaveArchive::GetBackupPath(JournalPath));
+    
+    const FString Summary = FString::Printf(
+        TEXT("Save journal (%d flags, %d NPCs, %d saves): checkpoint %.3f ms | append %.3f ms avg, journal %lld bytes | load %.3f ms, play time %.0f s%s"),
+        NumFlags, NumNPCs, NumSaves,
+        CheckpointSeconds * 1000.0, AppendSeconds * 1000.0 / NumSaves, JournalBytes,
+        LoadSeconds * 1000.0, Loaded->PlayTimeSeconds,
+        bValid ? TEXT("") : TEXT(" (ROUND TRIP FAILED)"));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkLoopHistory(int32 NumLoops)
+{
+    NumLoops = FMath::Max(1, NumLoops);
+    
+    // Content shaped like a finished game; each loop touches a small slice of it
+    const int32 NumNames[] = { 500, 60, 30, 40 };
+    const TCHAR* Prefixes[] = { TEXT("Flag"), TEXT("Quest"), TEXT("NPC"), TEXT("Location") };
+    TArray<FName> ColumnNames[4];
+    for (int32 Column = 0; Column < 4; ++Column)
+    {
+        for (int32 Index = 0; Index < NumNames[Column]; ++Index)
+        {
+            ColumnNames[Column].Add(FName(*FString::Printf(TEXT("Benchmark_%s_%d"), Prefixes[Column], Index)));
+        }
+    }
+    
+    ULoopHistory* History = NewObject<ULoopHistory>();
+    FRandomStream Random(1993);
+    
+    double StartTime = FPlatformTime::Seconds();
+    for (int32 Loop = 1; Loop <= NumLoops; ++Loop)
+    {
+        History->BeginLoop();
+        const int32 PerLoop[] = { Random.RandRange(0, 12), Random.RandRange(0, 2), Random.RandRange(1, 8), Random.RandRange(2, 10) };
+        for (int32 Column = 0; Column < 4; ++Column)
+        {
+            for (int32 Count = 0; Count < PerLoop[Column]; ++Count)
+            {
+                History->RecordName(static_cast<ELoopHistoryColumn>(Column), ColumnNames[Column][Random.RandHelper(NumNames[Column])]);
+            }
+        }
+        
+        const ELoopEndReason Reason = Random.FRand() < 0.2f ? ELoopEndReason::Death : ELoopEndReason::Reset;
+        History->EndLoop(Loop, Random.RandRange(8 * 60, 24 * 60 - 1), Reason);
+    }
+    const double RecordSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    TArray<uint8> Bytes;
+    StartTime = FPlatformTime::Seconds();
+    History->Write(Bytes);
+    const double WriteSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    StartTime = FPlatformTime::Seconds();
+    const int32 FlagLoops = History->CountLoopsWith(ELoopHistoryColumn::FlagsLearned, ColumnNames[0][7], 1, NumLoops);
+    const double CountSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    StartTime = FPlatformTime::Seconds();
+    const TMap<FName, int32> Histogram = History->GetColumnHistogram(ELoopHistoryColumn::LocationsVisited, 1, NumLoops);
+    const double HistogramSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    StartTime = FPlatformTime::Seconds();
+    const float AverageEndMinute = History->GetAverageEndMinute(1, NumLoops);
+    const int32 Deaths = History->CountLoopsEndedBy(ELoopEndReason::Death, 1, NumLoops);
+    const double AggregateSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    StartTime = FPlatformTime::Seconds();
+    const TArray<FLoopRecord> Page = History->GetLoops(NumLoops / 2, NumLoops / 2 + 99);
+    const double PageSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    // Round trip through the serialized form must answer queries identically
+    ULoopHistory* Loaded = NewObject<ULoopHistory>();
+    StartTime = FPlatformTime::Seconds();
+    bool bValid = Loaded->Read(Bytes);
+    const double ReadSeconds = FPlatformTime::Seconds() - StartTime;
+    bValid &= Loaded->GetNumLoops() == NumLoops
+        && Loaded->CountLoopsWith(ELoopHistoryColumn::FlagsLearned, ColumnNames[0][7], 1, NumLoops) == FlagLoops
+        && Loaded->CountLoopsEndedBy(ELoopEndReason::Death, 1, NumLoops) == Deaths;
+    
+    const FString Summary = FString::Printf(
+        TEXT("Loop history (%d loops): %d bytes (%.1f per loop), record %.3f ms, write %.3f ms, read %.3f ms | count %.3f ms (%d), location histogram %.3f ms (%d names), end time and deaths %.3f ms (%.0f min, %d), 100-loop page %.3f ms (%d)%s"),
+        NumLoops, Bytes.Num(), (double)Bytes.Num() / NumLoops,
+        RecordSeconds * 1000.0, WriteSeconds * 1000.0, ReadSeconds * 1000.0,
+        CountSeconds * 1000.0, FlagLoops, HistogramSeconds * 1000.0, Histogram.Num(),
+        AggregateSeconds * 1000.0, AverageEndMinute, Deaths, PageSeconds * 1000.0, Page.Num(),
+        bValid ? TEXT("") : TEXT(" (ROUND TRIP FAILED)"));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkInventoryChurn(int32 OperationsPerFrame, int32 NumFrames, int32 NumSlots)
+{
+    OperationsPerFrame = FMath::Max(OperationsPerFrame, 1);
+    NumFrames = FMath::Max(NumFrames, 1);
+    NumSlots = FMath::Max(NumSlots, 1);
+    
+    // Twice as many distinct items as slots, so adds regularly find the inventory full
+    TArray<FItemDefinition> ItemPool;
+    for (int32 ItemIndex = 0; ItemIndex < NumSlots * 2; ++ItemIndex)
+    {
+        FItemDefinition& Item = ItemPool.AddDefaulted_GetRef();
+        Item.ItemID = FName(*FString::Printf(TEXT("Benchmark_Item_%d"), ItemIndex));
+        Item.bIsStackable = (ItemIndex % 3) != 0;
+        Item.MaxStackCount = 99;
+        FItemDefinitionRegistry::Get().Register(Item);
+    }
+    
+    // Half adds, a quarter removes, a quarter queries
+    struct FChurnOp
+    {
+        uint8 Kind;
+        int32 Item;
+    };
+    FRandomStream Random(1234);
+    TArray<FChurnOp> Ops;
+    Ops.SetNumUninitialized(OperationsPerFrame * NumFrames);
+    for (FChurnOp& Op : Ops)
+    {
+        const int32 Roll = Random.RandHelper(4);
+        Op.Kind = Roll < 2 ? 0 : static_cast<uint8>(Roll - 1);
+        Op.Item = Random.RandHelper(ItemPool.Num());
+    }
+    
+    UInventoryComponent* Inventory = NewObject<UInventoryComponent>();
+    Inventory->SetMaxItems(NumSlots);
+    
+    int32 SlotHits = 0;
+    double WorstSlotFrame = 0.0;
+    double StartTime = FPlatformTime::Seconds();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const double FrameStart = FPlatformTime::Seconds();
+        for (int32 OpIndex = Frame * OperationsPerFrame; OpIndex < (Frame + 1) * OperationsPerFrame; ++OpIndex)
+        {
+            const FItemDefinition& Item = ItemPool[Ops[OpIndex].Item];
+            switch (Ops[OpIndex].Kind)
+            {
+            case 0:
+                Inventory->AddItem(Item.ItemID, 1);
+                break;
+            case 1:
+                Inventory->RemoveItem(Item.ItemID, 1);
+                break;
+            default:
+                SlotHits += Inventory->HasItem(Item.ItemID, 1) ? 1 : 0;
+                break;
+            }
+        }
+        WorstSlotFrame = FMath::Max(WorstSlotFrame, FPlatformTime::Seconds() - FrameStart);
+    }
+    const double SlotSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    // The same operations on a map of full item copies, as the inventory stored its items before slots
+    struct FMapItem
+    {
+        FItemDefinition Definition;
+        int32 StackCount;
+    };
+    TMap<FName, FMapItem> Map;
+    int32 MapHits = 0;
+    double WorstMapFrame = 0.0;
+    StartTime = FPlatformTime::Seconds();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const double FrameStart = FPlatformTime::Seconds();
+        for (int32 OpIndex = Frame * OperationsPerFrame; OpIndex < (Frame + 1) * OperationsPerFrame; ++OpIndex)
+        {
+            const FItemDefinition& Item = ItemPool[Ops[OpIndex].Item];
+            switch (Ops[OpIndex].Kind)
+            {
+            case 0:
+                if (Map.Contains(Item.ItemID))
+                {
+                    FMapItem& Existing = Map[Item.ItemID];
+                    if (Existing.Definition.bIsStackable)
+                    {
+                        Existing.StackCount = FMath::Min(Existing.StackCount + 1, Existing.Definition.MaxStackCount);
+                    }
+                }
+                else if (Map.Num() < NumSlots)
+                {
+                    Map.Add(Item.ItemID, FMapItem{ Item, 1 });
+                }
+                break;
+            case 1:
+                if (Map.Contains(Item.ItemID))
+                {
+                    FMapItem& Existing = Map[Item.ItemID];
+                    if (!Existing.Definition.bIsStackable || Existing.StackCount <= 1)
+                    {
+                        Map.Remove(Item.ItemID);
+                    }
+                    else
+                    {
+                        Existing.StackCount -= 1;
+                    }
+                }
+                break;
+            default:
+                MapHits += Map.Contains(Item.ItemID) ? 1 : 0;
+                break;
+            }
+        }
+        WorstMapFrame = FMath::Max(WorstMapFrame, FPlatformTime::Seconds() - FrameStart);
+    }
+    const double MapSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    const bool bValid = SlotHits == MapHits && Inventory->GetAllItems().Num() == Map.Num();
+    
+    const FString Summary = FString::Printf(
+        TEXT("Inventory churn (%d ops x %d frames, %d slots): slots %.3f ms/frame (worst %.3f, %.1f ns/op, %d bytes/item) | map %.3f ms/frame (worst %.3f, %.1f ns/op, %d bytes/item) | %d items held%s"),
+        OperationsPerFrame, NumFrames, NumSlots,
+        SlotSeconds * 1000.0 / NumFrames, WorstSlotFrame * 1000.0, SlotSeconds * 1e9 / Ops.Num(), (int32)sizeof(FInventoryItem),
+        MapSeconds * 1000.0 / NumFrames, WorstMapFrame * 1000.0, MapSeconds * 1e9 / Ops.Num(), (int32)sizeof(FMapItem),
+        Map.Num(), bValid ? TEXT("") : TEXT(" (RESULTS DIFFER)"));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkInventoryWidget(UObject* WorldContextObject, int32 NumItems, int32 NumFrames)
+{
+    NumItems = FMath::Max(NumItems, 1);
+    NumFrames = FMath::Max(NumFrames, 1);
+    
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+    UClass* WidgetClass = LoadClass<UInventoryWidget>(nullptr, TEXT("/Game/UI/Widgets/WBP_Inventory.WBP_Inventory_C"));
+    if (!PlayerController || !WidgetClass)
+    {
+        const FString Summary = TEXT("Inventory widget: needs a local player and /Game/UI/Widgets/WBP_Inventory");
+        UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+        return Summary;
+    }
+    
+    TArray<FName> ItemIDs;
+    for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+    {
+        FItemDefinition Definition;
+        Definition.ItemID = FName(*FString::Printf(TEXT("Benchmark_Widget_Item_%d"), ItemIndex));
+        Definition.bIsStackable = true;
+        Definition.MaxStackCount = 99;
+        FItemDefinitionRegistry::Get().Register(Definition);
+        ItemIDs.Add(Definition.ItemID);
+    }
+    
+    UInventoryComponent* Inventory = NewObject<UInventoryComponent>(PlayerController);
+    Inventory->SetMaxItems(NumItems);
+    {
+        FInventoryTransaction Transaction(Inventory);
+        for (const FName ItemID : ItemIDs)
+        {
+            Inventory->AddItem(ItemID, 1);
+        }
+    }
+    
+    // Warm up: binding builds the slot pool and the first open builds the Slate widgets
+    UInventoryWidget* Widget = CreateWidget<UInventoryWidget>(PlayerController, WidgetClass);
+    double StartTime = FPlatformTime::Seconds();
+    Widget->SetInventoryComponent(Inventory);
+    Widget->AddToViewport();
+    const double WarmupSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+    
+    // Each frame a transaction tops up a few stacks and swaps one item out and back in
+    FRandomStream Random(99);
+    double WorstFrame = 0.0;
+    StartTime = FPlatformTime::Seconds();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const double FrameStart = FPlatformTime::Seconds();
+        {
+            FInventoryTransaction Transaction(Inventory);
+            for (int32 Change = 0; Change < 8; ++Change)
+            {
+                Inventory->AddItem(ItemIDs[Random.RandHelper(NumItems)], 1);
+            }
+            const FName SwappedID = ItemIDs[Random.RandHelper(NumItems)];
+            Inventory->RemoveItem(SwappedID, 99);
+            Inventory->AddItem(SwappedID, 1);
+        }
+        WorstFrame = FMath::Max(WorstFrame, FPlatformTime::Seconds() - FrameStart);
+    }
+    const double DeltaSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    // A full pass over every slot, as a refresh without a change set would cost
+    StartTime = FPlatformTime::Seconds();
+    Widget->RefreshInventory();
+    const double FullRefreshSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    const int32 NumReopens = 10;
+    StartTime = FPlatformTime::Seconds();
+    for (int32 Reopen = 0; Reopen < NumReopens; ++Reopen)
+    {
+        Widget->RemoveFromParent();
+        Widget->AddToViewport();
+    }
+    const double ReopenSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    const int32 ObjectsCreated = GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore;
+    Widget->RemoveFromParent();
+    
+    const FString Summary = FString::Printf(
+        TEXT("Inventory widget (%d items, %d frames): warm-up %.3f ms | change sets %.3f ms/frame (worst %.3f) | full refresh %.3f ms | reopen %.3f ms | %d objects created after warm-up%s"),
+        NumItems, NumFrames, WarmupSeconds * 1000.0,
+        DeltaSeconds * 1000.0 / NumFrames, WorstFrame * 1000.0,
+        FullRefreshSeconds * 1000.0, ReopenSeconds * 1000.0 / NumReopens,
+        FMath::Max(ObjectsCreated, 0), ObjectsCreated > 0 ? TEXT(" (EXPECTED NONE)") : TEXT(""));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
+
+FString UTimeLoopBenchmarks::BenchmarkRuleNetwork(int32 NumRules, int32 NumFacts, int32 NumUpdates)
+{
+    NumRules = FMath::Max(NumRules, 1);
+    NumFacts = FMath::Max(NumFacts, 1);
+    NumUpdates = FMath::Max(NumUpdates, 1);
+    
+    TArray<FName> FactKeys;
+    for (int32 FactIndex = 0; FactIndex < NumFacts; ++FactIndex)
+    {
+        FactKeys.Add(FName(*FString::Printf(TEXT("Benchmark.Fact_%d"), FactIndex)));
+    }
+    
+    // Two to four threshold tests per rule over a small operand range, so conditions and prefixes are shared
+    FRandomStream Random(1234);
+    TArray<FGameRule> RuleSet;
+    RuleSet.SetNum(NumRules);
+    for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+    {
+        FGameRule& Rule = RuleSet[RuleIndex];
+        Rule.RuleId = FName(*FString::Printf(TEXT("Benchmark_Rule_%d"), RuleIndex));
+        const int32 NumConditions = 2 + Random.RandHelper(3);
+        for (int32 ConditionIndex = 0; ConditionIndex < NumConditions; ++ConditionIndex)
+        {
+            FRuleCondition& Condition = Rule.Conditions.AddDefaulted_GetRef();
+            Condition.FactKey = FactKeys[Random.RandHelper(NumFacts)];
+            Condition.Comparison = ERuleComparison::GreaterOrEqual;
+            Condition.IntValue = Random.RandHelper(8);
+        }
+    }
+    
+    TArray<TPair<int32, int32>> Updates;
+    Updates.SetNumUninitialized(NumUpdates);
+    for (TPair<int32, int32>& Update : Updates)
+    {
+        Update.Key = Random.RandHelper(NumFacts);
+        Update.Value = Random.RandHelper(10);
+    }
+    
+    URuleSystem* RuleSystem = NewObject<URuleSystem>();
+    
+    double StartTime = FPlatformTime::Seconds();
+    for (const FGameRule& Rule : RuleSet)
+    {
+        RuleSystem->AddRule(Rule);
+    }
+    const double CompileSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    double WorstUpdate = 0.0;
+    StartTime = FPlatformTime::Seconds();
+    for (const TPair<int32, int32>& Update : Updates)
+    {
+        const double UpdateStart = FPlatformTime::Seconds();
+        RuleSystem->SetIntFact(FactKeys[Update.Key], Update.Value);
+        WorstUpdate = FMath::Max(WorstUpdate, FPlatformTime::Seconds() - UpdateStart);
+    }
+    const double UpdateSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    // Check the network against evaluating every rule directly
+    int32 NumActive = 0;
+    bool bValid = true;
+    for (const FGameRule& Rule : RuleSet)
+    {
+        bool bHolds = true;
+        for (const FRuleCondition& Condition : Rule.Conditions)
+        {
+            bHolds &= RuleSystem->GetIntFact(Condition.FactKey) >= Condition.IntValue;
+        }
+        const bool bActive = RuleSystem->IsRuleActive(Rule.RuleId);
+        NumActive += bActive ? 1 : 0;
+        bValid &= bActive == bHolds;
+    }
+    
+    const FString Summary = FString::Printf(
+        TEXT("Rule network (%d rules, %d facts, %d updates): compile %.2f ms (%d alpha, %d beta nodes) | update %.2f us avg, %.2f us worst | %d rules active%s"),
+        NumRules, NumFacts, NumUpdates,
+        CompileSeconds * 1000.0, RuleSystem->GetNumAlphaNodes(), RuleSystem->GetNumBetaNodes(),
+        UpdateSeconds * 1e6 / NumUpdates, WorstUpdate * 1e6,
+        NumActive, bValid ? TEXT("") : TEXT(" (RESULTS DIFFER)"));
+    
+    UE_LOG(LogTemp, Warning, TEXT("Benchmarks: %s"), *Summary);
+    return Summary;
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Squeezle Canada
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "TimeLoopBenchmarks.generated.h"
+
+/**
+ * UTimeLoopBenchmarks - Micro-benchmarks for core systems, runnable from Blueprint or the console
+ * Each benchmark logs its timings and returns the same summary as a string.
+ */
+UCLASS()
+class TIMELOOP_API UTimeLoopBenchmarks : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    // Compare the save archive against the tagged-property slot save for a large save game
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkSaveFormats(int32 NumFlags = 10000, int32 NumNPCs = 1000, int32 Iterations = 20);
+
+    // Compare each save codec's compress and decompress throughput against writing the raw archive
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkSaveCompression(int32 NumFlags = 10000, int32 NumNPCs = 1000, int32 Iterations = 20);
+
+    // Time journaled saves against the checkpoint they append to, then check a load returns the latest save
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkSaveJournal(int32 NumFlags = 10000, int32 NumNPCs = 1000, int32 NumSaves = 50);
+
+    // Record a long synthetic loop history, then time its size, aggregate queries and round trip
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkLoopHistory(int32 NumLoops = 10000);
+
+    // Churn an inventory with adds, removes and queries, against the same operations on a map keyed by item ID
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkInventoryChurn(int32 OperationsPerFrame = 5000, int32 NumFrames = 60, int32 NumSlots = 256);
+
+    // Time the inventory widget applying per-frame changes to a large inventory, and count the objects it creates once warm
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks", meta = (WorldContext = "WorldContextObject"))
+    static FString BenchmarkInventoryWidget(UObject* WorldContextObject, int32 NumItems = 500, int32 NumFrames = 120);
+
+    // Compile a large rule set into the rule network, then time fact updates against it
+    UFUNCTION(BlueprintCallable, Category = "Testing|Benchmarks")
+    static FString BenchmarkRuleNetwork(int32 NumRules = 10000, int32 NumFacts = 500, int32 NumUpdates = 10000);
+};
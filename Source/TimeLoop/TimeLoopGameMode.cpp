@@ -18,8 +18,16 @@
 #include "Systems/CharacterSystem/NPCScheduler.h"
 #include "Systems/QuestSystem/QuestManager.h"
 #include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/RuleSystem/RuleSystem.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/Paths.h"
 #include "Systems/TimeSystem/TimeLoopSaveGame.h"
+#include "Systems/TimeSystem/TimeLoopSaveArchive.h"
+#include "Systems/TimeSystem/TimeLoopSaveJournal.h"
+#include "Systems/TimeSystem/TimeLoopAsyncSaver.h"
+#include "Systems/TimeSystem/SaveSlotDirectory.h"
+#include "Components/InventoryComponent.h"
 #include "UI/TimeLoopHUD.h"
 
 ATimeLoopGameMode::ATimeLoopGameMode()
@@ -29,6 +37,11 @@ ATimeLoopGameMode::ATimeLoopGameMode()
 	
 	// Set default classes
 	HUDClass = ATimeLoopHUD::StaticClass();
+	
+	// Default save slot
+	CurrentSlotName = TEXT("TimeLoopSave");
+	SaveCompression = ESaveCompression::LZ4;
+	PlayTimeSeconds = 0.0f;
 }
 
 void ATimeLoopGameMode::BeginPlay()
@@ -44,15 +57,42 @@ void ATimeLoopGameMode::BeginPlay()
 	UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Begin Play"));
 }
 
+void ATimeLoopGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Don't lose a save that is still being written
+	if (AsyncSaver)
+	{
+		AsyncSaver->Flush();
+	}
+	
+	if (LoopHistory)
+	{
+		LoopHistory->Flush();
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
 void ATimeLoopGameMode::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 	
+	PlayTimeSeconds += DeltaSeconds;
+	
 	// Allow the time manager to update
 	if (TimeManager)
 	{
 		TimeManager->UpdateTime(DeltaSeconds);
 	}
+	
+	// Advance overheard NPC conversations in one batch
+	if (DialogueManager)
+	{
+		DialogueManager->TickAmbientDialogues(DeltaSeconds);
+		
+		// Apply this frame's dialogue side effects as one batch
+		DialogueManager->FlushSideEffects();
+	}
 }
 
 void ATimeLoopGameMode::InitializeGameSystems()
@@ -76,30 +116,102 @@ void ATimeLoopGameMode::InitializeGameSystems()
 	if (QuestManager)
 	{
 		QuestManager->Initialize();
+		
+		if (TimeManager)
+		{
+			QuestManager->SetLoopCount(TimeManager->GetLoopCount());
+			TimeManager->OnHourChanged.AddDynamic(QuestManager, &UQuestManager::NotifyHourReached);
+		}
+		
+		// Objectives complete themselves as gameplay events arrive
+		if (NPCScheduler)
+		{
+			NPCScheduler->OnNPCInteracted.AddDynamic(QuestManager, &UQuestManager::NotifyNPCInteracted);
+		}
 	}
 	
+	// Create the Loop History, picking up the loops of earlier sessions
+	LoopHistory = NewObject<ULoopHistory>(this);
+	if (LoopHistory)
+	{
+		LoopHistory->LoadFromFile(ULoopHistory::GetSlotPath(CurrentSlotName));
+		LoopHistory->Initialize(QuestManager, NPCScheduler);
+		
+		if (TimeManager)
+		{
+			TimeManager->OnDayReset.AddDynamic(this, &ATimeLoopGameMode::OnDayReset);
+		}
+	}
+	
+	// Create the Save Slot Directory for load menus
+	SaveSlotDirectory = NewObject<USaveSlotDirectory>(this);
+	
 	// Create the Dialogue Manager
 	DialogueManager = NewObject<UDialogueManager>(this);
 	if (DialogueManager)
 	{
 		DialogueManager->Initialize();
+		DialogueManager->SetQuestManager(QuestManager);
+		DialogueManager->OnRelationshipImpacts.AddDynamic(this, &ATimeLoopGameMode::OnDialogueRelationshipImpacts);
+	}
+	
+	// Create the Rule System last so every fact source exists
+	RuleSystem = NewObject<URuleSystem>(this);
+	if (RuleSystem)
+	{
+		RuleSystem->Initialize(TimeManager, NPCScheduler, QuestManager);
+		
+		// The player may already hold items if it began play first
+		RuleSystem->SyncInventory(GetPlayerInventory());
 	}
 	
 	UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Systems Initialized"));
 }
 
-void ATimeLoopGameMode::ResetTimeLoop()
+void ATimeLoopGameMode::ResetTimeLoop(ELoopEndReason EndReason)
 {
 	UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Initiating Time Loop Reset"));
 	
-	// Save the player's knowledge and important state before reset
-	SaveGame();
+	// Apply this frame's dialogue effects so the snapshot below includes them
+	if (DialogueManager)
+	{
+		DialogueManager->FlushSideEffects();
+	}
+	
+	// Close out the loop in the history before anything is reset
+	if (LoopHistory && TimeManager)
+	{
+		const int32 EndMinute = TimeManager->GetCurrentHour() * 60 + TimeManager->GetCurrentMinute();
+		LoopHistory->EndLoop(TimeManager->GetLoopCount(), EndMinute, EndReason);
+		LoopHistory->SaveToFile(ULoopHistory::GetSlotPath(CurrentSlotName));
+	}
+	
+	// Snapshot the player's knowledge and important state, writing it out in the background
+	UTimeLoopSaveGame* Snapshot = CaptureSaveGame();
 	
 	// Reset all systems to their starting state
 	ResetAllSystems();
 	
-	// Load the saved player knowledge 
-	LoadGame();
+	// Restore the persistent state from the snapshot rather than waiting on the disk
+	ApplySaveGame(Snapshot);
+	
+	// Quests gated on the loop count are re-checked against the new loop
+	if (QuestManager && TimeManager)
+	{
+		QuestManager->SetLoopCount(TimeManager->GetLoopCount());
+	}
+	
+	// Rules re-run against the restored state
+	if (RuleSystem)
+	{
+		RuleSystem->ResetForNewDay();
+	}
+	
+	// Record the new loop from a clean slate, ignoring the restore above
+	if (LoopHistory)
+	{
+		LoopHistory->BeginLoop();
+	}
 	
 	// Broadcast that the time loop has been reset
 	// Blueprint implementable event can be added here
@@ -127,73 +239,220 @@ void ATimeLoopGameMode::ResetAllSystems()
 	{
 		DialogueManager->ResetForNewDay();
 	}
+	
+	// The player wakes up with what they had when the loop began, plus anything persistent
+	if (UInventoryComponent* Inventory = GetPlayerInventory())
+	{
+		Inventory->RestoreLoopStartSnapshot();
+	}
+}
+
+UInventoryComponent* ATimeLoopGameMode::GetPlayerInventory() const
+{
+	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	return PlayerPawn ? PlayerPawn->FindComponentByClass<UInventoryComponent>() : nullptr;
+}
+
+void ATimeLoopGameMode::OnDayReset()
+{
+	// The time manager has already moved on to the next loop, so the one that ran out is the previous
+	if (LoopHistory && TimeManager)
+	{
+		LoopHistory->EndLoop(TimeManager->GetLoopCount() - 1, 24 * 60, ELoopEndReason::DayEnded);
+		LoopHistory->SaveToFile(ULoopHistory::GetSlotPath(CurrentSlotName));
+		LoopHistory->BeginLoop();
+	}
+}
+
+void ATimeLoopGameMode::OnDialogueRelationshipImpacts(const TArray<FDialogueRelationshipImpact>& Impacts)
+{
+	if (!NPCScheduler)
+	{
+		return;
+	}
+	
+	TMap<FName, float> Deltas;
+	Deltas.Reserve(Impacts.Num());
+	for (const FDialogueRelationshipImpact& Impact : Impacts)
+	{
+		Deltas.Add(Impact.NPCId, Impact.Delta);
+	}
+	
+	NPCScheduler->ChangeRelationships(Deltas);
 }
 
 void ATimeLoopGameMode::SaveGame()
+{
+	CaptureSaveGame();
+}
+
+UTimeLoopSaveGame* ATimeLoopGameMode::CaptureSaveGame()
 {
 	// Create a new save game instance
 	UTimeLoopSaveGame* SaveGameInstance = Cast<UTimeLoopSaveGame>(UGameplayStatics::CreateSaveGameObject(UTimeLoopSaveGame::StaticClass()));
+	if (!SaveGameInstance)
+	{
+		return nullptr;
+	}
 	
-	if (SaveGameInstance)
+	// Store persistent data in the save game
+	if (TimeManager)
 	{
-		// Store persistent data in the save game
-		if (TimeManager)
-		{
-			SaveGameInstance->LoopCount = TimeManager->GetLoopCount();
-		}
-		
-		// Save the player's knowledge flags
-		if (QuestManager)
+		SaveGameInstance->LoopCount = TimeManager->GetLoopCount();
+		SaveGameInstance->DayMinute = TimeManager->GetCurrentHour() * 60 + TimeManager->GetCurrentMinute();
+	}
+	
+	// Details shown in the load menu
+	SaveGameInstance->SaveTimestamp = FDateTime::UtcNow();
+	SaveGameInstance->PlayTimeSeconds = PlayTimeSeconds;
+	
+	// Save the player's knowledge flags
+	if (QuestManager)
+	{
+		QuestManager->SavePlayerKnowledge(SaveGameInstance);
+	}
+	
+	// Save NPC relationship data
+	if (NPCScheduler)
+	{
+		NPCScheduler->SaveNPCRelationships(SaveGameInstance);
+	}
+	
+	// Save the items the player keeps between loops
+	if (const UInventoryComponent* Inventory = GetPlayerInventory())
+	{
+		Inventory->SavePersistentItems(SaveGameInstance);
+	}
+	
+	// The snapshot is complete; serializing and writing it happens off the game thread
+	if (!AsyncSaver)
+	{
+		AsyncSaver = MakeShared<FTimeLoopAsyncSaver>();
+	}
+	AsyncSaver->Compression = SaveCompression;
+	
+	TWeakObjectPtr<ATimeLoopGameMode> WeakThis(this);
+	const FString SlotName = CurrentSlotName;
+	AsyncSaver->Save(SaveGameInstance, FTimeLoopSaveArchive::GetSlotPath(SlotName), FOnAsyncSaveComplete::CreateLambda([WeakThis, SlotName](bool bSuccess)
+	{
+		if (ATimeLoopGameMode* GameMode = WeakThis.Get())
 		{
-			QuestManager->SavePlayerKnowledge(SaveGameInstance);
+			UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Game %s"), bSuccess ? TEXT("Saved") : TEXT("Save Failed"));
+			
+			// The summary may change within the file timestamp's resolution
+			if (GameMode->SaveSlotDirectory)
+			{
+				GameMode->SaveSlotDirectory->InvalidateSlot(SlotName);
+			}
+			GameMode->OnGameSaved.Broadcast(bSuccess);
 		}
-		
-		// Save NPC relationship data
-		if (NPCScheduler)
+	}));
+	
+	return SaveGameInstance;
+}
+
+void ATimeLoopGameMode::LoadGame()
+{
+	// The file on disk must reflect every save already requested
+	if (AsyncSaver)
+	{
+		AsyncSaver->Flush();
+	}
+	
+	// Prefer the archive; saves from before it existed are still read from the slot
+	UTimeLoopSaveGame* SaveGameInstance = nullptr;
+	const FString ArchivePath = FTimeLoopSaveArchive::GetSlotPath(CurrentSlotName);
+	if (FPaths::FileExists(ArchivePath))
+	{
+		SaveGameInstance = NewObject<UTimeLoopSaveGame>(this);
+		if (!FTimeLoopSaveJournal::LoadFromFile(ArchivePath, *SaveGameInstance))
 		{
-			NPCScheduler->SaveNPCRelationships(SaveGameInstance);
+			UE_LOG(LogTemp, Error, TEXT("Time Loop Game Mode: Save archive %s could not be read"), *ArchivePath);
+			SaveGameInstance = nullptr;
 		}
-		
-		// Save the game to slot
-		UGameplayStatics::SaveGameToSlot(SaveGameInstance, TEXT("TimeLoopSave"), 0);
-		
-		UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Game Saved"));
 	}
+	else if (UGameplayStatics::DoesSaveGameExist(CurrentSlotName, 0))
+	{
+		SaveGameInstance = Cast<UTimeLoopSaveGame>(UGameplayStatics::LoadGameFromSlot(CurrentSlotName, 0));
+	}
+	
+	ApplySaveGame(SaveGameInstance);
 }
 
-void ATimeLoopGameMode::LoadGame()
+void ATimeLoopGameMode::LoadGameFromSlot(const FString& SlotName)
+{
+	SetCurrentSlot(SlotName);
+	LoadGame();
+}
+
+void ATimeLoopGameMode::SetCurrentSlot(const FString& SlotName)
 {
-	// Check if a save game exists
-	if (UGameplayStatics::DoesSaveGameExist(TEXT("TimeLoopSave"), 0))
+	if (SlotName.IsEmpty() || SlotName == CurrentSlotName)
 	{
-		// Load the save game
-		UTimeLoopSaveGame* SaveGameInstance = Cast<UTimeLoopSaveGame>(UGameplayStatics::LoadGameFromSlot(TEXT("TimeLoopSave"), 0));
-		
-		if (SaveGameInstance)
+		return;
+	}
+	
+	// Finish writing the old slot before anything targets the new one
+	if (AsyncSaver)
+	{
+		AsyncSaver->Flush();
+	}
+	
+	CurrentSlotName = SlotName;
+	
+	// Each slot keeps its own loop history
+	if (LoopHistory)
+	{
+		LoopHistory->Flush();
+		if (!LoopHistory->LoadFromFile(ULoopHistory::GetSlotPath(CurrentSlotName)))
 		{
-			// Load persistent data from the save game
-			if (TimeManager)
-			{
-				TimeManager->SetLoopCount(SaveGameInstance->LoopCount);
-			}
-			
-			// Load the player's knowledge flags
-			if (QuestManager)
-			{
-				QuestManager->LoadPlayerKnowledge(SaveGameInstance);
-			}
-			
-			// Load NPC relationship data
-			if (NPCScheduler)
-			{
-				NPCScheduler->LoadNPCRelationships(SaveGameInstance);
-			}
-			
-			UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Game Loaded"));
+			LoopHistory->Reset();
 		}
 	}
 }
 
+void ATimeLoopGameMode::ApplySaveGame(UTimeLoopSaveGame* SaveGameInstance)
+{
+	if (!SaveGameInstance)
+	{
+		return;
+	}
+	
+	// Load persistent data from the save game
+	if (TimeManager)
+	{
+		TimeManager->SetLoopCount(SaveGameInstance->LoopCount);
+	}
+	
+	PlayTimeSeconds = SaveGameInstance->PlayTimeSeconds;
+	
+	// Load the player's knowledge flags
+	if (QuestManager)
+	{
+		QuestManager->LoadPlayerKnowledge(SaveGameInstance);
+	}
+	
+	// Loading replaces the knowledge without change events, so rules re-read what they test
+	if (RuleSystem)
+	{
+		RuleSystem->SyncKnowledgeFacts();
+	}
+	
+	// Load NPC relationship data
+	if (NPCScheduler)
+	{
+		NPCScheduler->LoadNPCRelationships(SaveGameInstance);
+	}
+	
+	// Give back the items the player keeps between loops
+	if (UInventoryComponent* Inventory = GetPlayerInventory())
+	{
+		Inventory->LoadPersistentItems(SaveGameInstance);
+	}
+	
+	UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Game Loaded"));
+}
+
 void ATimeLoopGameMode::StartGameIntroSequence()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Time Loop Game Mode: Starting Game Intro Sequence"));
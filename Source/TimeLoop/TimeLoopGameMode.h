@@ -17,6 +17,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/TimeSystem/LoopHistory.h"
+#include "Systems/TimeSystem/TimeLoopSaveGame.h"
 #include "TimeLoopGameMode.generated.h"
 
 // Forward declarations
@@ -24,6 +27,14 @@ class UTimeManager;
 class UNPCScheduler;
 class UQuestManager;
 class UDialogueManager;
+class URuleSystem;
+class UTimeLoopSaveGame;
+class FTimeLoopAsyncSaver;
+class USaveSlotDirectory;
+class UInventoryComponent;
+
+// Delegate for when a requested save has been written to disk
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGameSavedDelegate, bool, bSuccess);
 
 /**
  * ATimeLoopGameMode - The main game mode for the Time Loop game
@@ -43,17 +54,41 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaSeconds) override;
 	
+	// Called when the game ends, to finish any save still being written
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	
 	// Initiates a time loop reset (move to new day)
 	UFUNCTION(BlueprintCallable, Category = "Time Loop")
-	void ResetTimeLoop();
+	void ResetTimeLoop(ELoopEndReason EndReason = ELoopEndReason::Reset);
 	
-	// Save the current game state
+	// Save the current game state in the background
 	UFUNCTION(BlueprintCallable, Category = "Time Loop")
 	void SaveGame();
-		// Load the saved game state
+	
+	// Fired on the game thread once a save has been written
+	UPROPERTY(BlueprintAssignable, Category = "Time Loop|Events")
+	FGameSavedDelegate OnGameSaved;
+	
+	// Codec saves are compressed with; LZ4 favours write latency, Zlib size
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Time Loop|Saving")
+	ESaveCompression SaveCompression;
+	
+	// Load the saved game state of the current slot
 	UFUNCTION(BlueprintCallable, Category = "Time Loop")
 	void LoadGame();
 	
+	// Make a slot current and load it
+	UFUNCTION(BlueprintCallable, Category = "Time Loop")
+	void LoadGameFromSlot(const FString& SlotName);
+	
+	// Choose the slot later saves and loads use
+	UFUNCTION(BlueprintCallable, Category = "Time Loop")
+	void SetCurrentSlot(const FString& SlotName);
+	
+	// Get the slot saves and loads use
+	UFUNCTION(BlueprintPure, Category = "Time Loop")
+	FString GetCurrentSlot() const { return CurrentSlotName; }
+	
 	// Show the game intro sequence
 	UFUNCTION(BlueprintCallable, Category = "Time Loop|Sequence")
 	void StartGameIntroSequence();
@@ -86,6 +121,18 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Time Loop")
 	UDialogueManager* GetDialogueManager() const { return DialogueManager; }
 	
+	// Get the Rule System
+	UFUNCTION(BlueprintPure, Category = "Time Loop")
+	URuleSystem* GetRuleSystem() const { return RuleSystem; }
+	
+	// Get the Loop History
+	UFUNCTION(BlueprintPure, Category = "Time Loop")
+	ULoopHistory* GetLoopHistory() const { return LoopHistory; }
+	
+	// Get the Save Slot Directory
+	UFUNCTION(BlueprintPure, Category = "Time Loop")
+	USaveSlotDirectory* GetSaveSlotDirectory() const { return SaveSlotDirectory; }
+	
 protected:
 	// Initialize all game systems
 	void InitializeGameSystems();
@@ -93,6 +140,23 @@ protected:
 	// Reset all systems to their starting state
 	void ResetAllSystems();
 	
+	// Copy the persistent state of every system into a new save game
+	UTimeLoopSaveGame* CaptureSaveGame();
+	
+	// Restore every system's persistent state from a save game
+	void ApplySaveGame(UTimeLoopSaveGame* SaveGameInstance);
+	
+	// Get the first player's inventory, if they have one
+	UInventoryComponent* GetPlayerInventory() const;
+	
+	// Forward relationship changes from dialogue to the NPC scheduler
+	UFUNCTION()
+	void OnDialogueRelationshipImpacts(const TArray<FDialogueRelationshipImpact>& Impacts);
+	
+	// Close the loop in the history when the day runs out on its own
+	UFUNCTION()
+	void OnDayReset();
+	
 private:
 	// The Time Manager handles game time progression
 	UPROPERTY()
@@ -109,4 +173,26 @@ private:
 	// The Dialogue Manager handles dialogue interactions
 	UPROPERTY()
 	UDialogueManager* DialogueManager;
+	
+	// The Rule System runs authored rules over facts from every system
+	UPROPERTY()
+	URuleSystem* RuleSystem;
+	
+	// The Loop History records what happened in every loop
+	UPROPERTY()
+	ULoopHistory* LoopHistory;
+	
+	// The Save Slot Directory lists saves for load menus
+	UPROPERTY()
+	USaveSlotDirectory* SaveSlotDirectory;
+	
+	// Slot saves and loads go to
+	UPROPERTY()
+	FString CurrentSlotName;
+	
+	// Time played across sessions, restored from the save
+	float PlayTimeSeconds;
+	
+	// Writes save snapshots off the game thread
+	TSharedPtr<FTimeLoopAsyncSaver> AsyncSaver;
 };
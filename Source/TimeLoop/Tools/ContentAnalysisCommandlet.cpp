@@ -0,0 +1,109 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "ContentAnalysisCommandlet.h"
+#include "ContentAnalyzer.h"
+#include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Systems/QuestSystem/KnowledgeFlagRegistry.h"
+#include "ContentLoading.h"
+#include "Misc/Paths.h"
+
+UContentAnalysisCommandlet::UContentAnalysisCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UContentAnalysisCommandlet::Main(const FString& Params)
+{
+    FString DialogueDir = FPaths::ProjectContentDir() / TEXT("Data/Dialogue");
+    FString QuestDir = FPaths::ProjectContentDir() / TEXT("Data/Quests");
+    FString InitialKnowledge;
+    FString ManifestPath = FKnowledgeFlagRegistry::GetDefaultManifestPath();
+    FParse::Value(*Params, TEXT("DialogueDir="), DialogueDir);
+    FParse::Value(*Params, TEXT("QuestDir="), QuestDir);
+    FParse::Value(*Params, TEXT("Knowledge="), InitialKnowledge);
+    FParse::Value(*Params, TEXT("KnowledgeManifest="), ManifestPath);
+    const bool bAllowIssues = FParse::Param(*Params, TEXT("AllowIssues"));
+    const bool bWriteManifest = FParse::Param(*Params, TEXT("WriteKnowledgeManifest"));
+    
+    TArray<FDialogueTree> DialogueTrees;
+    TArray<FQuest> Quests;
+    int32 NumFailed = ContentLoading::LoadContentDirectory(DialogueDir, DialogueTrees, TEXT("Content Analysis"));
+    NumFailed += ContentLoading::LoadContentDirectory(QuestDir, Quests, TEXT("Content Analysis"));
+    
+    FContentAnalyzer Analyzer;
+    for (const FDialogueTree& Tree : DialogueTrees)
+    {
+        Analyzer.AddDialogueTree(Tree);
+    }
+    for (const FQuest& Quest : Quests)
+    {
+        Analyzer.AddQuest(Quest);
+    }
+    
+    TArray<FString> KnowledgeFlags;
+    InitialKnowledge.ParseIntoArray(KnowledgeFlags, TEXT("+"));
+    for (const FString& Flag : KnowledgeFlags)
+    {
+        Analyzer.AddInitialKnowledge(FName(*Flag));
+    }
+    
+    const FContentAnalysisReport Report = Analyzer.Analyze();
+    
+    for (const FContentIssue& Issue : Report.Issues)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Content Analysis: %s"), *Issue.ToString());
+    }
+    
+    UE_LOG(LogTemp, Display, TEXT("Content Analysis: %d trees, %d nodes (%d reachable), %d quests, %d flags (%d learnable)"), 
+        Report.NumTrees, Report.NumNodes, Report.NumReachableNodes, Report.NumQuests, Report.NumFlags, Report.NumLearnableFlags);
+    UE_LOG(LogTemp, Display, TEXT("Content Analysis: %d issues found in %.3f s over %d knowledge passes"), 
+        Report.Issues.Num(), Report.Seconds, Report.KnowledgePasses);
+    
+    if (NumFailed > 0)
+    {
+        return 2;
+    }
+    
+    // Append newly referenced flags to the manifest; existing flags keep their bits
+    if (bWriteManifest)
+    {
+        FKnowledgeFlagRegistry Registry;
+        Registry.LoadManifest(ManifestPath);
+        const int32 NumExisting = Registry.Num();
+        
+        TArray<FName> NewFlags = Analyzer.GetFlagNames();
+        NewFlags.Sort(FNameLexicalLess());
+        for (const FName& FlagName : NewFlags)
+        {
+            Registry.FindOrAdd(FlagName);
+        }
+        
+        if (!Registry.SaveManifest(ManifestPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Content Analysis: Failed to write knowledge manifest %s"), *ManifestPath);
+            return 2;
+        }
+        
+        UE_LOG(LogTemp, Display, TEXT("Content Analysis: Knowledge manifest %s has %d flags (%d new)"), 
+            *ManifestPath, Registry.Num(), Registry.Num() - NumExisting);
+    }
+    return (Report.Issues.Num() > 0 && !bAllowIssues) ? 1 : 0;
+}
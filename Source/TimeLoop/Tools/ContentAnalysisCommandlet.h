@@ -0,0 +1,44 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ContentAnalysisCommandlet.generated.h"
+
+/**
+ * UContentAnalysisCommandlet - Runs the dialogue and quest content analyzer headlessly
+ *
+ * Usage: <Editor>-Cmd <Project> -run=ContentAnalysis [-DialogueDir=<dir>] [-QuestDir=<dir>]
+ *        [-Knowledge=flag1+flag2] [-AllowIssues] [-WriteKnowledgeManifest] [-KnowledgeManifest=<file>]
+ *
+ * Every .json file in the dialogue directory holds an array of FDialogueTree and every
+ * .json file in the quest directory an array of FQuest, in FJsonObjectConverter form.
+ * Returns non-zero when issues are found so CI can gate on it. With -WriteKnowledgeManifest
+ * every referenced knowledge flag is appended to the knowledge flag manifest, which
+ * fixes each flag's bit for runtime checks and saves.
+ */
+UCLASS()
+class TIMELOOP_API UContentAnalysisCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UContentAnalysisCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,708 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "ContentAnalyzer.h"
+#include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+namespace ContentAnalyzerBits
+{
+    inline int32 NumWords(int32 NumBits)
+    {
+        return (NumBits + 63) / 64;
+    }
+
+    inline void Set(TArray<uint64>& Words, int32 Bit)
+    {
+        Words[Bit >> 6] |= (uint64)1 << (Bit & 63);
+    }
+
+    inline bool Test(const TArray<uint64>& Words, int32 Bit)
+    {
+        return (Words[Bit >> 6] & ((uint64)1 << (Bit & 63))) != 0;
+    }
+
+    // A gate of INDEX_NONE is always open
+    inline bool IsOpen(const TArray<uint64>& Known, int32 Flag)
+    {
+        return Flag == INDEX_NONE || Test(Known, Flag);
+    }
+
+    inline bool Any(const TArray<uint64>& Words)
+    {
+        for (uint64 Word : Words)
+        {
+            if (Word)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool Intersects(const TArray<uint64>& A, const TArray<uint64>& B)
+    {
+        for (int32 WordIndex = 0; WordIndex < A.Num(); ++WordIndex)
+        {
+            if (A[WordIndex] & B[WordIndex])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Call Func for every set bit
+    template <typename FuncType>
+    inline void ForEachSetBit(const TArray<uint64>& Words, FuncType Func)
+    {
+        for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+        {
+            uint64 Word = Words[WordIndex];
+            while (Word)
+            {
+                const int32 Bit = (int32)FMath::CountTrailingZeros64(Word);
+                Word &= Word - 1;
+                Func(WordIndex * 64 + Bit);
+            }
+        }
+    }
+}
+
+FString FContentIssue::ToString() const
+{
+    switch (Type)
+    {
+        case EContentIssueType::MissingEntryNode:
+            return FString::Printf(TEXT("Dialogue '%s' has no valid entry node"), *OwnerId.ToString());
+        case EContentIssueType::DanglingChoice:
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' has a choice leading to missing node '%s'"), 
+                *OwnerId.ToString(), *ElementId.ToString(), *Reference.ToString());
+        case EContentIssueType::UnreachableNode:
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' is unreachable"), 
+                *OwnerId.ToString(), *ElementId.ToString());
+        case EContentIssueType::FlagNeverSet:
+            if (ElementId == NAME_None)
+            {
+                return FString::Printf(TEXT("Quest '%s' has a prerequisite on flag '%s' which nothing sets"), 
+                    *OwnerId.ToString(), *Reference.ToString());
+            }
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' requires flag '%s' which nothing sets"), 
+                *OwnerId.ToString(), *ElementId.ToString(), *Reference.ToString());
+        case EContentIssueType::FlagNeverLearned:
+            if (ElementId == NAME_None)
+            {
+                return FString::Printf(TEXT("Quest '%s' has a prerequisite on flag '%s' which is only set by unreachable content"), 
+                    *OwnerId.ToString(), *Reference.ToString());
+            }
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' requires flag '%s' which is only set by unreachable content"), 
+                *OwnerId.ToString(), *ElementId.ToString(), *Reference.ToString());
+        case EContentIssueType::DeadEndNode:
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' is not an end node but offers no choices"), 
+                *OwnerId.ToString(), *ElementId.ToString());
+        case EContentIssueType::TrapCycle:
+            return FString::Printf(TEXT("Dialogue '%s' has a cycle through node '%s' with no way to end the conversation"), 
+                *OwnerId.ToString(), *ElementId.ToString());
+        case EContentIssueType::UnknownQuestTrigger:
+            return FString::Printf(TEXT("Dialogue '%s' node '%s' triggers unknown quest '%s'"), 
+                *OwnerId.ToString(), *ElementId.ToString(), *Reference.ToString());
+        case EContentIssueType::UntriggeredQuest:
+            return FString::Printf(TEXT("Quest '%s' starts unavailable and neither a reachable trigger nor its prerequisites make it available"), 
+                *OwnerId.ToString());
+        default:
+            return TEXT("Unknown issue");
+    }
+}
+
+int32 FContentAnalysisReport::CountIssues(EContentIssueType Type) const
+{
+    int32 Count = 0;
+    for (const FContentIssue& Issue : Issues)
+    {
+        if (Issue.Type == Type)
+        {
+            ++Count;
+        }
+    }
+    return Count;
+}
+
+int32 FContentAnalyzer::FindOrAddFlag(FName FlagName)
+{
+    if (FlagName == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = FlagIndices.Find(FlagName))
+    {
+        return *Existing;
+    }
+    
+    const int32 NewIndex = FlagNames.Add(FlagName);
+    FlagIndices.Add(FlagName, NewIndex);
+    return NewIndex;
+}
+
+void FContentAnalyzer::AddDialogueTree(const FDialogueTree& DialogueTree)
+{
+    FAnalysisTree& Tree = Trees.AddDefaulted_GetRef();
+    Tree.DialogueId = DialogueTree.DialogueId;
+    Tree.EntryNode = INDEX_NONE;
+    
+    TMap<FName, int32> NodeIndices;
+    NodeIndices.Reserve(DialogueTree.Nodes.Num());
+    for (const auto& Pair : DialogueTree.Nodes)
+    {
+        NodeIndices.Add(Pair.Key, NodeIndices.Num());
+    }
+    
+    Tree.Nodes.Reserve(DialogueTree.Nodes.Num());
+    for (const auto& Pair : DialogueTree.Nodes)
+    {
+        const FDialogueNode& SourceNode = Pair.Value;
+        
+        FAnalysisNode& Node = Tree.Nodes.AddDefaulted_GetRef();
+        Node.NodeId = Pair.Key;
+        Node.QuestToTrigger = SourceNode.bTriggersQuest ? SourceNode.QuestToTrigger : NAME_None;
+        Node.RequiredFlag = FindOrAddFlag(SourceNode.RequiredKnowledgeFlag);
+        Node.FlagToSet = FindOrAddFlag(SourceNode.KnowledgeFlagToSet);
+        Node.FirstChoice = Tree.Choices.Num();
+        Node.NumChoices = SourceNode.Choices.Num();
+        Node.bIsEndNode = SourceNode.bIsEndNode;
+        
+        for (const FDialogueChoice& SourceChoice : SourceNode.Choices)
+        {
+            FAnalysisChoice& Choice = Tree.Choices.AddDefaulted_GetRef();
+            Choice.RequiredFlag = FindOrAddFlag(SourceChoice.RequiredKnowledgeFlag);
+            Choice.FlagToSet = FindOrAddFlag(SourceChoice.KnowledgeFlagToSet);
+            Choice.bEndsConversation = SourceChoice.NextNodeId == NAME_None;
+            
+            const int32* NextIndex = NodeIndices.Find(SourceChoice.NextNodeId);
+            Choice.NextNode = NextIndex ? *NextIndex : INDEX_NONE;
+            
+            if (!NextIndex && !Choice.bEndsConversation)
+            {
+                LoadIssues.Add({ EContentIssueType::DanglingChoice, Tree.DialogueId, Pair.Key, SourceChoice.NextNodeId });
+            }
+        }
+    }
+    
+    if (const int32* EntryIndex = NodeIndices.Find(DialogueTree.EntryNodeId))
+    {
+        Tree.EntryNode = *EntryIndex;
+    }
+}
+
+void FContentAnalyzer::AddQuest(const FQuest& Quest)
+{
+    FAnalysisQuest& AnalysisQuest = Quests.AddDefaulted_GetRef();
+    AnalysisQuest.QuestId = Quest.QuestId;
+    AnalysisQuest.bStartsUnavailable = Quest.State == EQuestState::Unavailable;
+    
+    for (const FQuestPrerequisite& SourcePrerequisite : Quest.Prerequisites)
+    {
+        FAnalysisPrerequisite& Prerequisite = AnalysisQuest.Prerequisites.AddDefaulted_GetRef();
+        Prerequisite.Type = (uint8)SourcePrerequisite.Type;
+        Prerequisite.QuestId = SourcePrerequisite.QuestId;
+        Prerequisite.RequiredState = (uint8)SourcePrerequisite.RequiredState;
+        Prerequisite.Flag = SourcePrerequisite.Type == EQuestPrerequisiteType::KnowledgeFlag
+            ? FindOrAddFlag(SourcePrerequisite.KnowledgeFlag)
+            : INDEX_NONE;
+    }
+}
+
+void FContentAnalyzer::AddInitialKnowledge(FName FlagName)
+{
+    const int32 FlagIndex = FindOrAddFlag(FlagName);
+    if (FlagIndex != INDEX_NONE)
+    {
+        InitialFlags.AddUnique(FlagIndex);
+    }
+}
+
+void FContentAnalyzer::ExploreTree(const FAnalysisTree& Tree, const TArray<uint64>& Known, TArray<uint64>& OutVisited, TArray<uint64>& OutLearned) const
+{
+    using namespace ContentAnalyzerBits;
+    
+    const int32 NodeWords = NumWords(Tree.Nodes.Num());
+    OutVisited.Reset();
+    OutVisited.SetNumZeroed(NodeWords);
+    
+    if (Tree.EntryNode == INDEX_NONE || !IsOpen(Known, Tree.Nodes[Tree.EntryNode].RequiredFlag))
+    {
+        return;
+    }
+    
+    TArray<uint64> Frontier;
+    TArray<uint64> Next;
+    Frontier.SetNumZeroed(NodeWords);
+    Next.SetNumZeroed(NodeWords);
+    
+    Set(Frontier, Tree.EntryNode);
+    Set(OutVisited, Tree.EntryNode);
+    
+    // Expand one BFS level at a time; each level is a bitset over the tree's nodes
+    while (Any(Frontier))
+    {
+        ForEachSetBit(Frontier, [&](int32 NodeIndex)
+        {
+            const FAnalysisNode& Node = Tree.Nodes[NodeIndex];
+            if (Node.FlagToSet != INDEX_NONE)
+            {
+                Set(OutLearned, Node.FlagToSet);
+            }
+            
+            for (int32 ChoiceIndex = Node.FirstChoice; ChoiceIndex < Node.FirstChoice + Node.NumChoices; ++ChoiceIndex)
+            {
+                const FAnalysisChoice& Choice = Tree.Choices[ChoiceIndex];
+                if (!IsOpen(Known, Choice.RequiredFlag))
+                {
+                    continue;
+                }
+                
+                if (Choice.FlagToSet != INDEX_NONE)
+                {
+                    Set(OutLearned, Choice.FlagToSet);
+                }
+                
+                const int32 Target = Choice.NextNode;
+                if (Target != INDEX_NONE && !Test(OutVisited, Target) && IsOpen(Known, Tree.Nodes[Target].RequiredFlag))
+                {
+                    Set(OutVisited, Target);
+                    Set(Next, Target);
+                }
+            }
+        });
+        
+        Swap(Frontier, Next);
+        FMemory::Memzero(Next.GetData(), Next.Num() * sizeof(uint64));
+    }
+}
+
+void FContentAnalyzer::CollectTreeIssues(const FAnalysisTree& Tree, const TArray<uint64>& Known, const TArray<uint64>& Visited, const TArray<uint64>& EverSet, TArray<FContentIssue>& OutIssues) const
+{
+    using namespace ContentAnalyzerBits;
+    
+    if (Tree.EntryNode == INDEX_NONE)
+    {
+        OutIssues.Add({ EContentIssueType::MissingEntryNode, Tree.DialogueId, NAME_None, NAME_None });
+        return;
+    }
+    
+    const int32 NumNodes = Tree.Nodes.Num();
+    
+    // Target of a choice that can actually be taken at the knowledge fixpoint
+    auto TraversableTarget = [&](const FAnalysisChoice& Choice) -> int32
+    {
+        if (Choice.NextNode == INDEX_NONE || !IsOpen(Known, Choice.RequiredFlag) || !IsOpen(Known, Tree.Nodes[Choice.NextNode].RequiredFlag))
+        {
+            return INDEX_NONE;
+        }
+        return Choice.NextNode;
+    };
+    
+    // Gating flags that can never be satisfied
+    auto CheckGate = [&](int32 Flag, FName NodeId)
+    {
+        if (Flag == INDEX_NONE || Test(Known, Flag))
+        {
+            return;
+        }
+        const EContentIssueType Type = Test(EverSet, Flag) ? EContentIssueType::FlagNeverLearned : EContentIssueType::FlagNeverSet;
+        OutIssues.Add({ Type, Tree.DialogueId, NodeId, FlagNames[Flag] });
+    };
+    
+    // Reverse edges and conversation exits, restricted to reachable nodes
+    TArray<TArray<int32>> Predecessors;
+    Predecessors.SetNum(NumNodes);
+    TArray<int32> ExitQueue;
+    TArray<uint64> CanExit;
+    CanExit.SetNumZeroed(NumWords(NumNodes));
+    
+    for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+    {
+        const FAnalysisNode& Node = Tree.Nodes[NodeIndex];
+        CheckGate(Node.RequiredFlag, Node.NodeId);
+        
+        if (!Test(Visited, NodeIndex))
+        {
+            OutIssues.Add({ EContentIssueType::UnreachableNode, Tree.DialogueId, Node.NodeId, NAME_None });
+            continue;
+        }
+        
+        if (!Node.bIsEndNode && Node.NumChoices == 0)
+        {
+            OutIssues.Add({ EContentIssueType::DeadEndNode, Tree.DialogueId, Node.NodeId, NAME_None });
+        }
+        
+        bool bIsExit = Node.bIsEndNode;
+        for (int32 ChoiceIndex = Node.FirstChoice; ChoiceIndex < Node.FirstChoice + Node.NumChoices; ++ChoiceIndex)
+        {
+            const FAnalysisChoice& Choice = Tree.Choices[ChoiceIndex];
+            CheckGate(Choice.RequiredFlag, Node.NodeId);
+            
+            if (Choice.bEndsConversation && IsOpen(Known, Choice.RequiredFlag))
+            {
+                bIsExit = true;
+            }
+            
+            const int32 Target = TraversableTarget(Choice);
+            if (Target != INDEX_NONE)
+            {
+                Predecessors[Target].Add(NodeIndex);
+            }
+        }
+        
+        if (bIsExit)
+        {
+            Set(CanExit, NodeIndex);
+            ExitQueue.Add(NodeIndex);
+        }
+    }
+    
+    // Everything that can walk to an exit
+    for (int32 QueueIndex = 0; QueueIndex < ExitQueue.Num(); ++QueueIndex)
+    {
+        for (int32 Predecessor : Predecessors[ExitQueue[QueueIndex]])
+        {
+            if (!Test(CanExit, Predecessor))
+            {
+                Set(CanExit, Predecessor);
+                ExitQueue.Add(Predecessor);
+            }
+        }
+    }
+    
+    // Iterative Tarjan over the reachable subgraph to find cycles among the nodes that cannot exit
+    TArray<int32> Order;
+    TArray<int32> LowLink;
+    TArray<int32> Stack;
+    TArray<bool> OnStack;
+    TArray<TPair<int32, int32>> CallStack;
+    Order.Init(INDEX_NONE, NumNodes);
+    LowLink.Init(0, NumNodes);
+    OnStack.Init(false, NumNodes);
+    int32 Counter = 0;
+    
+    for (int32 Root = 0; Root < NumNodes; ++Root)
+    {
+        if (!Test(Visited, Root) || Test(CanExit, Root) || Order[Root] != INDEX_NONE)
+        {
+            continue;
+        }
+        
+        Order[Root] = LowLink[Root] = Counter++;
+        Stack.Push(Root);
+        OnStack[Root] = true;
+        CallStack.Emplace(Root, 0);
+        
+        while (CallStack.Num() > 0)
+        {
+            const int32 NodeIndex = CallStack.Last().Key;
+            const FAnalysisNode& Node = Tree.Nodes[NodeIndex];
+            
+            if (CallStack.Last().Value < Node.NumChoices)
+            {
+                const int32 Target = TraversableTarget(Tree.Choices[Node.FirstChoice + CallStack.Last().Value++]);
+                
+                // Nodes that can exit are never part of a trap
+                if (Target == INDEX_NONE || Test(CanExit, Target))
+                {
+                    continue;
+                }
+                
+                if (Order[Target] == INDEX_NONE)
+                {
+                    Order[Target] = LowLink[Target] = Counter++;
+                    Stack.Push(Target);
+                    OnStack[Target] = true;
+                    CallStack.Emplace(Target, 0);
+                }
+                else if (OnStack[Target])
+                {
+                    LowLink[NodeIndex] = FMath::Min(LowLink[NodeIndex], Order[Target]);
+                }
+                continue;
+            }
+            
+            if (LowLink[NodeIndex] == Order[NodeIndex])
+            {
+                // Pop the component; it is a cycle if it has several nodes or a self loop
+                int32 ComponentSize = 0;
+                int32 Member;
+                do
+                {
+                    Member = Stack.Pop(false);
+                    OnStack[Member] = false;
+                    ++ComponentSize;
+                }
+                while (Member != NodeIndex);
+                
+                bool bSelfLoop = false;
+                for (int32 ChoiceIndex = Node.FirstChoice; ChoiceIndex < Node.FirstChoice + Node.NumChoices; ++ChoiceIndex)
+                {
+                    bSelfLoop |= TraversableTarget(Tree.Choices[ChoiceIndex]) == NodeIndex;
+                }
+                
+                if (ComponentSize > 1 || bSelfLoop)
+                {
+                    OutIssues.Add({ EContentIssueType::TrapCycle, Tree.DialogueId, Node.NodeId, NAME_None });
+                }
+            }
+            
+            CallStack.Pop(false);
+            if (CallStack.Num() > 0)
+            {
+                const int32 Parent = CallStack.Last().Key;
+                LowLink[Parent] = FMath::Min(LowLink[Parent], LowLink[NodeIndex]);
+            }
+        }
+    }
+}
+
+FContentAnalysisReport FContentAnalyzer::Analyze() const
+{
+    using namespace ContentAnalyzerBits;
+    
+    const double StartTime = FPlatformTime::Seconds();
+    
+    FContentAnalysisReport Report;
+    Report.NumTrees = Trees.Num();
+    Report.NumQuests = Quests.Num();
+    Report.NumFlags = FlagNames.Num();
+    
+    const int32 FlagWords = NumWords(FlagNames.Num());
+    
+    // Per-tree gate sets decide which trees a newly learned flag can affect
+    TArray<TArray<uint64>> TreeGates;
+    TreeGates.SetNum(Trees.Num());
+    TArray<uint64> EverSet;
+    EverSet.SetNumZeroed(FlagWords);
+    
+    for (int32 TreeIndex = 0; TreeIndex < Trees.Num(); ++TreeIndex)
+    {
+        const FAnalysisTree& Tree = Trees[TreeIndex];
+        TArray<uint64>& Gates = TreeGates[TreeIndex];
+        Gates.SetNumZeroed(FlagWords);
+        Report.NumNodes += Tree.Nodes.Num();
+        
+        for (const FAnalysisNode& Node : Tree.Nodes)
+        {
+            if (Node.RequiredFlag != INDEX_NONE)
+            {
+                Set(Gates, Node.RequiredFlag);
+            }
+            if (Node.FlagToSet != INDEX_NONE)
+            {
+                Set(EverSet, Node.FlagToSet);
+            }
+        }
+        for (const FAnalysisChoice& Choice : Tree.Choices)
+        {
+            if (Choice.RequiredFlag != INDEX_NONE)
+            {
+                Set(Gates, Choice.RequiredFlag);
+            }
+            if (Choice.FlagToSet != INDEX_NONE)
+            {
+                Set(EverSet, Choice.FlagToSet);
+            }
+        }
+    }
+    
+    TArray<uint64> Known;
+    Known.SetNumZeroed(FlagWords);
+    for (int32 FlagIndex : InitialFlags)
+    {
+        Set(Known, FlagIndex);
+        Set(EverSet, FlagIndex);
+    }
+    
+    // Knowledge fixpoint: explore, add what was learned, re-explore only the trees it ungates
+    TArray<TArray<uint64>> Visited;
+    TArray<TArray<uint64>> Learned;
+    Visited.SetNum(Trees.Num());
+    Learned.SetNum(Trees.Num());
+    for (TArray<uint64>& TreeLearned : Learned)
+    {
+        TreeLearned.SetNumZeroed(FlagWords);
+    }
+    
+    TArray<bool> DirtyTrees;
+    DirtyTrees.Init(true, Trees.Num());
+    
+    while (true)
+    {
+        ++Report.KnowledgePasses;
+        
+        ParallelFor(Trees.Num(), [&](int32 TreeIndex)
+        {
+            if (DirtyTrees[TreeIndex])
+            {
+                ExploreTree(Trees[TreeIndex], Known, Visited[TreeIndex], Learned[TreeIndex]);
+            }
+        });
+        
+        TArray<uint64> Added;
+        Added.SetNumZeroed(FlagWords);
+        for (const TArray<uint64>& TreeLearned : Learned)
+        {
+            for (int32 WordIndex = 0; WordIndex < FlagWords; ++WordIndex)
+            {
+                Added[WordIndex] |= TreeLearned[WordIndex] & ~Known[WordIndex];
+            }
+        }
+        
+        if (!Any(Added))
+        {
+            break;
+        }
+        
+        for (int32 WordIndex = 0; WordIndex < FlagWords; ++WordIndex)
+        {
+            Known[WordIndex] |= Added[WordIndex];
+        }
+        
+        for (int32 TreeIndex = 0; TreeIndex < Trees.Num(); ++TreeIndex)
+        {
+            DirtyTrees[TreeIndex] = Intersects(TreeGates[TreeIndex], Added);
+        }
+    }
+    
+    ForEachSetBit(Known, [&](int32) { ++Report.NumLearnableFlags; });
+    
+    // Per-tree issue collection is independent, gather in parallel then append in tree order
+    TArray<TArray<FContentIssue>> TreeIssues;
+    TreeIssues.SetNum(Trees.Num());
+    ParallelFor(Trees.Num(), [&](int32 TreeIndex)
+    {
+        CollectTreeIssues(Trees[TreeIndex], Known, Visited[TreeIndex], EverSet, TreeIssues[TreeIndex]);
+    });
+    
+    Report.Issues.Append(LoadIssues);
+    for (const TArray<FContentIssue>& Issues : TreeIssues)
+    {
+        Report.Issues.Append(Issues);
+    }
+    
+    // Quest triggers are only counted from reachable nodes
+    TMap<FName, int32> QuestIndices;
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        QuestIndices.Add(Quests[QuestIndex].QuestId, QuestIndex);
+    }
+    
+    TSet<FName> TriggeredQuests;
+    for (int32 TreeIndex = 0; TreeIndex < Trees.Num(); ++TreeIndex)
+    {
+        const FAnalysisTree& Tree = Trees[TreeIndex];
+        ForEachSetBit(Visited[TreeIndex], [&](int32 NodeIndex)
+        {
+            ++Report.NumReachableNodes;
+            
+            const FAnalysisNode& Node = Tree.Nodes[NodeIndex];
+            if (Node.QuestToTrigger == NAME_None)
+            {
+                return;
+            }
+            
+            if (QuestIndices.Contains(Node.QuestToTrigger))
+            {
+                TriggeredQuests.Add(Node.QuestToTrigger);
+            }
+            else
+            {
+                Report.Issues.Add({ EContentIssueType::UnknownQuestTrigger, Tree.DialogueId, Node.NodeId, Node.QuestToTrigger });
+            }
+        });
+    }
+    
+    // Gated quests follow their prerequisites alone, and quest state prerequisites chain,
+    // so which quests can ever become available is its own fixpoint over the learnable knowledge
+    TArray<bool> Obtainable;
+    Obtainable.Init(false, Quests.Num());
+    
+    auto CanHold = [&](const FAnalysisPrerequisite& Prerequisite)
+    {
+        switch ((EQuestPrerequisiteType)Prerequisite.Type)
+        {
+            case EQuestPrerequisiteType::KnowledgeFlag:
+                return IsOpen(Known, Prerequisite.Flag);
+            case EQuestPrerequisiteType::QuestState:
+            {
+                if ((EQuestState)Prerequisite.RequiredState == EQuestState::Unavailable)
+                {
+                    return true;
+                }
+                const int32* RequiredQuest = QuestIndices.Find(Prerequisite.QuestId);
+                return RequiredQuest && Obtainable[*RequiredQuest];
+            }
+            default:
+                // Every loop count is reached eventually
+                return true;
+        }
+    };
+    
+    bool bQuestsChanged = true;
+    while (bQuestsChanged)
+    {
+        bQuestsChanged = false;
+        for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+        {
+            if (Obtainable[QuestIndex])
+            {
+                continue;
+            }
+            
+            const FAnalysisQuest& Quest = Quests[QuestIndex];
+            bool bObtainable = Quest.Prerequisites.Num() > 0 || !Quest.bStartsUnavailable || TriggeredQuests.Contains(Quest.QuestId);
+            for (const FAnalysisPrerequisite& Prerequisite : Quest.Prerequisites)
+            {
+                bObtainable &= CanHold(Prerequisite);
+            }
+            
+            if (bObtainable)
+            {
+                Obtainable[QuestIndex] = true;
+                bQuestsChanged = true;
+            }
+        }
+    }
+    
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        const FAnalysisQuest& Quest = Quests[QuestIndex];
+        for (const FAnalysisPrerequisite& Prerequisite : Quest.Prerequisites)
+        {
+            if (Prerequisite.Flag != INDEX_NONE && !Test(Known, Prerequisite.Flag))
+            {
+                const EContentIssueType Type = Test(EverSet, Prerequisite.Flag) ? EContentIssueType::FlagNeverLearned : EContentIssueType::FlagNeverSet;
+                Report.Issues.Add({ Type, Quest.QuestId, NAME_None, FlagNames[Prerequisite.Flag] });
+            }
+        }
+        
+        if (Quest.bStartsUnavailable && !Obtainable[QuestIndex])
+        {
+            Report.Issues.Add({ EContentIssueType::UntriggeredQuest, Quest.QuestId, NAME_None, NAME_None });
+        }
+    }
+    
+    Report.Seconds = FPlatformTime::Seconds() - StartTime;
+    return Report;
+}
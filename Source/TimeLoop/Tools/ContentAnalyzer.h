@@ -0,0 +1,182 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FDialogueTree;
+struct FQuest;
+
+/**
+ * EContentIssueType - Kinds of problems the content analyzer reports
+ */
+enum class EContentIssueType : uint8
+{
+    // Dialogue tree has no valid entry node
+    MissingEntryNode,
+    // A choice points at a node that does not exist in its tree
+    DanglingChoice,
+    // A node can never be reached under any knowledge the player can gain
+    UnreachableNode,
+    // A node, choice or quest prerequisite requires a flag that no content ever sets
+    FlagNeverSet,
+    // A node, choice or quest prerequisite requires a flag that is only set by unreachable content
+    FlagNeverLearned,
+    // A reachable node that is not an end node and offers no choices
+    DeadEndNode,
+    // A reachable cycle from which the conversation can never end
+    TrapCycle,
+    // A node triggers a quest that does not exist
+    UnknownQuestTrigger,
+    // A quest starts unavailable and neither a reachable trigger nor its prerequisites ever make it available
+    UntriggeredQuest
+};
+
+/**
+ * FContentIssue - A single finding of the content analyzer
+ */
+struct FContentIssue
+{
+    EContentIssueType Type;
+
+    // The dialogue tree or quest the issue was found in
+    FName OwnerId;
+
+    // The node the issue was found at, None for issues found on a quest
+    FName ElementId;
+
+    // The flag, node or quest the issue refers to, if any
+    FName Reference;
+
+    FString ToString() const;
+};
+
+/**
+ * FContentAnalysisReport - Result of a content analysis run
+ */
+struct FContentAnalysisReport
+{
+    TArray<FContentIssue> Issues;
+
+    int32 NumTrees = 0;
+    int32 NumNodes = 0;
+    int32 NumQuests = 0;
+    int32 NumFlags = 0;
+    int32 NumReachableNodes = 0;
+    int32 NumLearnableFlags = 0;
+
+    // Number of knowledge fixpoint passes it took to converge
+    int32 KnowledgePasses = 0;
+
+    double Seconds = 0.0;
+
+    int32 CountIssues(EContentIssueType Type) const;
+};
+
+/**
+ * FContentAnalyzer - Reachability and dead-content analysis for dialogue and quests
+ *
+ * Knowledge only ever grows during play and gates are never negated, so the
+ * set of reachable content under every knowledge state the player can reach
+ * is the reachable set at the knowledge fixpoint. The analyzer finds that
+ * fixpoint with a bitset-frontier BFS per tree, running trees in parallel and
+ * re-exploring only trees gated on flags learned in the previous pass.
+ */
+class TIMELOOP_API FContentAnalyzer
+{
+public:
+    // Add a dialogue tree to analyze
+    void AddDialogueTree(const FDialogueTree& DialogueTree);
+
+    // Add a quest to analyze
+    void AddQuest(const FQuest& Quest);
+
+    // Treat a flag as known before any dialogue runs
+    void AddInitialKnowledge(FName FlagName);
+
+    // Run the analysis
+    FContentAnalysisReport Analyze() const;
+
+    // Every knowledge flag referenced by the added content, in first-seen order
+    const TArray<FName>& GetFlagNames() const { return FlagNames; }
+
+private:
+    struct FAnalysisChoice
+    {
+        int32 NextNode;
+        int32 RequiredFlag;
+        int32 FlagToSet;
+        bool bEndsConversation;
+    };
+
+    struct FAnalysisNode
+    {
+        FName NodeId;
+        FName QuestToTrigger;
+        int32 RequiredFlag;
+        int32 FlagToSet;
+        int32 FirstChoice;
+        int32 NumChoices;
+        bool bIsEndNode;
+    };
+
+    struct FAnalysisTree
+    {
+        FName DialogueId;
+        int32 EntryNode;
+        TArray<FAnalysisNode> Nodes;
+        TArray<FAnalysisChoice> Choices;
+
+        // Bitset of flags that gate any node or choice in this tree
+        TArray<uint64> GateFlags;
+    };
+
+    struct FAnalysisPrerequisite
+    {
+        uint8 Type;
+        FName QuestId;
+        uint8 RequiredState;
+        int32 Flag;
+    };
+
+    struct FAnalysisQuest
+    {
+        FName QuestId;
+        bool bStartsUnavailable;
+
+        // A quest with prerequisites is made available by them alone
+        TArray<FAnalysisPrerequisite> Prerequisites;
+    };
+
+    // Get the dense index of a flag, INDEX_NONE for NAME_None
+    int32 FindOrAddFlag(FName FlagName);
+
+    // BFS over the nodes reachable with the given knowledge
+    void ExploreTree(const FAnalysisTree& Tree, const TArray<uint64>& Known, TArray<uint64>& OutVisited, TArray<uint64>& OutLearned) const;
+
+    // Collect the issues of one tree once knowledge has converged
+    void CollectTreeIssues(const FAnalysisTree& Tree, const TArray<uint64>& Known, const TArray<uint64>& Visited, const TArray<uint64>& EverSet, TArray<FContentIssue>& OutIssues) const;
+
+    TArray<FAnalysisTree> Trees;
+    TArray<FAnalysisQuest> Quests;
+    TArray<FName> FlagNames;
+    TMap<FName, int32> FlagIndices;
+    TArray<int32> InitialFlags;
+
+    // Issues found while loading content
+    TArray<FContentIssue> LoadIssues;
+};
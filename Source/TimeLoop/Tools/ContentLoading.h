@@ -0,0 +1,49 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JsonObjectConverter.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace ContentLoading
+{
+    // Load every JSON array of StructType found in a directory, returning the number of files that failed
+    template <typename StructType>
+    int32 LoadContentDirectory(const FString& Directory, TArray<StructType>& OutContent, const TCHAR* LogPrefix)
+    {
+        TArray<FString> Files;
+        IFileManager::Get().FindFiles(Files, *(Directory / TEXT("*.json")), true, false);
+        
+        int32 NumFailed = 0;
+        for (const FString& File : Files)
+        {
+            FString Json;
+            TArray<StructType> FileContent;
+            if (!FFileHelper::LoadFileToString(Json, *(Directory / File))
+                || !FJsonObjectConverter::JsonArrayStringToUStruct(Json, &FileContent, 0, 0))
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s: Failed to load %s"), LogPrefix, *(Directory / File));
+                ++NumFailed;
+                continue;
+            }
+            OutContent.Append(MoveTemp(FileContent));
+        }
+        return NumFailed;
+    }
+}
@@ -0,0 +1,266 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include "ItemIconAtlasCommandlet.h"
+#include "Systems/ItemSystem/ItemDefinitionRegistry.h"
+#include "Systems/ItemSystem/ItemIconCache.h"
+#include "ContentLoading.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Texture2D.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+#if WITH_EDITOR
+namespace
+{
+    struct FAtlasIcon
+    {
+        FName ItemID;
+        int32 Width = 0;
+        int32 Height = 0;
+        TArray<FColor> Pixels;
+        
+        // Placement of the icon's pixels, padding excluded
+        int32 Page = INDEX_NONE;
+        int32 X = 0;
+        int32 Y = 0;
+    };
+    
+    // Read the top mip of an uncompressed 8-bit source texture
+    bool ReadSourcePixels(UTexture2D* Texture, FAtlasIcon& OutIcon)
+    {
+        FTextureSource& Source = Texture->Source;
+        if (!Source.IsValid() || Source.GetFormat() != TSF_BGRA8 || Source.GetNumSlices() != 1)
+        {
+            return false;
+        }
+        
+        TArray64<uint8> Data;
+        if (!Source.GetMipData(Data, 0))
+        {
+            return false;
+        }
+        
+        OutIcon.Width = Source.GetSizeX();
+        OutIcon.Height = Source.GetSizeY();
+        OutIcon.Pixels.SetNumUninitialized(OutIcon.Width * OutIcon.Height);
+        FMemory::Memcpy(OutIcon.Pixels.GetData(), Data.GetData(), OutIcon.Pixels.Num() * sizeof(FColor));
+        return true;
+    }
+    
+    // Tallest first into rows across each page, starting a page when one fills; returns the page count
+    int32 PackIcons(TArray<FAtlasIcon>& Icons, int32 PageSize, int32 Padding)
+    {
+        Icons.Sort([](const FAtlasIcon& A, const FAtlasIcon& B)
+        {
+            return A.Height != B.Height ? A.Height > B.Height : A.Width > B.Width;
+        });
+        
+        int32 Page = 0;
+        int32 CursorX = 0;
+        int32 CursorY = 0;
+        int32 ShelfHeight = 0;
+        for (FAtlasIcon& Icon : Icons)
+        {
+            const int32 CellWidth = Icon.Width + Padding * 2;
+            const int32 CellHeight = Icon.Height + Padding * 2;
+            if (CursorX + CellWidth > PageSize)
+            {
+                CursorX = 0;
+                CursorY += ShelfHeight;
+                ShelfHeight = 0;
+            }
+            if (CursorY + CellHeight > PageSize)
+            {
+                ++Page;
+                CursorX = 0;
+                CursorY = 0;
+                ShelfHeight = 0;
+            }
+            
+            Icon.Page = Page;
+            Icon.X = CursorX + Padding;
+            Icon.Y = CursorY + Padding;
+            CursorX += CellWidth;
+            ShelfHeight = FMath::Max(ShelfHeight, CellHeight);
+        }
+        
+        return Icons.Num() > 0 ? Page + 1 : 0;
+    }
+    
+    // Copy an icon onto its page, repeating its edge pixels across the padding
+    void BlitIcon(const FAtlasIcon& Icon, int32 PageSize, int32 Padding, TArray<FColor>& PagePixels)
+    {
+        for (int32 Y = -Padding; Y < Icon.Height + Padding; ++Y)
+        {
+            const int32 SourceY = FMath::Clamp(Y, 0, Icon.Height - 1);
+            for (int32 X = -Padding; X < Icon.Width + Padding; ++X)
+            {
+                const int32 SourceX = FMath::Clamp(X, 0, Icon.Width - 1);
+                PagePixels[(Icon.Y + Y) * PageSize + Icon.X + X] = Icon.Pixels[SourceY * Icon.Width + SourceX];
+            }
+        }
+    }
+    
+    // Save one atlas page as a UI texture asset
+    bool SaveAtlasPage(const FString& PackageName, int32 PageSize, const TArray<FColor>& PagePixels)
+    {
+        UPackage* Package = CreatePackage(*PackageName);
+        Package->FullyLoad();
+        
+        const FName AssetName(*FPackageName::GetLongPackageAssetName(PackageName));
+        UTexture2D* Texture = FindObject<UTexture2D>(Package, *AssetName.ToString());
+        if (!Texture)
+        {
+            Texture = NewObject<UTexture2D>(Package, AssetName, RF_Public | RF_Standalone);
+        }
+        
+        Texture->Source.Init(PageSize, PageSize, 1, 1, TSF_BGRA8, reinterpret_cast<const uint8*>(PagePixels.GetData()));
+        Texture->LODGroup = TEXTUREGROUP_UI;
+        Texture->CompressionSettings = TC_EditorIcon;
+        Texture->MipGenSettings = TMGS_NoMipmaps;
+        Texture->SRGB = true;
+        Texture->PostEditChange();
+        Package->MarkPackageDirty();
+        
+        const FString FileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        return UPackage::SavePackage(Package, Texture, *FileName, SaveArgs);
+    }
+}
+#endif
+
+UItemIconAtlasCommandlet::UItemIconAtlasCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UItemIconAtlasCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString ItemDir = FItemDefinitionRegistry::GetDefaultContentDirectory();
+    FString AtlasPackage = TEXT("/Game/UI/ItemIcons/T_ItemIconAtlas");
+    FString ManifestPath = FItemIconCache::GetDefaultManifestDirectory() / TEXT("IconAtlas.json");
+    int32 MaxIconSize = 128;
+    int32 PageSize = 1024;
+    int32 Padding = 2;
+    FParse::Value(*Params, TEXT("ItemDir="), ItemDir);
+    FParse::Value(*Params, TEXT("AtlasPackage="), AtlasPackage);
+    FParse::Value(*Params, TEXT("Manifest="), ManifestPath);
+    FParse::Value(*Params, TEXT("MaxIconSize="), MaxIconSize);
+    FParse::Value(*Params, TEXT("PageSize="), PageSize);
+    FParse::Value(*Params, TEXT("Padding="), Padding);
+    Padding = FMath::Max(0, Padding);
+    MaxIconSize = FMath::Clamp(MaxIconSize, 1, PageSize - Padding * 2);
+    
+    TArray<FItemDefinition> Definitions;
+    if (ContentLoading::LoadContentDirectory(ItemDir, Definitions, TEXT("Item Icon Atlas")) > 0)
+    {
+        return 2;
+    }
+    
+    // Gather every icon small enough to share a page; the rest stay standalone textures
+    TArray<FAtlasIcon> Icons;
+    int32 NumStandalone = 0;
+    for (const FItemDefinition& Definition : Definitions)
+    {
+        if (Definition.Icon.IsNull())
+        {
+            continue;
+        }
+        
+        UTexture2D* Texture = Definition.Icon.LoadSynchronous();
+        FAtlasIcon Icon;
+        Icon.ItemID = Definition.ItemID;
+        if (!Texture || !ReadSourcePixels(Texture, Icon) || Icon.Width > MaxIconSize || Icon.Height > MaxIconSize)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Item Icon Atlas: Leaving %s standalone (%s)"), 
+                *Definition.ItemID.ToString(), *Definition.Icon.ToString());
+            ++NumStandalone;
+            continue;
+        }
+        Icons.Add(MoveTemp(Icon));
+    }
+    
+    const int32 NumPages = PackIcons(Icons, PageSize, Padding);
+    
+    TArray<FItemIconAtlasEntry> Entries;
+    for (int32 Page = 0; Page < NumPages; ++Page)
+    {
+        TArray<FColor> PagePixels;
+        PagePixels.SetNumZeroed(PageSize * PageSize);
+        for (const FAtlasIcon& Icon : Icons)
+        {
+            if (Icon.Page == Page)
+            {
+                BlitIcon(Icon, PageSize, Padding, PagePixels);
+            }
+        }
+        
+        const FString PackageName = FString::Printf(TEXT("%s_%d"), *AtlasPackage, Page);
+        if (!SaveAtlasPage(PackageName, PageSize, PagePixels))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Item Icon Atlas: Failed to save %s"), *PackageName);
+            return 1;
+        }
+        
+        const FSoftObjectPath PagePath(FString::Printf(TEXT("%s.%s"), *PackageName, *FPackageName::GetLongPackageAssetName(PackageName)));
+        for (const FAtlasIcon& Icon : Icons)
+        {
+            if (Icon.Page == Page)
+            {
+                FItemIconAtlasEntry& Entry = Entries.AddDefaulted_GetRef();
+                Entry.ItemID = Icon.ItemID;
+                Entry.Atlas = TSoftObjectPtr<UTexture2D>(PagePath);
+                Entry.UVMin = FVector2D(Icon.X, Icon.Y) / PageSize;
+                Entry.UVMax = FVector2D(Icon.X + Icon.Width, Icon.Y + Icon.Height) / PageSize;
+            }
+        }
+    }
+    
+    TArray<TSharedPtr<FJsonValue>> JsonEntries;
+    for (const FItemIconAtlasEntry& Entry : Entries)
+    {
+        JsonEntries.Add(MakeShared<FJsonValueObject>(FJsonObjectConverter::UStructToJsonObject(Entry)));
+    }
+    
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    if (!FJsonSerializer::Serialize(JsonEntries, Writer) || !FFileHelper::SaveStringToFile(Json, *ManifestPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Item Icon Atlas: Failed to write manifest %s"), *ManifestPath);
+        return 1;
+    }
+    
+    UE_LOG(LogTemp, Display, TEXT("Item Icon Atlas: Packed %d icons into %d %dx%d pages, %d left standalone, manifest %s"), 
+        Entries.Num(), NumPages, PageSize, PageSize, NumStandalone, *ManifestPath);
+    return 0;
+#else
+    UE_LOG(LogTemp, Error, TEXT("Item Icon Atlas: Needs editor-only texture source data, run it from the editor build"));
+    return 1;
+#endif
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ItemIconAtlasCommandlet.generated.h"
+
+/**
+ * UItemIconAtlasCommandlet - Packs small item icons into shared atlas textures before cooking
+ *
+ * Usage: <Editor>-Cmd <Project> -run=ItemIconAtlas [-ItemDir=<dir>] [-AtlasPackage=<long package name>]
+ *        [-Manifest=<file>] [-MaxIconSize=<n>] [-PageSize=<n>] [-Padding=<n>]
+ *
+ * Loads every item definition, reads the source pixels of each icon no larger than
+ * MaxIconSize on either side, and shelf-packs them into square pages saved as
+ * <AtlasPackage>_<page>. Each icon's edge pixels are extruded into its padding so
+ * filtering never picks up a neighbour. The manifest lists every packed item with
+ * its page and UV rectangle; at runtime the item icon cache draws packed icons from
+ * their page and streams the rest on their own. Run it before cooking whenever item
+ * icons change. Returns non-zero if content could not be loaded or a page could not
+ * be saved.
+ */
+UCLASS()
+class TIMELOOP_API UItemIconAtlasCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UItemIconAtlasCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,313 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include "QuestRouteCommandlet.h"
+#include "QuestRouteSolver.h"
+#include "ContentLoading.h"
+#include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // Time-of-day names used by the data files, in ETimeOfDay order, with the hour each begins
+    const TCHAR* const TimeOfDayNames[] = { TEXT("morning"), TEXT("afternoon"), TEXT("evening"), TEXT("night") };
+    const int32 TimeOfDayStartHours[] = { 5, 10, 17, 21 };
+
+    bool LoadJsonFile(const FString& Path, TSharedPtr<FJsonValue>& OutValue)
+    {
+        FString Json;
+        if (!FFileHelper::LoadFileToString(Json, *Path))
+        {
+            return false;
+        }
+        
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+        return FJsonSerializer::Deserialize(Reader, OutValue) && OutValue.IsValid();
+    }
+
+    bool LoadLocations(const FString& Path, FQuestRouteSolver& Solver)
+    {
+        TSharedPtr<FJsonValue> Root;
+        if (!LoadJsonFile(Path, Root) || Root->Type != EJson::Object)
+        {
+            return false;
+        }
+        
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Root->AsObject()->Values)
+        {
+            const TSharedPtr<FJsonObject>* Location = nullptr;
+            if (!Pair.Value->TryGetObject(Location))
+            {
+                continue;
+            }
+            
+            TArray<FString> Connections;
+            (*Location)->TryGetStringArrayField(TEXT("connections"), Connections);
+            TArray<FName> ConnectionNames;
+            for (const FString& Connection : Connections)
+            {
+                ConnectionNames.Add(FName(*Connection));
+            }
+            
+            uint8 TimesOfDayMask = 0;
+            TArray<FString> AvailableTimes;
+            (*Location)->TryGetStringArrayField(TEXT("available_times"), AvailableTimes);
+            for (int32 TimeOfDay = 0; TimeOfDay < UE_ARRAY_COUNT(TimeOfDayNames); ++TimeOfDay)
+            {
+                if (AvailableTimes.Contains(TimeOfDayNames[TimeOfDay]))
+                {
+                    TimesOfDayMask |= 1 << TimeOfDay;
+                }
+            }
+            
+            Solver.AddLocation(FName(*Pair.Key), ConnectionNames, TimesOfDayMask);
+        }
+        return true;
+    }
+
+    bool LoadSchedules(const FString& Path, FQuestRouteSolver& Solver)
+    {
+        TSharedPtr<FJsonValue> Root;
+        if (!LoadJsonFile(Path, Root) || Root->Type != EJson::Object)
+        {
+            return false;
+        }
+        
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Root->AsObject()->Values)
+        {
+            const TSharedPtr<FJsonObject>* Character = nullptr;
+            const TSharedPtr<FJsonObject>* Schedule = nullptr;
+            if (!Pair.Value->TryGetObject(Character) || !(*Character)->TryGetObjectField(TEXT("schedule"), Schedule))
+            {
+                continue;
+            }
+            
+            for (int32 TimeOfDay = 0; TimeOfDay < UE_ARRAY_COUNT(TimeOfDayNames); ++TimeOfDay)
+            {
+                FString LocationId;
+                if ((*Schedule)->TryGetStringField(TimeOfDayNames[TimeOfDay], LocationId))
+                {
+                    Solver.AddScheduleEntry(FName(*Pair.Key), TimeOfDayStartHours[TimeOfDay], FName(*LocationId));
+                }
+            }
+        }
+        return true;
+    }
+
+    bool LoadItemSources(const FString& Path, FQuestRouteSolver& Solver)
+    {
+        TSharedPtr<FJsonValue> Root;
+        if (!LoadJsonFile(Path, Root) || Root->Type != EJson::Array)
+        {
+            return false;
+        }
+        
+        for (const TSharedPtr<FJsonValue>& Value : Root->AsArray())
+        {
+            const TSharedPtr<FJsonObject>* Source = nullptr;
+            FString LocationId;
+            FString InteractionId;
+            FString ItemId;
+            if (Value->TryGetObject(Source)
+                && (*Source)->TryGetStringField(TEXT("location"), LocationId)
+                && (*Source)->TryGetStringField(TEXT("item"), ItemId))
+            {
+                (*Source)->TryGetStringField(TEXT("interaction"), InteractionId);
+                Solver.AddItemSource(FName(*LocationId), FName(*InteractionId), FName(*ItemId));
+            }
+        }
+        return true;
+    }
+
+    // Solve a tiny built-in world whose only quest needs a wait for an NPC who arrives in the evening,
+    // so a solver that prunes waiting fails on its own before any real quest is reported unsolvable
+    bool RunScheduleWaitCheck(const FRouteSolverSettings& Settings)
+    {
+        FQuestRouteSolver Solver;
+        Solver.AddLocation(TEXT("check_square"), TArray<FName>(), 0);
+        Solver.AddLocation(TEXT("check_harbor"), TArray<FName>(), 0);
+        Solver.AddScheduleEntry(TEXT("check_lamplighter"), TimeOfDayStartHours[0], TEXT("check_harbor"));
+        Solver.AddScheduleEntry(TEXT("check_lamplighter"), TimeOfDayStartHours[2], TEXT("check_square"));
+        Solver.AddScheduleEntry(TEXT("check_lamplighter"), TimeOfDayStartHours[3], TEXT("check_harbor"));
+        Solver.SetStartLocation(TEXT("check_square"));
+        
+        FDialogueNode Greeting;
+        Greeting.NodeId = TEXT("greeting");
+        FDialogueChoice Farewell;
+        Farewell.ChoiceText = FText::FromString(TEXT("Goodnight"));
+        Farewell.NextNodeId = TEXT("goodbye");
+        FDialogueChoice Ask;
+        Ask.ChoiceText = FText::FromString(TEXT("Why only at dusk?"));
+        Ask.NextNodeId = TEXT("goodbye");
+        Ask.KnowledgeFlagToSet = TEXT("check_lamplighter_secret");
+        Greeting.Choices.Add(Farewell);
+        Greeting.Choices.Add(Ask);
+        
+        FDialogueNode Goodbye;
+        Goodbye.NodeId = TEXT("goodbye");
+        Goodbye.bIsEndNode = true;
+        
+        FDialogueTree Tree;
+        Tree.DialogueId = TEXT("check_lamplighter_evening");
+        Tree.NPCId = TEXT("check_lamplighter");
+        Tree.EntryNodeId = Greeting.NodeId;
+        Tree.Nodes.Add(Greeting.NodeId, Greeting);
+        Tree.Nodes.Add(Goodbye.NodeId, Goodbye);
+        Solver.AddDialogueTree(Tree);
+        
+        FQuestObjective Objective;
+        Objective.ObjectiveId = TEXT("learn_secret");
+        Objective.TriggerType = EObjectiveTriggerType::KnowledgeLearned;
+        Objective.TriggerTarget = Ask.KnowledgeFlagToSet;
+        
+        FQuest Quest;
+        Quest.QuestId = TEXT("check_wait_for_lamplighter");
+        Quest.State = EQuestState::InProgress;
+        Quest.Objectives.Add(Objective);
+        Solver.AddQuest(Quest);
+        
+        const FQuestRouteReport Report = Solver.Solve(Settings);
+        const bool bPassed = Report.Routes.Num() == 1 && Report.Routes[0].bCompletable 
+            && Report.Routes[0].FinishMinute >= TimeOfDayStartHours[2] * 60;
+        if (!bPassed)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Quest Route: Solver check failed, it could not wait for an NPC who only arrives in the evening"));
+            return false;
+        }
+        
+        for (const FString& Step : Report.Routes[0].Steps)
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("Quest Route: Solver check     %s"), *Step);
+        }
+        return true;
+    }
+}
+
+UQuestRouteCommandlet::UQuestRouteCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UQuestRouteCommandlet::Main(const FString& Params)
+{
+    FString DialogueDir = FPaths::ProjectContentDir() / TEXT("Data/Dialogue");
+    FString QuestDir = FPaths::ProjectContentDir() / TEXT("Data/Quests");
+    FString LocationsPath = FPaths::ProjectDir() / TEXT("data/locations.json");
+    FString CharactersPath = FPaths::ProjectDir() / TEXT("data/characters.json");
+    FString ItemsPath;
+    FString StartLocation = TEXT("inn");
+    FString InitialKnowledge;
+    FParse::Value(*Params, TEXT("DialogueDir="), DialogueDir);
+    FParse::Value(*Params, TEXT("QuestDir="), QuestDir);
+    FParse::Value(*Params, TEXT("Locations="), LocationsPath);
+    FParse::Value(*Params, TEXT("Characters="), CharactersPath);
+    FParse::Value(*Params, TEXT("Items="), ItemsPath);
+    FParse::Value(*Params, TEXT("Start="), StartLocation);
+    FParse::Value(*Params, TEXT("Knowledge="), InitialKnowledge);
+    const bool bAllowIncomplete = FParse::Param(*Params, TEXT("AllowIncomplete"));
+    
+    FRouteSolverSettings Settings;
+    FParse::Value(*Params, TEXT("BeamWidth="), Settings.BeamWidth);
+    FParse::Value(*Params, TEXT("Loop="), Settings.LoopCount);
+    Settings.BeamWidth = FMath::Max(1, Settings.BeamWidth);
+    
+    if (!RunScheduleWaitCheck(Settings))
+    {
+        return 3;
+    }
+    
+    FQuestRouteSolver Solver;
+    int32 NumFailed = 0;
+    if (!LoadLocations(LocationsPath, Solver))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Quest Route: Failed to load locations %s"), *LocationsPath);
+        ++NumFailed;
+    }
+    if (!LoadSchedules(CharactersPath, Solver))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Quest Route: Failed to load characters %s"), *CharactersPath);
+        ++NumFailed;
+    }
+    if (!ItemsPath.IsEmpty() && !LoadItemSources(ItemsPath, Solver))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Quest Route: Failed to load item sources %s"), *ItemsPath);
+        ++NumFailed;
+    }
+    
+    TArray<FDialogueTree> DialogueTrees;
+    TArray<FQuest> Quests;
+    NumFailed += ContentLoading::LoadContentDirectory(DialogueDir, DialogueTrees, TEXT("Quest Route"));
+    NumFailed += ContentLoading::LoadContentDirectory(QuestDir, Quests, TEXT("Quest Route"));
+    if (NumFailed > 0)
+    {
+        return 2;
+    }
+    
+    for (const FDialogueTree& Tree : DialogueTrees)
+    {
+        Solver.AddDialogueTree(Tree);
+    }
+    for (const FQuest& Quest : Quests)
+    {
+        Solver.AddQuest(Quest);
+    }
+    
+    TArray<FString> KnowledgeFlags;
+    InitialKnowledge.ParseIntoArray(KnowledgeFlags, TEXT("+"));
+    for (const FString& Flag : KnowledgeFlags)
+    {
+        Solver.AddInitialKnowledge(FName(*Flag));
+    }
+    Solver.SetStartLocation(FName(*StartLocation));
+    
+    const FQuestRouteReport Report = Solver.Solve(Settings);
+    
+    for (const FQuestRoute& Route : Report.Routes)
+    {
+        if (Route.bCompletable)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Quest Route: '%s' completes at %02d:%02d in %d actions (%d states)"), 
+                *Route.QuestId.ToString(), Route.FinishMinute / 60, Route.FinishMinute % 60, Route.Steps.Num(), Route.NumStatesExpanded);
+            for (const FString& Step : Route.Steps)
+            {
+                UE_LOG(LogTemp, Display, TEXT("Quest Route:     %s"), *Step);
+            }
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Quest Route: '%s' cannot be completed in one day (%d states)"), 
+                *Route.QuestId.ToString(), Route.NumStatesExpanded);
+            for (const FString& Step : Route.Steps)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Quest Route:     %s"), *Step);
+            }
+        }
+    }
+    
+    UE_LOG(LogTemp, Display, TEXT("Quest Route: %d quests, %d incomplete, solved in %.3f s"), 
+        Report.Routes.Num(), Report.NumIncomplete, Report.Seconds);
+    
+    return (Report.NumIncomplete > 0 && !bAllowIncomplete) ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "QuestRouteCommandlet.generated.h"
+
+/**
+ * UQuestRouteCommandlet - Searches a simulated loop-day for a route to every quest's completion
+ *
+ * Usage: <Editor>-Cmd <Project> -run=QuestRoute [-DialogueDir=<dir>] [-QuestDir=<dir>]
+ *        [-Locations=<file>] [-Characters=<file>] [-Items=<file>] [-Start=<location>]
+ *        [-Knowledge=flag1+flag2] [-Loop=<n>] [-BeamWidth=<n>] [-AllowIncomplete]
+ *
+ * Locations and character schedules use the data/locations.json and data/characters.json
+ * layout. The optional items file is a JSON array of {location, interaction, item} objects
+ * describing which interactions hand out items. Logs the action sequence found for each
+ * quest and returns non-zero when any quest cannot be completed within one day, so CI
+ * can catch content changes that make a quest unsolvable. Before loading content it
+ * solves a small built-in world that needs a wait for an evening-only NPC, and returns 3
+ * if the solver itself cannot find that route.
+ */
+UCLASS()
+class TIMELOOP_API UQuestRouteCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UQuestRouteCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,930 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include "QuestRouteSolver.h"
+#include "Systems/DialogueSystem/DialogueManager.h"
+#include "Systems/QuestSystem/QuestManager.h"
+#include "Systems/QuestSystem/KnowledgeFlagRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/CityHash.h"
+
+namespace QuestRouteBits
+{
+    inline int32 NumWords(int32 NumBits)
+    {
+        return (NumBits + 63) / 64;
+    }
+
+    inline void Set(TArray<uint64>& Words, int32 Bit)
+    {
+        Words[Bit >> 6] |= (uint64)1 << (Bit & 63);
+    }
+
+    inline bool Test(const TArray<uint64>& Words, int32 Bit)
+    {
+        return (Words[Bit >> 6] & ((uint64)1 << (Bit & 63))) != 0;
+    }
+
+    // A gate of INDEX_NONE is always open
+    inline bool IsOpen(const FKnowledgeBits& Known, int32 Flag)
+    {
+        return Flag == INDEX_NONE || Known.Contains(Flag);
+    }
+
+    inline int32 Count(const TArray<uint64>& Words)
+    {
+        int32 Total = 0;
+        for (uint64 Word : Words)
+        {
+            Total += (int32)FMath::CountBits(Word);
+        }
+        return Total;
+    }
+
+    template <typename ElementType>
+    inline uint64 HashArray(const TArray<ElementType>& Array, uint64 Seed)
+    {
+        return CityHash64WithSeed(reinterpret_cast<const char*>(Array.GetData()), Array.Num() * sizeof(ElementType), Seed);
+    }
+}
+
+namespace QuestRouteTime
+{
+    // Same boundaries as UTimeManager::UpdateTimeOfDay
+    inline int32 GetTimeOfDay(int32 Hour)
+    {
+        Hour %= 24;
+        if (Hour >= 5 && Hour < 10)
+        {
+            return 0;
+        }
+        if (Hour >= 10 && Hour < 17)
+        {
+            return 1;
+        }
+        if (Hour >= 17 && Hour < 21)
+        {
+            return 2;
+        }
+        return 3;
+    }
+
+    inline FString FormatMinute(int32 Minute)
+    {
+        return FString::Printf(TEXT("%02d:%02d"), Minute / 60, Minute % 60);
+    }
+}
+
+uint64 FQuestRouteSolver::FState::GetKey() const
+{
+    uint64 Key = ((uint64)(uint32)Location << 32) ^ ((uint64)(uint32)Tree << 16) ^ (uint64)(uint32)Node;
+    
+    // The hour decides which NPCs are present and which locations are open, so only minutes within it are left out
+    const int32 Hour = Minute / 60;
+    Key = CityHash64WithSeed(reinterpret_cast<const char*>(&Hour), sizeof(Hour), Key);
+    Key = QuestRouteBits::HashArray(Knowledge.Words, Key);
+    Key = QuestRouteBits::HashArray(Items, Key);
+    Key = QuestRouteBits::HashArray(Objectives, Key);
+    return QuestRouteBits::HashArray(QuestStates, Key);
+}
+
+int32 FQuestRouteSolver::FindOrAddIndex(FName Name, TArray<FName>& Names, TMap<FName, int32>& Indices)
+{
+    if (Name == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = Indices.Find(Name))
+    {
+        return *Existing;
+    }
+    
+    const int32 Index = Names.Add(Name);
+    Indices.Add(Name, Index);
+    return Index;
+}
+
+int32 FQuestRouteSolver::FindOrAddLocation(FName LocationId)
+{
+    if (LocationId == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = LocationIndices.Find(LocationId))
+    {
+        return *Existing;
+    }
+    
+    const int32 Index = Locations.AddDefaulted();
+    Locations[Index].LocationId = LocationId;
+    LocationIndices.Add(LocationId, Index);
+    return Index;
+}
+
+int32 FQuestRouteSolver::FindOrAddNPC(FName NPCId)
+{
+    if (NPCId == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = NPCIndices.Find(NPCId))
+    {
+        return *Existing;
+    }
+    
+    const int32 Index = NPCs.AddDefaulted();
+    NPCs[Index].NPCId = NPCId;
+    for (int32 Hour = 0; Hour < 24; ++Hour)
+    {
+        NPCs[Index].LocationByHour[Hour] = INDEX_NONE;
+    }
+    NPCIndices.Add(NPCId, Index);
+    return Index;
+}
+
+int32 FQuestRouteSolver::FindOrAddQuest(FName QuestId)
+{
+    if (QuestId == NAME_None)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* Existing = QuestIndices.Find(QuestId))
+    {
+        return *Existing;
+    }
+    
+    const int32 Index = Quests.AddDefaulted();
+    Quests[Index].QuestId = QuestId;
+    QuestIndices.Add(QuestId, Index);
+    return Index;
+}
+
+void FQuestRouteSolver::AddLocation(FName LocationId, const TArray<FName>& Connections, uint8 TimesOfDayMask)
+{
+    const int32 LocationIndex = FindOrAddLocation(LocationId);
+    if (LocationIndex == INDEX_NONE)
+    {
+        return;
+    }
+    
+    // Resolve connections first; adding locations may reallocate the array
+    TArray<int32> ConnectionIndices;
+    for (const FName& Connection : Connections)
+    {
+        const int32 ConnectionIndex = FindOrAddLocation(Connection);
+        if (ConnectionIndex != INDEX_NONE && ConnectionIndex != LocationIndex)
+        {
+            ConnectionIndices.AddUnique(ConnectionIndex);
+        }
+    }
+    
+    FLocation& Location = Locations[LocationIndex];
+    Location.TimesOfDayMask = TimesOfDayMask;
+    for (int32 ConnectionIndex : ConnectionIndices)
+    {
+        Location.Connections.AddUnique(ConnectionIndex);
+    }
+}
+
+void FQuestRouteSolver::AddScheduleEntry(FName NPCId, int32 StartHour, FName LocationId)
+{
+    const int32 NPCIndex = FindOrAddNPC(NPCId);
+    const int32 LocationIndex = FindOrAddLocation(LocationId);
+    if (NPCIndex == INDEX_NONE || LocationIndex == INDEX_NONE)
+    {
+        return;
+    }
+    
+    FNPC& NPC = NPCs[NPCIndex];
+    NPC.ScheduleEntries.Add(TPair<int32, int32>(FMath::Clamp(StartHour, 0, 23), LocationIndex));
+    NPC.ScheduleEntries.StableSort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+    {
+        return A.Key < B.Key;
+    });
+    
+    // Each hour belongs to the latest entry starting at or before it; hours before the first entry carry over from the night before
+    for (int32 Hour = 0; Hour < 24; ++Hour)
+    {
+        int32 Location = NPC.ScheduleEntries.Last().Value;
+        for (const TPair<int32, int32>& Entry : NPC.ScheduleEntries)
+        {
+            if (Entry.Key > Hour)
+            {
+                break;
+            }
+            Location = Entry.Value;
+        }
+        NPC.LocationByHour[Hour] = Location;
+    }
+}
+
+void FQuestRouteSolver::AddItemSource(FName LocationId, FName InteractionId, FName ItemId)
+{
+    const int32 LocationIndex = FindOrAddLocation(LocationId);
+    const int32 ItemIndex = FindOrAddIndex(ItemId, ItemNames, ItemIndices);
+    if (LocationIndex == INDEX_NONE || ItemIndex == INDEX_NONE)
+    {
+        return;
+    }
+    
+    FItemSource Source;
+    Source.InteractionId = InteractionId;
+    Source.Item = ItemIndex;
+    Locations[LocationIndex].ItemSources.Add(ItemSources.Add(Source));
+}
+
+void FQuestRouteSolver::AddDialogueTree(const FDialogueTree& DialogueTree)
+{
+    FTree Tree;
+    Tree.DialogueId = DialogueTree.DialogueId;
+    Tree.NPC = FindOrAddNPC(DialogueTree.NPCId);
+    Tree.EntryNode = INDEX_NONE;
+    
+    TMap<FName, int32> NodeIndices;
+    for (const TPair<FName, FDialogueNode>& Pair : DialogueTree.Nodes)
+    {
+        NodeIndices.Add(Pair.Key, NodeIndices.Num());
+    }
+    
+    for (const TPair<FName, FDialogueNode>& Pair : DialogueTree.Nodes)
+    {
+        const FDialogueNode& SourceNode = Pair.Value;
+        
+        FNode Node;
+        Node.RequiredFlag = FindOrAddIndex(SourceNode.RequiredKnowledgeFlag, FlagNames, FlagIndices);
+        Node.FlagToSet = FindOrAddIndex(SourceNode.KnowledgeFlagToSet, FlagNames, FlagIndices);
+        Node.QuestToTrigger = SourceNode.bTriggersQuest ? FindOrAddQuest(SourceNode.QuestToTrigger) : INDEX_NONE;
+        Node.FirstChoice = Tree.Choices.Num();
+        Node.NumChoices = SourceNode.Choices.Num();
+        Node.bIsEndNode = SourceNode.bIsEndNode;
+        
+        for (const FDialogueChoice& SourceChoice : SourceNode.Choices)
+        {
+            Tree.ChoiceTexts.Add(SourceChoice.ChoiceText.ToString());
+            
+            FChoice Choice;
+            const int32* NextNode = NodeIndices.Find(SourceChoice.NextNodeId);
+            Choice.NextNode = NextNode ? *NextNode : INDEX_NONE;
+            Choice.RequiredFlag = FindOrAddIndex(SourceChoice.RequiredKnowledgeFlag, FlagNames, FlagIndices);
+            Choice.FlagToSet = FindOrAddIndex(SourceChoice.KnowledgeFlagToSet, FlagNames, FlagIndices);
+            Tree.Choices.Add(Choice);
+        }
+        Tree.Nodes.Add(Node);
+    }
+    
+    if (const int32* EntryNode = NodeIndices.Find(DialogueTree.EntryNodeId))
+    {
+        Tree.EntryNode = *EntryNode;
+    }
+    
+    const int32 TreeIndex = Trees.Add(MoveTemp(Tree));
+    if (Trees[TreeIndex].NPC != INDEX_NONE)
+    {
+        NPCs[Trees[TreeIndex].NPC].Trees.Add(TreeIndex);
+    }
+}
+
+void FQuestRouteSolver::AddQuest(const FQuest& Quest)
+{
+    const int32 QuestIndex = FindOrAddQuest(Quest.QuestId);
+    if (QuestIndex == INDEX_NONE)
+    {
+        return;
+    }
+    
+    // Resolve references first; adding quests may reallocate the array
+    TArray<FPrerequisite> Prerequisites;
+    FKnowledgeBits RequiredKnowledge;
+    for (const FQuestPrerequisite& SourcePrerequisite : Quest.Prerequisites)
+    {
+        // Knowledge prerequisites are checked together as one mask
+        if (SourcePrerequisite.Type == EQuestPrerequisiteType::KnowledgeFlag)
+        {
+            const int32 Flag = FindOrAddIndex(SourcePrerequisite.KnowledgeFlag, FlagNames, FlagIndices);
+            if (Flag != INDEX_NONE)
+            {
+                RequiredKnowledge.Add(Flag);
+            }
+            continue;
+        }
+        
+        FPrerequisite Prerequisite;
+        Prerequisite.Type = (uint8)SourcePrerequisite.Type;
+        Prerequisite.RequiredState = (uint8)SourcePrerequisite.RequiredState;
+        switch (SourcePrerequisite.Type)
+        {
+            case EQuestPrerequisiteType::QuestState:
+                Prerequisite.Target = FindOrAddQuest(SourcePrerequisite.QuestId);
+                break;
+            default:
+                Prerequisite.Target = SourcePrerequisite.MinLoopCount;
+                break;
+        }
+        Prerequisites.Add(Prerequisite);
+    }
+    
+    FRouteQuest& RouteQuest = Quests[QuestIndex];
+    RouteQuest.InitialState = (uint8)Quest.State;
+    RouteQuest.Prerequisites = MoveTemp(Prerequisites);
+    RouteQuest.RequiredKnowledge = MoveTemp(RequiredKnowledge);
+    RouteQuest.bGated = Quest.Prerequisites.Num() > 0;
+    RouteQuest.FirstObjective = Objectives.Num();
+    RouteQuest.NumObjectives = Quest.Objectives.Num();
+    RouteQuest.bDefined = true;
+    
+    for (const FQuestObjective& SourceObjective : Quest.Objectives)
+    {
+        FObjective Objective;
+        Objective.Quest = QuestIndex;
+        Objective.TriggerType = (uint8)SourceObjective.TriggerType;
+        switch (SourceObjective.TriggerType)
+        {
+            case EObjectiveTriggerType::ItemAcquired:
+                Objective.Target = FindOrAddIndex(SourceObjective.TriggerTarget, ItemNames, ItemIndices);
+                break;
+            case EObjectiveTriggerType::NPCInteracted:
+                Objective.Target = FindOrAddNPC(SourceObjective.TriggerTarget);
+                break;
+            case EObjectiveTriggerType::LocationReached:
+                Objective.Target = FindOrAddLocation(SourceObjective.TriggerTarget);
+                break;
+            case EObjectiveTriggerType::KnowledgeLearned:
+                Objective.Target = FindOrAddIndex(SourceObjective.TriggerTarget, FlagNames, FlagIndices);
+                break;
+            case EObjectiveTriggerType::TimeReached:
+                Objective.Target = SourceObjective.TriggerHour;
+                break;
+            default:
+                Objective.Target = INDEX_NONE;
+                break;
+        }
+        
+        const int32 ObjectiveIndex = Objectives.Add(Objective);
+        if (Objective.TriggerType != (uint8)EObjectiveTriggerType::None && Objective.Target != INDEX_NONE)
+        {
+            ObjectiveTriggers.FindOrAdd(MakeTriggerKey(Objective.TriggerType, Objective.Target)).Add(ObjectiveIndex);
+        }
+    }
+}
+
+void FQuestRouteSolver::AddInitialKnowledge(FName FlagName)
+{
+    const int32 Flag = FindOrAddIndex(FlagName, FlagNames, FlagIndices);
+    if (Flag != INDEX_NONE)
+    {
+        InitialFlags.AddUnique(Flag);
+    }
+}
+
+void FQuestRouteSolver::SetStartLocation(FName LocationId)
+{
+    StartLocation = FindOrAddLocation(LocationId);
+}
+
+FQuestRouteSolver::FState FQuestRouteSolver::MakeInitialState(const FRouteSolverSettings& Settings) const
+{
+    FState State;
+    State.Location = (StartLocation == INDEX_NONE && Locations.Num() > 0) ? 0 : StartLocation;
+    State.Minute = Settings.StartHour * 60;
+    State.Knowledge.Words.SetNumZeroed(QuestRouteBits::NumWords(FlagNames.Num()));
+    State.Items.SetNumZeroed(QuestRouteBits::NumWords(ItemNames.Num()));
+    State.Objectives.SetNumZeroed(QuestRouteBits::NumWords(Objectives.Num()));
+    State.QuestStates.SetNumZeroed(Quests.Num());
+    
+    for (int32 Flag : InitialFlags)
+    {
+        State.Knowledge.Add(Flag);
+    }
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        State.QuestStates[QuestIndex] = Quests[QuestIndex].InitialState;
+    }
+    
+    SettleQuests(State, Settings);
+    return State;
+}
+
+void FQuestRouteSolver::GetActions(const FState& State, const FRouteSolverSettings& Settings, TArray<FAction>& OutActions) const
+{
+    OutActions.Reset();
+    
+    // Inside a conversation only its choices, or leaving it, are possible
+    if (State.Tree != INDEX_NONE)
+    {
+        const FTree& Tree = Trees[State.Tree];
+        const FNode& Node = Tree.Nodes[State.Node];
+        for (int32 ChoiceIndex = Node.FirstChoice; ChoiceIndex < Node.FirstChoice + Node.NumChoices; ++ChoiceIndex)
+        {
+            const FChoice& Choice = Tree.Choices[ChoiceIndex];
+            if (QuestRouteBits::IsOpen(State.Knowledge, Choice.RequiredFlag)
+                && (Choice.NextNode == INDEX_NONE || QuestRouteBits::IsOpen(State.Knowledge, Tree.Nodes[Choice.NextNode].RequiredFlag)))
+            {
+                OutActions.Add({EActionType::Choose, ChoiceIndex});
+            }
+        }
+        OutActions.Add({EActionType::Choose, INDEX_NONE});
+        return;
+    }
+    
+    if (State.Location == INDEX_NONE)
+    {
+        return;
+    }
+    
+    const FLocation& Location = Locations[State.Location];
+    const int32 Hour = State.Minute / 60;
+    
+    const int32 ArrivalHour = (State.Minute + Settings.MoveMinutes) / 60;
+    for (int32 Connection : Location.Connections)
+    {
+        const uint8 Mask = Locations[Connection].TimesOfDayMask;
+        if (Mask == 0 || (Mask & (1 << QuestRouteTime::GetTimeOfDay(ArrivalHour))))
+        {
+            OutActions.Add({EActionType::Move, Connection});
+        }
+    }
+    
+    for (const FNPC& NPC : NPCs)
+    {
+        if (NPC.LocationByHour[Hour % 24] != State.Location)
+        {
+            continue;
+        }
+        for (int32 TreeIndex : NPC.Trees)
+        {
+            const FTree& Tree = Trees[TreeIndex];
+            if (Tree.EntryNode != INDEX_NONE && QuestRouteBits::IsOpen(State.Knowledge, Tree.Nodes[Tree.EntryNode].RequiredFlag))
+            {
+                OutActions.Add({EActionType::Talk, TreeIndex});
+            }
+        }
+    }
+    
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        if (Quests[QuestIndex].bDefined && State.QuestStates[QuestIndex] == (uint8)EQuestState::Available)
+        {
+            OutActions.Add({EActionType::AcceptQuest, QuestIndex});
+        }
+    }
+    
+    for (int32 SourceIndex : Location.ItemSources)
+    {
+        if (!QuestRouteBits::Test(State.Items, ItemSources[SourceIndex].Item))
+        {
+            OutActions.Add({EActionType::Interact, SourceIndex});
+        }
+    }
+    
+    if (Hour + 1 <= Settings.EndHour)
+    {
+        OutActions.Add({EActionType::Wait, INDEX_NONE});
+    }
+}
+
+bool FQuestRouteSolver::ApplyAction(const FState& State, const FAction& Action, const FRouteSolverSettings& Settings, FState& OutState) const
+{
+    OutState = State;
+    
+    switch (Action.Type)
+    {
+        case EActionType::Move:
+            OutState.Location = Action.Target;
+            AdvanceClock(OutState, Settings.MoveMinutes);
+            FireEvent(OutState, (uint8)EObjectiveTriggerType::LocationReached, Action.Target);
+            break;
+            
+        case EActionType::Talk:
+        {
+            const FTree& Tree = Trees[Action.Target];
+            AdvanceClock(OutState, Settings.TalkMinutes);
+            FireEvent(OutState, (uint8)EObjectiveTriggerType::NPCInteracted, Tree.NPC);
+            EnterNode(OutState, Action.Target, Tree.EntryNode);
+            break;
+        }
+            
+        case EActionType::Choose:
+        {
+            AdvanceClock(OutState, Settings.TalkMinutes);
+            if (Action.Target == INDEX_NONE)
+            {
+                OutState.Tree = INDEX_NONE;
+                OutState.Node = INDEX_NONE;
+                break;
+            }
+            
+            const FChoice& Choice = Trees[State.Tree].Choices[Action.Target];
+            LearnFlag(OutState, Choice.FlagToSet);
+            if (Choice.NextNode == INDEX_NONE)
+            {
+                OutState.Tree = INDEX_NONE;
+                OutState.Node = INDEX_NONE;
+            }
+            else
+            {
+                EnterNode(OutState, State.Tree, Choice.NextNode);
+            }
+            break;
+        }
+            
+        case EActionType::AcceptQuest:
+            OutState.QuestStates[Action.Target] = (uint8)EQuestState::InProgress;
+            break;
+            
+        case EActionType::Interact:
+        {
+            const int32 Item = ItemSources[Action.Target].Item;
+            AdvanceClock(OutState, Settings.InteractMinutes);
+            QuestRouteBits::Set(OutState.Items, Item);
+            FireEvent(OutState, (uint8)EObjectiveTriggerType::ItemAcquired, Item);
+            break;
+        }
+            
+        case EActionType::Wait:
+            AdvanceClock(OutState, 60 - OutState.Minute % 60);
+            break;
+    }
+    
+    if (OutState.Minute > Settings.EndHour * 60)
+    {
+        return false;
+    }
+    
+    SettleQuests(OutState, Settings);
+    return true;
+}
+
+void FQuestRouteSolver::FireEvent(FState& State, uint8 TriggerType, int32 Target) const
+{
+    const TArray<int32>* Waiting = ObjectiveTriggers.Find(MakeTriggerKey(TriggerType, Target));
+    if (!Waiting)
+    {
+        return;
+    }
+    
+    // Like UQuestManager, objectives only progress while their quest is in progress
+    for (int32 ObjectiveIndex : *Waiting)
+    {
+        if (State.QuestStates[Objectives[ObjectiveIndex].Quest] == (uint8)EQuestState::InProgress)
+        {
+            QuestRouteBits::Set(State.Objectives, ObjectiveIndex);
+        }
+    }
+}
+
+void FQuestRouteSolver::LearnFlag(FState& State, int32 Flag) const
+{
+    if (Flag == INDEX_NONE || !State.Knowledge.Add(Flag))
+    {
+        return;
+    }
+    
+    FireEvent(State, (uint8)EObjectiveTriggerType::KnowledgeLearned, Flag);
+}
+
+void FQuestRouteSolver::AdvanceClock(FState& State, int32 Minutes) const
+{
+    const int32 OldHour = State.Minute / 60;
+    State.Minute += Minutes;
+    for (int32 Hour = OldHour + 1; Hour <= State.Minute / 60; ++Hour)
+    {
+        FireEvent(State, (uint8)EObjectiveTriggerType::TimeReached, Hour % 24);
+    }
+}
+
+void FQuestRouteSolver::EnterNode(FState& State, int32 TreeIndex, int32 NodeIndex) const
+{
+    const FNode& Node = Trees[TreeIndex].Nodes[NodeIndex];
+    State.Tree = TreeIndex;
+    State.Node = NodeIndex;
+    
+    LearnFlag(State, Node.FlagToSet);
+    
+    if (Node.QuestToTrigger != INDEX_NONE && State.QuestStates[Node.QuestToTrigger] == (uint8)EQuestState::Unavailable)
+    {
+        State.QuestStates[Node.QuestToTrigger] = (uint8)EQuestState::Available;
+    }
+    
+    // The conversation closes at end nodes and nodes with nothing to say back
+    if (Node.bIsEndNode || Node.NumChoices == 0)
+    {
+        State.Tree = INDEX_NONE;
+        State.Node = INDEX_NONE;
+    }
+}
+
+void FQuestRouteSolver::SettleQuests(FState& State, const FRouteSolverSettings& Settings) const
+{
+    bool bChanged = true;
+    while (bChanged)
+    {
+        bChanged = false;
+        for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+        {
+            const FRouteQuest& Quest = Quests[QuestIndex];
+            if (!Quest.bDefined)
+            {
+                continue;
+            }
+            
+            uint8& QuestState = State.QuestStates[QuestIndex];
+            if (QuestState == (uint8)EQuestState::Unavailable && Quest.bGated)
+            {
+                bool bAllMet = State.Knowledge.ContainsAll(Quest.RequiredKnowledge);
+                for (int32 PrerequisiteIndex = 0; bAllMet && PrerequisiteIndex < Quest.Prerequisites.Num(); ++PrerequisiteIndex)
+                {
+                    const FPrerequisite& Prerequisite = Quest.Prerequisites[PrerequisiteIndex];
+                    switch ((EQuestPrerequisiteType)Prerequisite.Type)
+                    {
+                        case EQuestPrerequisiteType::QuestState:
+                            bAllMet = Prerequisite.Target != INDEX_NONE && State.QuestStates[Prerequisite.Target] == Prerequisite.RequiredState;
+                            break;
+                        default:
+                            bAllMet = Settings.LoopCount >= Prerequisite.Target;
+                            break;
+                    }
+                }
+                
+                if (bAllMet)
+                {
+                    QuestState = (uint8)EQuestState::Available;
+                    bChanged = true;
+                }
+            }
+            else if (QuestState == (uint8)EQuestState::InProgress && Quest.NumObjectives > 0)
+            {
+                bool bAllComplete = true;
+                for (int32 ObjectiveIndex = Quest.FirstObjective; ObjectiveIndex < Quest.FirstObjective + Quest.NumObjectives; ++ObjectiveIndex)
+                {
+                    if (!QuestRouteBits::Test(State.Objectives, ObjectiveIndex))
+                    {
+                        bAllComplete = false;
+                        break;
+                    }
+                }
+                
+                if (bAllComplete)
+                {
+                    QuestState = (uint8)EQuestState::Completed;
+                    bChanged = true;
+                }
+            }
+        }
+    }
+}
+
+int32 FQuestRouteSolver::ScoreState(const FState& State, int32 GoalQuest) const
+{
+    const FRouteQuest& Goal = Quests[GoalQuest];
+    
+    int32 Score = 0;
+    switch ((EQuestState)State.QuestStates[GoalQuest])
+    {
+        case EQuestState::Available:
+            Score += 2000;
+            break;
+        case EQuestState::InProgress:
+            Score += 4000;
+            break;
+        default:
+            break;
+    }
+    
+    for (int32 ObjectiveIndex = Goal.FirstObjective; ObjectiveIndex < Goal.FirstObjective + Goal.NumObjectives; ++ObjectiveIndex)
+    {
+        if (QuestRouteBits::Test(State.Objectives, ObjectiveIndex))
+        {
+            Score += 1000;
+        }
+    }
+    
+    for (const FPrerequisite& Prerequisite : Goal.Prerequisites)
+    {
+        if (Prerequisite.Type == (uint8)EQuestPrerequisiteType::QuestState && Prerequisite.Target != INDEX_NONE)
+        {
+            Score += 200 * FMath::Min<int32>(State.QuestStates[Prerequisite.Target], Prerequisite.RequiredState);
+        }
+    }
+    Goal.RequiredKnowledge.ForEachSetBit([&State, &Score](int32 Flag)
+    {
+        if (State.Knowledge.Contains(Flag))
+        {
+            Score += 600;
+        }
+    });
+    
+    // Learning anything and gathering items widens what later actions can do
+    Score += 20 * State.Knowledge.CountSetBits();
+    Score += 20 * QuestRouteBits::Count(State.Items);
+    
+    // Prefer states reached sooner
+    return Score - State.Minute;
+}
+
+FQuestRoute FQuestRouteSolver::SolveQuest(int32 GoalQuest, const FRouteSolverSettings& Settings) const
+{
+    const FRouteQuest& Goal = Quests[GoalQuest];
+    
+    FQuestRoute Route;
+    Route.QuestId = Goal.QuestId;
+    
+    // Objectives without a trigger are completed by scripts the solver cannot see
+    for (int32 ObjectiveIndex = Goal.FirstObjective; ObjectiveIndex < Goal.FirstObjective + Goal.NumObjectives; ++ObjectiveIndex)
+    {
+        if (Objectives[ObjectiveIndex].TriggerType == (uint8)EObjectiveTriggerType::None || Objectives[ObjectiveIndex].Target == INDEX_NONE)
+        {
+            Route.Steps.Add(FString::Printf(TEXT("Objective %d has no trigger the solver can simulate"), ObjectiveIndex - Goal.FirstObjective));
+            return Route;
+        }
+    }
+    if (Goal.NumObjectives == 0)
+    {
+        Route.Steps.Add(TEXT("Quest has no objectives to complete"));
+        return Route;
+    }
+    
+    FState Initial = MakeInitialState(Settings);
+    if (Initial.QuestStates[GoalQuest] == (uint8)EQuestState::Completed)
+    {
+        Route.bCompletable = true;
+        Route.FinishMinute = Initial.Minute;
+        return Route;
+    }
+    
+    // Earliest minute each state has been reached at within its hour
+    TMap<uint64, int32> Transpositions;
+    Transpositions.Add(Initial.GetKey(), Initial.Minute);
+    
+    TArray<FTrailEntry> Trail;
+    Trail.Add({INDEX_NONE, {EActionType::Wait, INDEX_NONE}, Initial.Minute, Initial.Tree, Initial.Node});
+    
+    TArray<FState> Frontier;
+    TArray<int32> FrontierTrail;
+    Frontier.Add(MoveTemp(Initial));
+    FrontierTrail.Add(0);
+    
+    TArray<FAction> Actions;
+    TArray<FSearchCandidate> Candidates;
+    
+    for (int32 Depth = 0; Depth < Settings.MaxActions && Frontier.Num() > 0; ++Depth)
+    {
+        Candidates.Reset();
+        
+        for (int32 FrontierIndex = 0; FrontierIndex < Frontier.Num(); ++FrontierIndex)
+        {
+            const FState& State = Frontier[FrontierIndex];
+            GetActions(State, Settings, Actions);
+            
+            for (const FAction& Action : Actions)
+            {
+                FState Child;
+                if (!ApplyAction(State, Action, Settings, Child))
+                {
+                    continue;
+                }
+                ++Route.NumStatesExpanded;
+                
+                const uint64 Key = Child.GetKey();
+                int32& EarliestMinute = Transpositions.FindOrAdd(Key, MAX_int32);
+                if (EarliestMinute <= Child.Minute)
+                {
+                    continue;
+                }
+                EarliestMinute = Child.Minute;
+                
+                if (Child.QuestStates[GoalQuest] == (uint8)EQuestState::Completed)
+                {
+                    // Walk the trail back to the start
+                    TArray<FString> Steps;
+                    Steps.Add(DescribeAction(Action, State.Minute, State.Tree, State.Node));
+                    for (int32 TrailIndex = FrontierTrail[FrontierIndex]; Trail[TrailIndex].Parent != INDEX_NONE; TrailIndex = Trail[TrailIndex].Parent)
+                    {
+                        const FTrailEntry& Entry = Trail[TrailIndex];
+                        const FTrailEntry& From = Trail[Entry.Parent];
+                        Steps.Add(DescribeAction(Entry.Action, From.Minute, From.Tree, From.Node));
+                    }
+                    Algo::Reverse(Steps);
+                    
+                    Route.bCompletable = true;
+                    Route.Steps = MoveTemp(Steps);
+                    Route.FinishMinute = Child.Minute;
+                    return Route;
+                }
+                
+                const int32 Score = ScoreState(Child, GoalQuest);
+                Candidates.Add({MoveTemp(Child), FrontierTrail[FrontierIndex], Action, Score});
+            }
+        }
+        
+        // Keep the best candidates as the next beam
+        Candidates.Sort([](const FSearchCandidate& A, const FSearchCandidate& B)
+        {
+            return A.Score > B.Score;
+        });
+        if (Candidates.Num() > Settings.BeamWidth)
+        {
+            Candidates.SetNum(Settings.BeamWidth, false);
+        }
+        
+        Frontier.Reset();
+        FrontierTrail.Reset();
+        for (FSearchCandidate& Candidate : Candidates)
+        {
+            FrontierTrail.Add(Trail.Add({Candidate.Parent, Candidate.Action, Candidate.State.Minute, Candidate.State.Tree, Candidate.State.Node}));
+            Frontier.Add(MoveTemp(Candidate.State));
+        }
+    }
+    
+    return Route;
+}
+
+FString FQuestRouteSolver::DescribeAction(const FAction& Action, int32 Minute, int32 TreeIndex, int32 NodeIndex) const
+{
+    const FString Time = QuestRouteTime::FormatMinute(Minute);
+    switch (Action.Type)
+    {
+        case EActionType::Move:
+            return FString::Printf(TEXT("%s Walk to %s"), *Time, *Locations[Action.Target].LocationId.ToString());
+        case EActionType::Talk:
+        {
+            const FTree& Tree = Trees[Action.Target];
+            return FString::Printf(TEXT("%s Talk to %s (%s)"), *Time, *NPCs[Tree.NPC].NPCId.ToString(), *Tree.DialogueId.ToString());
+        }
+        case EActionType::Choose:
+        {
+            if (Action.Target == INDEX_NONE)
+            {
+                return FString::Printf(TEXT("%s Leave the conversation"), *Time);
+            }
+            
+            // Choices are stored per tree, so number them from the start of their node
+            const FTree& Tree = Trees[TreeIndex];
+            return FString::Printf(TEXT("%s Pick dialogue choice %d \"%s\""), *Time, 
+                Action.Target - Tree.Nodes[NodeIndex].FirstChoice + 1, *Tree.ChoiceTexts[Action.Target]);
+        }
+        case EActionType::AcceptQuest:
+            return FString::Printf(TEXT("%s Accept quest %s"), *Time, *Quests[Action.Target].QuestId.ToString());
+        case EActionType::Interact:
+        {
+            const FItemSource& Source = ItemSources[Action.Target];
+            return FString::Printf(TEXT("%s Use %s to get %s"), *Time, *Source.InteractionId.ToString(), *ItemNames[Source.Item].ToString());
+        }
+        case EActionType::Wait:
+            return FString::Printf(TEXT("%s Wait for the next hour"), *Time);
+        default:
+            return Time;
+    }
+}
+
+FQuestRouteReport FQuestRouteSolver::Solve(const FRouteSolverSettings& Settings) const
+{
+    const double StartTime = FPlatformTime::Seconds();
+    
+    TArray<int32> GoalQuests;
+    for (int32 QuestIndex = 0; QuestIndex < Quests.Num(); ++QuestIndex)
+    {
+        if (Quests[QuestIndex].bDefined)
+        {
+            GoalQuests.Add(QuestIndex);
+        }
+    }
+    
+    // Each quest's search only reads the solver, so they run independently
+    FQuestRouteReport Report;
+    Report.Routes.SetNum(GoalQuests.Num());
+    ParallelFor(GoalQuests.Num(), [this, &Settings, &GoalQuests, &Report](int32 Index)
+    {
+        Report.Routes[Index] = SolveQuest(GoalQuests[Index], Settings);
+    });
+    
+    for (const FQuestRoute& Route : Report.Routes)
+    {
+        if (!Route.bCompletable)
+        {
+            ++Report.NumIncomplete;
+        }
+    }
+    
+    Report.Seconds = FPlatformTime::Seconds() - StartTime;
+    return Report;
+}
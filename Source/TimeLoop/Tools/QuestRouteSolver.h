@@ -0,0 +1,332 @@
+// Copyright (C) 2025 Time Loop Game Development Team
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Systems/QuestSystem/KnowledgeFlagRegistry.h"
+
+struct FDialogueTree;
+struct FQuest;
+
+/**
+ * FRouteSolverSettings - Tuning for a route search
+ */
+struct FRouteSolverSettings
+{
+    // States kept per search depth
+    int32 BeamWidth = 256;
+
+    // Deepest action sequence searched before giving up
+    int32 MaxActions = 400;
+
+    // The simulated day runs from StartHour to EndHour
+    int32 StartHour = 6;
+    int32 EndHour = 24;
+
+    // Minutes each kind of action takes
+    int32 MoveMinutes = 15;
+    int32 TalkMinutes = 5;
+    int32 InteractMinutes = 15;
+
+    // Loop the day is simulated in, for MinLoopCount prerequisites
+    int32 LoopCount = 1;
+};
+
+/**
+ * FQuestRoute - The shortest route found to one quest's completion
+ */
+struct FQuestRoute
+{
+    FName QuestId;
+
+    bool bCompletable = false;
+
+    // Human-readable actions in order
+    TArray<FString> Steps;
+
+    // Clock time the quest completes, in minutes after midnight
+    int32 FinishMinute = 0;
+
+    // States generated while searching
+    int32 NumStatesExpanded = 0;
+};
+
+/**
+ * FQuestRouteReport - Result of solving every quest
+ */
+struct FQuestRouteReport
+{
+    TArray<FQuestRoute> Routes;
+
+    int32 NumIncomplete = 0;
+
+    double Seconds = 0.0;
+};
+
+/**
+ * FQuestRouteSolver - Searches a simulated loop-day for action sequences that complete quests
+ *
+ * A state is the player's location, clock, open conversation, knowledge, items,
+ * objective progress and quest states; NPC whereabouts follow from the clock and
+ * their schedules. Actions are moves between connected locations, talking to NPCs
+ * present, dialogue choices, accepting quests, location interactions that grant
+ * items, and waiting for the next hour. Each quest is solved by its own beam search,
+ * with quests searched in parallel. A transposition table keyed on the state and the
+ * hour keeps only the earliest arrival at each state within an hour; NPC schedules and
+ * opening times only change on the hour, so a later arrival in the same hour can only
+ * ever do less, while waiting into the next hour is kept as a new state.
+ */
+class TIMELOOP_API FQuestRouteSolver
+{
+public:
+    // Add a location and the locations it connects to; TimesOfDayMask uses bit N for ETimeOfDay N, zero means always open
+    void AddLocation(FName LocationId, const TArray<FName>& Connections, uint8 TimesOfDayMask);
+
+    // Place an NPC at a location from a starting hour until their next entry
+    void AddScheduleEntry(FName NPCId, int32 StartHour, FName LocationId);
+
+    // Let an interaction at a location give the player an item
+    void AddItemSource(FName LocationId, FName InteractionId, FName ItemId);
+
+    // Add a dialogue tree the player can start with its NPC
+    void AddDialogueTree(const FDialogueTree& DialogueTree);
+
+    // Add a quest to solve
+    void AddQuest(const FQuest& Quest);
+
+    // Treat a flag as known when the day starts
+    void AddInitialKnowledge(FName FlagName);
+
+    // Set where the player wakes up
+    void SetStartLocation(FName LocationId);
+
+    // Find a route to every quest's completion
+    FQuestRouteReport Solve(const FRouteSolverSettings& Settings) const;
+
+private:
+    enum class EActionType : uint8
+    {
+        Move,
+        Talk,
+        Choose,
+        AcceptQuest,
+        Interact,
+        Wait
+    };
+
+    struct FAction
+    {
+        EActionType Type;
+        int32 Target;
+    };
+
+    struct FLocation
+    {
+        FName LocationId;
+        TArray<int32> Connections;
+        TArray<int32> ItemSources;
+        uint8 TimesOfDayMask = 0;
+    };
+
+    struct FItemSource
+    {
+        FName InteractionId;
+        int32 Item;
+    };
+
+    struct FNPC
+    {
+        FName NPCId;
+        TArray<int32> Trees;
+
+        // Location index for each hour of the day, INDEX_NONE when away from every known location
+        int32 LocationByHour[24];
+
+        // (StartHour, Location) pairs sorted by hour
+        TArray<TPair<int32, int32>> ScheduleEntries;
+    };
+
+    struct FNode
+    {
+        int32 RequiredFlag;
+        int32 FlagToSet;
+        int32 QuestToTrigger;
+        int32 FirstChoice;
+        int32 NumChoices;
+        bool bIsEndNode;
+    };
+
+    struct FChoice
+    {
+        int32 NextNode;
+        int32 RequiredFlag;
+        int32 FlagToSet;
+    };
+
+    struct FTree
+    {
+        FName DialogueId;
+        int32 NPC;
+        int32 EntryNode;
+        TArray<FNode> Nodes;
+        TArray<FChoice> Choices;
+
+        // Text of each choice, parallel to Choices and only read for reports
+        TArray<FString> ChoiceTexts;
+    };
+
+    struct FPrerequisite
+    {
+        uint8 Type;
+        int32 Target;
+        uint8 RequiredState;
+    };
+
+    struct FRouteQuest
+    {
+        FName QuestId;
+        uint8 InitialState = 0;
+
+        // Quest state and loop count prerequisites
+        TArray<FPrerequisite> Prerequisites;
+
+        // Knowledge prerequisites as one mask over solver flag indices
+        FKnowledgeBits RequiredKnowledge;
+
+        // Whether the quest had any prerequisites and waits on them
+        bool bGated = false;
+
+        // Range of this quest's objectives in Objectives
+        int32 FirstObjective = 0;
+        int32 NumObjectives = 0;
+
+        // False for quests only referenced by other content
+        bool bDefined = false;
+    };
+
+    struct FObjective
+    {
+        int32 Quest;
+        uint8 TriggerType;
+        int32 Target;
+    };
+
+    /** One point in the simulated day */
+    struct FState
+    {
+        int32 Location = INDEX_NONE;
+        int32 Minute = 0;
+        int32 Tree = INDEX_NONE;
+        int32 Node = INDEX_NONE;
+        FKnowledgeBits Knowledge;
+        TArray<uint64> Items;
+        TArray<uint64> Objectives;
+        TArray<uint8> QuestStates;
+
+        // Hash of everything but the minutes past the hour
+        uint64 GetKey() const;
+    };
+
+    /** A state generated at the current depth, waiting to be ranked into the beam */
+    struct FSearchCandidate
+    {
+        FState State;
+        int32 Parent;
+        FAction Action;
+        int32 Score;
+    };
+
+    /** How a kept state was reached, for rebuilding the route */
+    struct FTrailEntry
+    {
+        int32 Parent;
+        FAction Action;
+
+        // Clock and open conversation of the state reached
+        int32 Minute;
+        int32 Tree;
+        int32 Node;
+    };
+
+    int32 FindOrAddIndex(FName Name, TArray<FName>& Names, TMap<FName, int32>& Indices);
+    int32 FindOrAddLocation(FName LocationId);
+    int32 FindOrAddNPC(FName NPCId);
+    int32 FindOrAddQuest(FName QuestId);
+
+    // Key of the objective trigger index
+    static uint64 MakeTriggerKey(uint8 TriggerType, int32 Target)
+    {
+        return (static_cast<uint64>(TriggerType) << 32) | static_cast<uint32>(Target);
+    }
+
+    // Build the day's starting state
+    FState MakeInitialState(const FRouteSolverSettings& Settings) const;
+
+    // List the actions available in a state
+    void GetActions(const FState& State, const FRouteSolverSettings& Settings, TArray<FAction>& OutActions) const;
+
+    // Apply an action to a copy of a state; false if it cannot be taken
+    bool ApplyAction(const FState& State, const FAction& Action, const FRouteSolverSettings& Settings, FState& OutState) const;
+
+    // Fire objective triggers for an event
+    void FireEvent(FState& State, uint8 TriggerType, int32 Target) const;
+
+    // Learn a flag, firing its knowledge trigger
+    void LearnFlag(FState& State, int32 Flag) const;
+
+    // Advance the clock, firing time triggers for every hour passed
+    void AdvanceClock(FState& State, int32 Minutes) const;
+
+    // Enter a dialogue node and apply its effects
+    void EnterNode(FState& State, int32 TreeIndex, int32 NodeIndex) const;
+
+    // Re-gate quests against their prerequisites and complete finished ones until nothing changes
+    void SettleQuests(FState& State, const FRouteSolverSettings& Settings) const;
+
+    // Rank a state by how close it is to completing a quest
+    int32 ScoreState(const FState& State, int32 GoalQuest) const;
+
+    // Beam search for one quest
+    FQuestRoute SolveQuest(int32 GoalQuest, const FRouteSolverSettings& Settings) const;
+
+    // Describe an action taken at a given minute, inside the given conversation, for the report
+    FString DescribeAction(const FAction& Action, int32 Minute, int32 TreeIndex, int32 NodeIndex) const;
+
+    TArray<FLocation> Locations;
+    TMap<FName, int32> LocationIndices;
+
+    TArray<FNPC> NPCs;
+    TMap<FName, int32> NPCIndices;
+
+    TArray<FItemSource> ItemSources;
+    TArray<FName> ItemNames;
+    TMap<FName, int32> ItemIndices;
+
+    TArray<FName> FlagNames;
+    TMap<FName, int32> FlagIndices;
+    TArray<int32> InitialFlags;
+
+    TArray<FTree> Trees;
+    TArray<FRouteQuest> Quests;
+    TMap<FName, int32> QuestIndices;
+    TArray<FObjective> Objectives;
+
+    // Objectives waiting on each trigger
+    TMap<uint64, TArray<int32>> ObjectiveTriggers;
+
+    int32 StartLocation = INDEX_NONE;
+};
@@ -0,0 +1,75 @@
+// Copyright (C) 2025 Squeezle Canada
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "DialogueOptionWidget.h"
+#include "Components/TextBlock.h"
+#include "Components/Button.h"
+
+UDialogueOptionWidget::UDialogueOptionWidget(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, ParentDialogueWidget(nullptr)
+	, bIsShown(true)
+{
+}
+
+void UDialogueOptionWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+	
+	// Bind the click once; pooled options are reused without rebinding
+	if (OptionButton)
+	{
+		OptionButton->OnClicked.AddDynamic(this, &UDialogueOptionWidget::OnOptionButtonClicked);
+	}
+}
+
+void UDialogueOptionWidget::SetDialogueOption(const FDialogueOption& InOption)
+{
+	// Only push text to Slate when it actually changed
+	const bool bTextChanged = !Option.OptionText.IdenticalTo(InOption.OptionText)
+		&& !Option.OptionText.ToString().Equals(InOption.OptionText.ToString(), ESearchCase::CaseSensitive);
+	
+	Option = InOption;
+	
+	if (bTextChanged && OptionText)
+	{
+		OptionText->SetText(Option.OptionText);
+	}
+}
+
+void UDialogueOptionWidget::SetOptionShown(bool bShown)
+{
+	if (bIsShown == bShown)
+	{
+		return;
+	}
+	
+	bIsShown = bShown;
+	SetVisibility(bShown ? ESlateVisibility::Visible : ESlateVisibility::Collapsed);
+}
+
+void UDialogueOptionWidget::SetParentDialogueWidget(UDialogueWidget* InParentWidget)
+{
+	ParentDialogueWidget = InParentWidget;
+}
+
+void UDialogueOptionWidget::OnOptionButtonClicked()
+{
+	if (ParentDialogueWidget && bIsShown)
+	{
+		ParentDialogueWidget->OnDialogueOptionClicked(Option.OptionID);
+	}
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2025 Squeezle Canada
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UI/Widgets/TimeLoopBaseWidget.h"
+#include "UI/Widgets/DialogueWidget.h"
+#include "DialogueOptionWidget.generated.h"
+
+/**
+ * Widget for displaying a single dialogue option
+ * Instances are pooled by the dialogue widget and reused between nodes
+ */
+UCLASS()
+class TIMELOOP_API UDialogueOptionWidget : public UTimeLoopBaseWidget
+{
+	GENERATED_BODY()
+	
+public:
+	UDialogueOptionWidget(const FObjectInitializer& ObjectInitializer);
+	
+	// Set the option to display, only touching the parts that changed
+	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
+	void SetDialogueOption(const FDialogueOption& InOption);
+	
+	// Show or hide this option, only touching the visibility if it changed
+	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
+	void SetOptionShown(bool bShown);
+	
+	// Set the parent dialogue widget
+	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
+	void SetParentDialogueWidget(UDialogueWidget* InParentWidget);
+	
+	// Get the dialogue option
+	UFUNCTION(BlueprintPure, Category = "UI|Dialogue")
+	const FDialogueOption& GetDialogueOption() const { return Option; }
+	
+	// Check if this option is currently shown
+	UFUNCTION(BlueprintPure, Category = "UI|Dialogue")
+	bool IsOptionShown() const { return bIsShown; }
+	
+protected:
+	// The dialogue option to display
+	UPROPERTY(BlueprintReadOnly, Category = "UI|Dialogue")
+	FDialogueOption Option;
+	
+	// The parent dialogue widget
+	UPROPERTY()
+	UDialogueWidget* ParentDialogueWidget;
+	
+	// The option text
+	UPROPERTY(meta = (BindWidget))
+	class UTextBlock* OptionText;
+	
+	// The button for choosing the option
+	UPROPERTY(meta = (BindWidget))
+	class UButton* OptionButton;
+	
+	// Whether the option is currently shown
+	bool bIsShown;
+	
+	// Called once when the widget is created
+	virtual void NativeOnInitialized() override;
+	
+	// Called when the option button is clicked
+	UFUNCTION()
+	void OnOptionButtonClicked();
+};
@@ -14,14 +14,16 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "DialogueWidget.h"
+#include "DialogueOptionWidget.h"
 #include "Components/TextBlock.h"
 #include "Components/VerticalBox.h"
 #include "Components/Button.h"
 
 UDialogueWidget::UDialogueWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, InitialOptionPoolSize(4)
 {
-	static ConstructorHelpers::FClassFinder<UUserWidget> DefaultDialogueOptionWidgetClass(TEXT("/Game/UI/Widgets/WBP_DialogueOption"));
+	static ConstructorHelpers::FClassFinder<UDialogueOptionWidget> DefaultDialogueOptionWidgetClass(TEXT("/Game/UI/Widgets/WBP_DialogueOption"));
 	if (DefaultDialogueOptionWidgetClass.Succeeded())
 	{
 		DialogueOptionWidgetClass = DefaultDialogueOptionWidgetClass.Class;
@@ -42,6 +44,9 @@ void UDialogueWidget::NativeConstruct()
 	{
 		CloseButton->OnClicked.AddDynamic(this, &UDialogueWidget::OnCloseButtonClicked);
 	}
+	
+	// Warm the option pool so the first node doesn't create widgets mid-conversation
+	EnsureOptionPoolSize(InitialOptionPoolSize);
 }
 
 void UDialogueWidget::SetSpeakerName(const FText& SpeakerName)
@@ -62,48 +67,62 @@ void UDialogueWidget::SetDialogueText(const FText& DialogueText)
 
 void UDialogueWidget::SetDialogueOptions(const TArray<FDialogueOption>& Options)
 {
-	ClearDialogueOptions();
+	EnsureOptionPoolSize(FMath::Max(Options.Num(), InitialOptionPoolSize));
 	
-	if (!DialogueOptionsContainer || !DialogueOptionWidgetClass)
+	// Reuse the pooled widgets; each one only touches what changed
+	for (int32 Index = 0; Index < OptionWidgetPool.Num(); ++Index)
 	{
-		return;
+		UDialogueOptionWidget* OptionWidget = OptionWidgetPool[Index];
+		if (!OptionWidget)
+		{
+			continue;
+		}
+		
+		if (Options.IsValidIndex(Index))
+		{
+			OptionWidget->SetDialogueOption(Options[Index]);
+			OptionWidget->SetOptionShown(true);
+		}
+		else
+		{
+			OptionWidget->SetOptionShown(false);
+		}
 	}
-	
-	for (const FDialogueOption& Option : Options)
+}
+
+void UDialogueWidget::ClearDialogueOptions()
+{
+	// Keep the widgets around for the next node
+	for (UDialogueOptionWidget* OptionWidget : OptionWidgetPool)
 	{
-		UUserWidget* OptionWidget = CreateWidget<UUserWidget>(GetOwningPlayer(), DialogueOptionWidgetClass);
 		if (OptionWidget)
 		{
-			// Find the text block and button in the option widget
-			UTextBlock* OptionText = Cast<UTextBlock>(OptionWidget->GetWidgetFromName(TEXT("OptionText")));
-			UButton* OptionButton = Cast<UButton>(OptionWidget->GetWidgetFromName(TEXT("OptionButton")));
-			
-			if (OptionText)
-			{
-				OptionText->SetText(Option.OptionText);
-			}
-			
-			if (OptionButton)
-			{
-				// Store the option ID with the button
-				OptionButton->SetVisibility(ESlateVisibility::Visible);
-				
-				// Bind the click event
-				FScriptDelegate ButtonDelegate;
-				ButtonDelegate.BindUFunction(this, FName("OnDialogueOptionClicked"), Option.OptionID);
-				OptionButton->OnClicked.Add(ButtonDelegate);
-			}
-			
-			DialogueOptionsContainer->AddChild(OptionWidget);
+			OptionWidget->SetOptionShown(false);
 		}
 	}
 }
 
-void UDialogueWidget::ClearDialogueOptions()
+void UDialogueWidget::EnsureOptionPoolSize(int32 Count)
 {
-	if (DialogueOptionsContainer)
+	if (!DialogueOptionsContainer || !DialogueOptionWidgetClass)
 	{
-		DialogueOptionsContainer->ClearChildren();
+		return;
+	}
+	
+	// The pool only grows, so a node with many choices pays for its widgets once
+	while (OptionWidgetPool.Num() < Count)
+	{
+		UDialogueOptionWidget* OptionWidget = CreateWidget<UDialogueOptionWidget>(GetOwningPlayer(), DialogueOptionWidgetClass);
+		if (!OptionWidget)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("DialogueWidget: Failed to create dialogue option widget"));
+			return;
+		}
+		
+		OptionWidget->SetParentDialogueWidget(this);
+		OptionWidget->SetOptionShown(false);
+		DialogueOptionsContainer->AddChild(OptionWidget);
+		OptionWidgetPool.Add(OptionWidget);
 	}
 }
 
@@ -19,6 +19,8 @@
 #include "UI/Widgets/TimeLoopBaseWidget.h"
 #include "DialogueWidget.generated.h"
 
+class UDialogueOptionWidget;
+
 /**
  * Dialogue option structure
  */
@@ -71,11 +73,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
 	void SetDialogueText(const FText& DialogueText);
 	
-	// Set the available dialogue options
+	// Set the available dialogue options, reusing pooled option widgets
 	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
 	void SetDialogueOptions(const TArray<FDialogueOption>& Options);
 	
-	// Clear all dialogue options
+	// Hide all dialogue options
 	UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
 	void ClearDialogueOptions();
 	
@@ -92,6 +94,10 @@ public:
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnDialogueClosedDelegate);
 	UPROPERTY(BlueprintAssignable, Category = "UI|Dialogue")
 	FOnDialogueClosedDelegate OnDialogueClosed;
+	
+	// Called when a dialogue option is clicked
+	UFUNCTION()
+	void OnDialogueOptionClicked(FName OptionID);
 
 protected:
 	// The speaker name text
@@ -112,16 +118,23 @@ protected:
 	
 	// The class to use for dialogue option buttons
 	UPROPERTY(EditDefaultsOnly, Category = "UI|Dialogue")
-	TSubclassOf<class UUserWidget> DialogueOptionWidgetClass;
+	TSubclassOf<UDialogueOptionWidget> DialogueOptionWidgetClass;
+	
+	// Number of option widgets created up front
+	UPROPERTY(EditDefaultsOnly, Category = "UI|Dialogue", meta = (ClampMin = "1"))
+	int32 InitialOptionPoolSize;
+	
+	// Option widgets owned by this dialogue, reused for every node
+	UPROPERTY()
+	TArray<UDialogueOptionWidget*> OptionWidgetPool;
+	
+	// Create option widgets until the pool holds at least Count entries
+	void EnsureOptionPoolSize(int32 Count);
 	
 	// Called when the close button is clicked
 	UFUNCTION()
 	void OnCloseButtonClicked();
 	
-	// Called when a dialogue option is clicked
-	UFUNCTION()
-	void OnDialogueOptionClicked(FName OptionID);
-	
 	// Called when the widget is constructed
 	virtual void NativeConstruct() override;
 };
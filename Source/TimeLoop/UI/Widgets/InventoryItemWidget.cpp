@@ -15,12 +15,15 @@
 
 #include "InventoryItemWidget.h"
 #include "InventoryWidget.h"
+#include "Systems/ItemSystem/ItemIconCache.h"
 #include "Components/Image.h"
 #include "Components/TextBlock.h"
 #include "Components/Button.h"
 
 UInventoryItemWidget::UInventoryItemWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, ParentInventoryWidget(nullptr)
+	, bIsShown(true)
 {
 }
 
@@ -29,30 +32,40 @@ void UInventoryItemWidget::InitializeWidget()
 	Super::InitializeWidget();
 }
 
-void UInventoryItemWidget::NativeConstruct()
+void UInventoryItemWidget::NativeOnInitialized()
 {
-	Super::NativeConstruct();
+	Super::NativeOnInitialized();
 	
-	// Bind button click event
+	// Bind the click once; pooled items are reused without rebinding
 	if (ItemButton)
 	{
 		ItemButton->OnClicked.AddDynamic(this, &UInventoryItemWidget::OnItemButtonClicked);
 	}
+	
+	// Icons are drawn with the designed size and tint, so keep the brush before anything replaces it
+	if (ItemImage)
+	{
+		ItemImageBrush = ItemImage->GetBrush();
+	}
 }
 
 void UInventoryItemWidget::SetInventoryItem(const FInventoryItem& InItem)
 {
+	const bool bItemChanged = Item.DefinitionIndex != InItem.DefinitionIndex;
+	const bool bCountChanged = bItemChanged || Item.StackCount != InItem.StackCount;
+	
 	Item = InItem;
+	const FItemDefinition* Definition = Item.GetDefinition();
 	
-	// Update the UI
-	if (ItemImage)
+	// Update the UI; the placeholder stands in until the icon has streamed in
+	if (bItemChanged && ItemImage)
 	{
-		ItemImage->SetBrushFromTexture(Item.Icon);
+		FItemIconCache::Get().SetImageIcon(ItemImage, Item.DefinitionIndex, ItemImageBrush, PlaceholderIconBrush);
 	}
 	
-	if (CountText)
+	if (bCountChanged && CountText)
 	{
-		if (Item.bIsStackable && Item.StackCount > 1)
+		if (Definition && Definition->bIsStackable && Item.StackCount > 1)
 		{
 			CountText->SetText(FText::AsNumber(Item.StackCount));
 			CountText->SetVisibility(ESlateVisibility::Visible);
@@ -64,6 +77,17 @@ void UInventoryItemWidget::SetInventoryItem(const FInventoryItem& InItem)
 	}
 }
 
+void UInventoryItemWidget::SetItemShown(bool bShown)
+{
+	if (bIsShown == bShown)
+	{
+		return;
+	}
+	
+	bIsShown = bShown;
+	SetVisibility(bShown ? ESlateVisibility::Visible : ESlateVisibility::Collapsed);
+}
+
 void UInventoryItemWidget::SetParentInventoryWidget(UInventoryWidget* InParentWidget)
 {
 	ParentInventoryWidget = InParentWidget;
@@ -71,7 +95,7 @@ void UInventoryItemWidget::SetParentInventoryWidget(UInventoryWidget* InParentWi
 
 void UInventoryItemWidget::OnItemButtonClicked()
 {
-	if (ParentInventoryWidget)
+	if (ParentInventoryWidget && bIsShown)
 	{
 		ParentInventoryWidget->OnItemSelected(Item);
 	}
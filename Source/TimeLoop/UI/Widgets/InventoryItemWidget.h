@@ -36,10 +36,18 @@ public:
 	// Initialize the widget with any required dependencies
 	virtual void InitializeWidget() override;
 	
-	// Set the inventory item to display
+	// Set the inventory item to display, only touching the parts that changed
 	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
 	void SetInventoryItem(const FInventoryItem& InItem);
 	
+	// Show or hide this item, only touching the visibility if it changed
+	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
+	void SetItemShown(bool bShown);
+	
+	// Check if this item is currently shown
+	UFUNCTION(BlueprintPure, Category = "UI|Inventory")
+	bool IsItemShown() const { return bIsShown; }
+	
 	// Set the parent inventory widget
 	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
 	void SetParentInventoryWidget(UInventoryWidget* InParentWidget);
@@ -61,6 +69,13 @@ protected:
 	UPROPERTY(meta = (BindWidget))
 	class UImage* ItemImage;
 	
+	// Shown in the item image while the icon streams in
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI|Inventory")
+	FSlateBrush PlaceholderIconBrush;
+	
+	// The item image's brush as designed, before any icon or placeholder replaced it
+	FSlateBrush ItemImageBrush;
+	
 	// The item count text (for stacked items)
 	UPROPERTY(meta = (BindWidget))
 	class UTextBlock* CountText;
@@ -69,8 +84,11 @@ protected:
 	UPROPERTY(meta = (BindWidget))
 	class UButton* ItemButton;
 	
-	// Called when the widget is constructed
-	virtual void NativeConstruct() override;
+	// Whether the item is currently shown
+	bool bIsShown;
+	
+	// Called once when the widget is created
+	virtual void NativeOnInitialized() override;
 	
 	// Called when the item button is clicked
 	UFUNCTION()
@@ -16,6 +16,7 @@
 #include "InventoryWidget.h"
 #include "InventoryItemWidget.h"
 #include "Components/InventoryComponent.h"
+#include "Systems/ItemSystem/ItemIconCache.h"
 #include "Components/WrapBox.h"
 #include "Components/VerticalBox.h"
 #include "Components/TextBlock.h"
@@ -24,6 +25,7 @@
 
 UInventoryWidget::UInventoryWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, SelectedSlot(INDEX_NONE)
 {
 	// Default inventory item widget class
 	static ConstructorHelpers::FClassFinder<UInventoryItemWidget> DefaultInventoryItemWidgetClass(TEXT("/Game/UI/Widgets/WBP_InventoryItem"));
@@ -38,12 +40,17 @@ void UInventoryWidget::InitializeWidget()
 	Super::InitializeWidget();
 	
 	// Hide the selected item panel initially
-	if (SelectedItemPanel)
+	if (SelectedItemPanel && SelectedSlot == INDEX_NONE)
 	{
 		SelectedItemPanel->SetVisibility(ESlateVisibility::Hidden);
 	}
+}
+
+void UInventoryWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
 	
-	// Bind button click events
+	// Bind button click events once; the widget is reused every time the inventory opens
 	if (UseButton)
 	{
 		UseButton->OnClicked.AddDynamic(this, &UInventoryWidget::OnUseButtonClicked);
@@ -53,6 +60,12 @@ void UInventoryWidget::InitializeWidget()
 	{
 		DropButton->OnClicked.AddDynamic(this, &UInventoryWidget::OnDropButtonClicked);
 	}
+	
+	// Icons are drawn with the designed size and tint, so keep the brush before anything replaces it
+	if (SelectedItemImage)
+	{
+		SelectedItemImageBrush = SelectedItemImage->GetBrush();
+	}
 }
 
 void UInventoryWidget::NativeConstruct()
@@ -63,17 +76,18 @@ void UInventoryWidget::NativeConstruct()
 void UInventoryWidget::SetInventoryComponent(UInventoryComponent* InInventoryComponent)
 {
 	// Unbind from any existing inventory component
-	if (InventoryComponent && InventoryComponent->OnInventoryChanged.IsAlreadyBound(this, &UInventoryWidget::OnInventoryChanged))
+	if (InventoryComponent)
 	{
-		InventoryComponent->OnInventoryChanged.RemoveDynamic(this, &UInventoryWidget::OnInventoryChanged);
+		InventoryComponent->OnInventoryChangeSet.RemoveDynamic(this, &UInventoryWidget::OnInventoryChangeSet);
 	}
 	
 	InventoryComponent = InInventoryComponent;
+	SelectedSlot = INDEX_NONE;
 	
 	// Bind to the new inventory component
 	if (InventoryComponent)
 	{
-		InventoryComponent->OnInventoryChanged.AddDynamic(this, &UInventoryWidget::OnInventoryChanged);
+		InventoryComponent->OnInventoryChangeSet.AddDynamic(this, &UInventoryWidget::OnInventoryChangeSet);
 	}
 	
 	// Update the display
@@ -87,54 +101,138 @@ void UInventoryWidget::RefreshInventory()
 		return;
 	}
 	
-	// Clear the inventory grid
-	InventoryGrid->ClearChildren();
+	EnsureItemPoolSize(InventoryComponent->GetSlotCount());
 	
-	// Get all items from the inventory component
-	TArray<FInventoryItem> InventoryItems = InventoryComponent->GetAllItems();
+	for (int32 SlotIndex = 0; SlotIndex < ItemWidgetPool.Num(); ++SlotIndex)
+	{
+		RefreshSlot(SlotIndex);
+	}
+}
+
+UInventoryItemWidget* UInventoryWidget::GetItemWidgetForSlot(int32 SlotIndex) const
+{
+	return ItemWidgetPool.IsValidIndex(SlotIndex) ? ItemWidgetPool[SlotIndex] : nullptr;
+}
+
+void UInventoryWidget::EnsureItemPoolSize(int32 Count)
+{
+	if (!InventoryGrid || !InventoryItemWidgetClass)
+	{
+		return;
+	}
 	
-	// Create widgets for each item
-	for (const FInventoryItem& Item : InventoryItems)
+	// Widgets are added in slot order, so an item keeps its place in the grid while it is held
+	while (ItemWidgetPool.Num() < Count)
 	{
-		if (InventoryItemWidgetClass)
+		UInventoryItemWidget* ItemWidget = CreateWidget<UInventoryItemWidget>(GetOwningPlayer(), InventoryItemWidgetClass);
+		if (!ItemWidget)
 		{
-			UInventoryItemWidget* ItemWidget = CreateWidget<UInventoryItemWidget>(GetOwningPlayer(), InventoryItemWidgetClass);
-			if (ItemWidget)
+			UE_LOG(LogTemp, Warning, TEXT("InventoryWidget: Failed to create inventory item widget"));
+			return;
+		}
+		
+		ItemWidget->SetParentInventoryWidget(this);
+		ItemWidget->SetItemShown(false);
+		InventoryGrid->AddChild(ItemWidget);
+		ItemWidgetPool.Add(ItemWidget);
+	}
+}
+
+void UInventoryWidget::RefreshSlot(int32 SlotIndex)
+{
+	UInventoryItemWidget* ItemWidget = GetItemWidgetForSlot(SlotIndex);
+	if (!ItemWidget || !InventoryComponent)
+	{
+		return;
+	}
+	
+	const FInventoryItem Item = InventoryComponent->GetItemInSlot(SlotIndex);
+	if (Item.IsEmpty())
+	{
+		ItemWidget->SetItemShown(false);
+	}
+	else
+	{
+		ItemWidget->SetInventoryItem(Item);
+		ItemWidget->SetItemShown(true);
+	}
+	
+	// Keep the details panel in step with the selected slot
+	if (SlotIndex == SelectedSlot)
+	{
+		if (Item.IsEmpty())
+		{
+			SelectedSlot = INDEX_NONE;
+			SelectedItem = FInventoryItem();
+			if (SelectedItemPanel)
 			{
-				ItemWidget->SetInventoryItem(Item);
-				ItemWidget->SetParentInventoryWidget(this);
-				InventoryGrid->AddChild(ItemWidget);
+				SelectedItemPanel->SetVisibility(ESlateVisibility::Hidden);
 			}
 		}
+		else if (Item.DefinitionIndex != SelectedItem.DefinitionIndex)
+		{
+			SelectedItem = Item;
+			UpdateSelectedItemPanel();
+		}
+		else
+		{
+			SelectedItem = Item;
+		}
 	}
 }
 
-void UInventoryWidget::OnInventoryChanged()
+void UInventoryWidget::OnInventoryChangeSet(const FInventoryChangeSet& ChangeSet)
 {
-	RefreshInventory();
+	if (!InventoryComponent)
+	{
+		return;
+	}
+	
+	// Slots only grow; new ones get widgets before anything is shown in them
+	if (ItemWidgetPool.Num() < InventoryComponent->GetSlotCount())
+	{
+		EnsureItemPoolSize(InventoryComponent->GetSlotCount());
+	}
+	
+	for (const int32 SlotIndex : ChangeSet.RemovedSlots)
+	{
+		RefreshSlot(SlotIndex);
+	}
+	for (const int32 SlotIndex : ChangeSet.AddedSlots)
+	{
+		RefreshSlot(SlotIndex);
+	}
+	for (const int32 SlotIndex : ChangeSet.ChangedSlots)
+	{
+		RefreshSlot(SlotIndex);
+	}
 }
 
 void UInventoryWidget::OnItemSelected(const FInventoryItem& Item)
 {
 	SelectedItem = Item;
+	SelectedSlot = InventoryComponent ? InventoryComponent->FindSlot(Item.GetItemID()) : INDEX_NONE;
 	UpdateSelectedItemPanel();
+	
+	if (InventoryComponent && Item.HasFlag(EInventoryItemFlags::New))
+	{
+		InventoryComponent->MarkItemSeen(Item.GetItemID());
+	}
 }
 
 void UInventoryWidget::OnItemUsed(const FInventoryItem& Item)
 {
 	// This would typically call back to a gameplay system to use the item
 	// For now, just log a message
-	UE_LOG(LogTemp, Display, TEXT("Item used: %s"), *Item.DisplayName.ToString());
-	
-	// Refresh the inventory display
-	RefreshInventory();
+	const FItemDefinition* Definition = Item.GetDefinition();
+	UE_LOG(LogTemp, Display, TEXT("Item used: %s"), Definition ? *Definition->DisplayName.ToString() : TEXT("None"));
 }
 
 void UInventoryWidget::OnItemDropped(const FInventoryItem& Item)
 {
 	if (InventoryComponent)
 	{
-		InventoryComponent->RemoveItem(Item.ItemID);
+		InventoryComponent->RemoveItem(Item.GetItemID());
 	}
 	
 	// Hide the selected item panel
@@ -156,7 +254,8 @@ void UInventoryWidget::OnDropButtonClicked()
 
 void UInventoryWidget::UpdateSelectedItemPanel()
 {
-	if (!SelectedItemPanel || SelectedItem.ItemID == NAME_None)
+	const FItemDefinition* Definition = SelectedItem.GetDefinition();
+	if (!SelectedItemPanel || !Definition)
 	{
 		return;
 	}
@@ -167,16 +266,16 @@ void UInventoryWidget::UpdateSelectedItemPanel()
 	// Update the item details
 	if (SelectedItemName)
 	{
-		SelectedItemName->SetText(SelectedItem.DisplayName);
+		SelectedItemName->SetText(Definition->DisplayName);
 	}
 	
 	if (SelectedItemDescription)
 	{
-		SelectedItemDescription->SetText(SelectedItem.Description);
+		SelectedItemDescription->SetText(Definition->Description);
 	}
 	
 	if (SelectedItemImage)
 	{
-		SelectedItemImage->SetBrushFromTexture(SelectedItem.Icon);
+		FItemIconCache::Get().SetImageIcon(SelectedItemImage, SelectedItem.DefinitionIndex, SelectedItemImageBrush, PlaceholderIconBrush);
 	}
 }
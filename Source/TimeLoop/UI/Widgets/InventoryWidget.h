@@ -25,6 +25,9 @@ class UInventoryItemWidget;
 /**
  * Inventory widget for the TimeLoop game
  * Displays the player's inventory items
+ * Keeps one pooled item widget per inventory slot, in slot order, and applies the
+ * inventory's change sets to just the slots they name. The pool lives as long as the
+ * widget, so closing and reopening the inventory creates nothing.
  */
 UCLASS()
 class TIMELOOP_API UInventoryWidget : public UTimeLoopBaseWidget
@@ -41,10 +44,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
 	void SetInventoryComponent(UInventoryComponent* InInventoryComponent);
 	
-	// Refresh the inventory display
+	// Refresh every slot of the inventory display
 	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
 	void RefreshInventory();
 	
+	// Get the item widget showing a slot
+	UFUNCTION(BlueprintPure, Category = "UI|Inventory")
+	UInventoryItemWidget* GetItemWidgetForSlot(int32 SlotIndex) const;
+	
 	// Called when an item is selected
 	UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
 	void OnItemSelected(const FInventoryItem& Item);
@@ -82,6 +89,13 @@ protected:
 	UPROPERTY(meta = (BindWidget))
 	class UImage* SelectedItemImage;
 	
+	// Shown in the selected item image while the icon streams in
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI|Inventory")
+	FSlateBrush PlaceholderIconBrush;
+	
+	// The selected item image's brush as designed, before any icon or placeholder replaced it
+	FSlateBrush SelectedItemImageBrush;
+	
 	// The use item button
 	UPROPERTY(meta = (BindWidget))
 	class UButton* UseButton;
@@ -94,9 +108,22 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "UI|Inventory")
 	TSubclassOf<UInventoryItemWidget> InventoryItemWidgetClass;
 	
+	// Item widgets owned by this inventory, one per slot
+	UPROPERTY()
+	TArray<UInventoryItemWidget*> ItemWidgetPool;
+	
 	// The currently selected inventory item
 	FInventoryItem SelectedItem;
 	
+	// Slot of the selected item, INDEX_NONE when nothing is selected
+	int32 SelectedSlot;
+	
+	// Create item widgets until there is one for each of Count slots
+	void EnsureItemPoolSize(int32 Count);
+	
+	// Show a slot's current contents in its item widget
+	void RefreshSlot(int32 SlotIndex);
+	
 	// Called when the Use button is clicked
 	UFUNCTION()
 	void OnUseButtonClicked();
@@ -108,9 +135,12 @@ protected:
 	// Called when the widget is constructed
 	virtual void NativeConstruct() override;
 	
-	// Called when the inventory changes
+	// Called once when the widget is created
+	virtual void NativeOnInitialized() override;
+	
+	// Called with the slots each inventory transaction changed
 	UFUNCTION()
-	void OnInventoryChanged();
+	void OnInventoryChangeSet(const FInventoryChangeSet& ChangeSet);
 	
 	// Update the selected item panel
 	void UpdateSelectedItemPanel();